@@ -0,0 +1,79 @@
+#include "Bench.h"
+#include "src/Utils/AabbTree.h"
+#include "src/Utils/Stopwatch.h"
+
+/**
+ * @brief Insertion, update and query times of the scene tree from 1k to 1M boxes.
+ *
+ * Boxes of 0.05 to 1 units fill the scene bounds of the application at the same density for every count.
+ * The update moves every box by up to a tenth of a unit, like a frame of animation. The results are checked
+ * against brute force by the AabbTree tests.
+ */
+BENCHMARK(AabbTree)
+{
+    constexpr uint32_t Counts[] = {1000, 10000, 100000, 1000000};
+    constexpr uint32_t Queries = 1000;
+    constexpr glm::vec3 MinBounds(-15.0f, 0.1f, -15.0f), MaxBounds(15.0f, 15.0f, 15.0f);
+    constexpr float BoxSize = 2.0f, SphereRadius = 2.0f, RayLength = 50.0f;
+
+    const glm::mat4 projection = glm::perspective(glm::radians(35.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    for (const uint32_t count : Counts)
+    {
+        // Scene bounds grown with the count, so every count has the same density
+        const glm::vec3 extent = (MaxBounds - MinBounds) * std::cbrt(count / 1000.0f);
+        std::vector<Bounds> bounds(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const glm::vec3 center = MinBounds + extent * glm::vec3(Random(3 * i), Random(3 * i + 1), Random(3 * i + 2));
+            bounds[i].min = center - (0.025f + 0.475f * Random(i ^ 0x5bd1e995u));
+            bounds[i].max = center + (center - bounds[i].min);
+        }
+
+        AabbTree tree;
+        std::vector<int32_t> proxies(count);
+        Stopwatch stopwatch;
+        for (uint32_t i = 0; i < count; i++)
+            proxies[i] = tree.Insert(bounds[i], i);
+        const double insertMs = stopwatch.ElapsedMs();
+
+        uint32_t reinserted = 0;
+        stopwatch.Restart();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const glm::vec3 offset = (glm::vec3(Random(7 * i), Random(7 * i + 1), Random(7 * i + 2)) - 0.5f) * 0.2f;
+            bounds[i].min += offset;
+            bounds[i].max += offset;
+            reinserted += tree.Move(proxies[i], bounds[i]);
+        }
+        const double moveMs = stopwatch.ElapsedMs();
+
+        // Query volumes around random points of the scene
+        auto point = [&](uint32_t q) { return MinBounds + extent * glm::vec3(Random(11 * q), Random(11 * q + 1), Random(11 * q + 2)); };
+        auto direction = [&](uint32_t q) { return glm::normalize(glm::vec3(Random(13 * q), Random(13 * q + 1), Random(13 * q + 2)) - 0.49f); };
+
+        size_t results = 0;
+        auto visit = [&results](uint32_t) { results++; };
+        double queryUs[4] = {};
+        for (int kind = 0; kind < 4; kind++)
+        {
+            const uint32_t queries = kind == 3 ? Queries / 10 : Queries; // frustums see far more boxes
+            stopwatch.Restart();
+            for (uint32_t q = 0; q < queries; q++)
+            {
+                if (kind == 0)
+                    tree.QueryBox(point(q) - BoxSize, point(q) + BoxSize, visit);
+                else if (kind == 1)
+                    tree.QuerySphere(point(q), SphereRadius, visit);
+                else if (kind == 2)
+                    tree.QueryRay(point(q), direction(q), RayLength, [&visit](uint32_t item, float) { visit(item); return RayLength; });
+                else
+                    tree.QueryFrustum(Frustum(projection * glm::lookAt(point(q), point(q) + direction(q), glm::vec3(0.0f, 1.0f, 0.0f))), visit);
+            }
+            queryUs[kind] = stopwatch.ElapsedMs() * 1000.0 / queries;
+        }
+
+        LOG("Scene tree, {} boxes: insert {:.2f} ms, move {:.2f} ms ({} reinserted), height {}; per query box {:.2f} us, "
+            "sphere {:.2f} us, ray {:.2f} us, frustum {:.2f} us; {} results.",
+            count, insertMs, moveMs, reinserted, tree.Height(), queryUs[0], queryUs[1], queryUs[2], queryUs[3], results);
+    }
+}
@@ -0,0 +1,55 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       Bench.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Minimal registry of the CPU benchmarks.
+ *
+ *  This file declares the BENCHMARK macro, which registers a benchmark
+ *  function that logs its own timings. The benchmarks cover the CPU side
+ *  modules on generated data and run without a window or GL context, so
+ *  they stay out of the application start; main.cpp runs the benchmark
+ *  named on the command line, all of them without one. Random generates
+ *  reproducible benchmark data.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+
+/**
+ * @struct Benchmark
+ * @brief Benchmark function registered by BENCHMARK.
+ */
+struct Benchmark
+{
+    const char *name;
+    void      (*run)();
+};
+
+/// Every benchmark registered so far, in registration order.
+std::vector<Benchmark> &Benchmarks();
+
+struct BenchmarkRegistration
+{
+    BenchmarkRegistration(const char *name, void (*run)())
+    {
+        Benchmarks().push_back({name, run});
+    }
+};
+
+#define BENCHMARK(name)                                                                                                \
+    static void Bench_##name();                                                                                        \
+    static const BenchmarkRegistration Bench_##name##_registration(#name, Bench_##name);                              \
+    static void Bench_##name()
+
+/// Uniform in [0, 1), a well mixed hash of the seed so consecutive seeds are independent.
+inline float Random(uint32_t seed)
+{
+    seed ^= seed >> 16;
+    seed *= 0x7feb352du;
+    seed ^= seed >> 15;
+    seed *= 0x846ca68bu;
+    seed ^= seed >> 16;
+    return (seed >> 8) / float(1 << 24);
+}
@@ -0,0 +1,55 @@
+#include "Bench.h"
+#include "src/Renderer/FrustumCuller.h"
+#include "src/Resources/Mesh/MeshSimplifier.h"
+#include "src/Utils/Stopwatch.h"
+
+/// Camera and culling threshold of the application at its default resolution.
+static constexpr float WindowWidth = 1920.0f;
+static constexpr float WindowHeight = 1080.0f;
+static constexpr float WindowFOV = 35.0f;
+static constexpr float WindowZNear = 0.1f;
+static constexpr float WindowZFar = 100.0f;
+static constexpr float CullMinPixels = 1.0f;
+
+/**
+ * @brief Time of the culling kernels over 100k bounds, each checked against the scalar one.
+ */
+BENCHMARK(FrustumCuller)
+{
+    // Boxes of 0.05 to 1 units scattered over 200 units around a camera looking into them
+    constexpr uint32_t Count = 100000;
+    constexpr int Repeats = 20;
+    FrustumCuller culler;
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        const uint32_t hash = i * 2654435761u;
+        const glm::vec3 center = glm::vec3(hash % 1000, (hash >> 10) % 1000, (hash >> 20) % 1000) * 0.2f - 100.0f;
+        const float size = 0.05f + (hash >> 28) / 16.0f;
+        const float corners[] = {center.x - size, center.y - size, center.z - size, center.x + size, center.y + size, center.z + size};
+        culler.Add(Bounds::FromPositions(corners, 2));
+    }
+
+    const glm::mat4 projection = glm::perspective(glm::radians(WindowFOV), WindowWidth / WindowHeight, WindowZNear, WindowZFar);
+    const Frustum frustum(projection * glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, -0.2f, 0.5f), glm::vec3(0.0f, 1.0f, 0.0f)));
+    const float pixelScale = MeshSimplifier::PixelScale(projection, WindowHeight);
+
+    std::vector<uint8_t> reference;
+    for (const FrustumCuller::Kernel kernel : {FrustumCuller::Kernel::Scalar, FrustumCuller::Best})
+    {
+        Stopwatch stopwatch;
+        for (int repeat = 0; repeat < Repeats; repeat++)
+            culler.Cull(frustum, pixelScale, CullMinPixels, kernel);
+        const double ms = stopwatch.ElapsedMs() / Repeats;
+
+        std::vector<uint8_t> visible(Count);
+        for (uint32_t i = 0; i < Count; i++)
+            visible[i] = culler.Visible(i);
+        if (reference.empty())
+            reference = visible;
+
+        const CullStats &stats = culler.Stats();
+        LOG("Frustum culling, {} bounds, {} kernel: {:.3f} ms, {} visible, {} outside, {} below {} px{}.", Count,
+            FrustumCuller::Name(kernel), ms, stats.visible, stats.outside, stats.belowPixels, CullMinPixels,
+            visible == reference ? "" : " (MISMATCH)");
+    }
+}
@@ -0,0 +1,87 @@
+#include "Bench.h"
+#include "src/Renderer/RenderQueue.h"
+#include "src/Utils/Stopwatch.h"
+
+/**
+ * @brief How fast render queues of generated scenes are built and sorted, and the state changes sorting saves.
+ *
+ * Objects are spread over a grid in front of the camera with hashed programs, materials and meshes, a fifth
+ * of them transparent. The parallel queue is compared with a single threaded one and with std::stable_sort.
+ */
+BENCHMARK(RenderQueue)
+{
+    constexpr uint32_t Counts[] = {10000, 100000};
+    const glm::mat4 view = glm::lookAt(glm::vec3(50.0f, 20.0f, -20.0f), glm::vec3(50.0f, 0.0f, 50.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    struct Item
+    {
+        RenderQueue::Pass pass;
+        uint32_t program, material, mesh;
+        glm::vec3 position;
+    };
+    auto emit = [&view](const std::vector<Item> &items)
+    {
+        return [&items, &view](size_t begin, size_t end, std::vector<RenderQueueEntry> &bucket)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                const Item &item = items[i];
+                const float depth = -(view * glm::vec4(item.position, 1.0f)).z;
+                bucket.push_back({RenderQueue::Key(item.pass, item.program, item.material, item.mesh, depth), static_cast<uint32_t>(i)});
+            }
+        };
+    };
+    // program, material or mesh switches between consecutive draws
+    auto stateChanges = [](const std::vector<Item> &items, const std::vector<RenderQueueEntry> &order)
+    {
+        size_t changes = 0;
+        for (size_t i = 1; i < order.size(); i++)
+        {
+            const Item &a = items[order[i - 1].item], &b = items[order[i].item];
+            changes += (a.program != b.program) + (a.material != b.material) + (a.mesh != b.mesh);
+        }
+        return changes;
+    };
+
+    RenderQueue renderQueue, serialQueue(1);
+    for (const uint32_t count : Counts)
+    {
+        std::vector<Item> items(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const uint32_t hash = i * 2654435761u;
+            items[i].pass     = hash % 5 == 0 ? RenderQueue::Pass::Transparent : RenderQueue::Pass::Opaque;
+            items[i].program  = hash >> 28;
+            items[i].material = (hash >> 20) % 64;
+            items[i].mesh     = (hash >> 12) % 32;
+            items[i].position = glm::vec3(i % 100, (i / 100) % 10, i / 1000);
+        }
+
+        Stopwatch stopwatch;
+        renderQueue.Build(count, emit(items));
+        const double buildMs = stopwatch.ElapsedMs();
+        stopwatch.Restart();
+        renderQueue.Sort();
+        const double sortMs = stopwatch.ElapsedMs();
+
+        stopwatch.Restart();
+        serialQueue.Build(count, emit(items));
+        serialQueue.Sort();
+        const double serialMs = stopwatch.ElapsedMs();
+
+        // Entries in item order, as the scene was drawn before
+        serialQueue.Build(count, emit(items));
+        std::vector<RenderQueueEntry> reference = serialQueue.Entries();
+        const size_t unsortedChanges = stateChanges(items, reference);
+        stopwatch.Restart();
+        std::stable_sort(reference.begin(), reference.end(), [](const RenderQueueEntry &a, const RenderQueueEntry &b) { return a.key < b.key; });
+        const double stdSortMs = stopwatch.ElapsedMs();
+
+        const bool identical = std::equal(reference.begin(), reference.end(), renderQueue.Entries().begin(), renderQueue.Entries().end(),
+                                          [](const RenderQueueEntry &a, const RenderQueueEntry &b) { return a.key == b.key && a.item == b.item; });
+        LOG("Render queue, {} objects: build {:.3f} ms + radix sort {:.3f} ms, single thread {:.3f} ms, std::stable_sort {:.3f} ms{}; "
+            "state changes {} unsorted, {} sorted.",
+            count, buildMs, sortMs, serialMs, stdSortMs, identical ? "" : " (ORDER MISMATCH)", unsortedChanges,
+            stateChanges(items, renderQueue.Entries()));
+    }
+}
@@ -0,0 +1,33 @@
+#include "Bench.h"
+#include "src/Utils/Stopwatch.h"
+
+std::vector<Benchmark> &Benchmarks()
+{
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+/// Run the benchmark given as first argument, all of them without one.
+int main(int argc, char *argv[])
+{
+    const std::string name = argc > 1 ? argv[1] : "";
+
+    int ran = 0;
+    for (const Benchmark &benchmark : Benchmarks())
+    {
+        if (!name.empty() && name != benchmark.name)
+            continue;
+
+        Stopwatch stopwatch;
+        benchmark.run();
+        LOG("{} done in {:.1f} ms.", benchmark.name, stopwatch.ElapsedMs());
+        ran++;
+    }
+
+    if (ran == 0)
+    {
+        LOG_ERROR("No benchmark '{}'.", name);
+        return 1;
+    }
+    return 0;
+}
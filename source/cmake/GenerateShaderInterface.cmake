@@ -0,0 +1,140 @@
+# Generates ShaderInterface.h, constexpr locations of every attribute and uniform declared with
+# layout(location = N) in the shader stages, so C++ code names them at compile time.
+#
+# Usage: cmake -DSHADER_DIR=<res/Shaders> -DOUTPUT=<ShaderInterface.h> -P GenerateShaderInterface.cmake
+#
+# The stages of a program are <Program>_V.glsl and <Program>_F.glsl and become ShaderInterface::<Program>.
+# A struct uniform becomes a nested struct with one location per member, in declaration order like GLSL
+# assigns them. A name declared by both stages at different locations, or two names overlapping at one
+# location, stops the build.
+
+cmake_minimum_required(VERSION 3.23)
+
+if(NOT SHADER_DIR OR NOT OUTPUT)
+    message(FATAL_ERROR "SHADER_DIR and OUTPUT have to be defined.")
+endif()
+
+set(WS "[ \t\r\n]")
+set(ID "[A-Za-z0-9_]+")
+
+file(GLOB STAGES "${SHADER_DIR}/*_V.glsl" "${SHADER_DIR}/*_F.glsl")
+list(SORT STAGES)
+
+set(PROGRAMS "")
+foreach(STAGE IN LISTS STAGES)
+    get_filename_component(STAGE_NAME "${STAGE}" NAME_WE)
+    string(REGEX REPLACE "_[VF]$" "" PROGRAM "${STAGE_NAME}")
+    list(APPEND PROGRAMS "${PROGRAM}")
+
+    # Without comments, and ';' and '[ ]' replaced, as they would split the CMake lists below
+    file(READ "${STAGE}" SOURCE)
+    string(REGEX REPLACE "//[^\n]*" "" SOURCE "${SOURCE}")
+    string(REPLACE ";" "," SOURCE "${SOURCE}")
+    string(REPLACE "[" "<" SOURCE "${SOURCE}")
+    string(REPLACE "]" ">" SOURCE "${SOURCE}")
+
+    # Struct members
+    string(REGEX MATCHALL "struct${WS}+${ID}${WS}*{[^}]*}" STRUCTS "${SOURCE}")
+    foreach(STRUCT IN LISTS STRUCTS)
+        string(REGEX REPLACE "^struct${WS}+(${ID}).*$" "\\1" STRUCT_NAME "${STRUCT}")
+        string(REGEX MATCHALL "${ID}${WS}+${ID}${WS}*," MEMBERS "${STRUCT}")
+        set(STRUCT_${STRUCT_NAME} "")
+        foreach(MEMBER IN LISTS MEMBERS)
+            string(REGEX REPLACE "^${ID}${WS}+(${ID}).*$" "\\1" MEMBER_NAME "${MEMBER}")
+            list(APPEND STRUCT_${STRUCT_NAME} "${MEMBER_NAME}")
+        endforeach()
+    endforeach()
+
+    # Declarations with an explicit location
+    set(DECLARATION "layout${WS}*\\(${WS}*location${WS}*=${WS}*([0-9]+)${WS}*\\)${WS}*(uniform|in)${WS}+(${ID})${WS}+(${ID})${WS}*(<[0-9]+>)?")
+    string(REGEX MATCHALL "${DECLARATION}" DECLARATIONS "${SOURCE}")
+    foreach(DECL IN LISTS DECLARATIONS)
+        string(REGEX REPLACE "^${DECLARATION}$" "\\1" LOCATION "${DECL}")
+        string(REGEX REPLACE "^${DECLARATION}$" "\\2" QUALIFIER "${DECL}")
+        string(REGEX REPLACE "^${DECLARATION}$" "\\3" TYPE "${DECL}")
+        string(REGEX REPLACE "^${DECLARATION}$" "\\4" NAME "${DECL}")
+        string(REGEX MATCH "<[0-9]+>$" ARRAY "${DECL}")
+
+        if(QUALIFIER STREQUAL "in")
+            # inputs of later stages are varyings, not attributes
+            if(NOT STAGE_NAME MATCHES "_V$")
+                continue()
+            endif()
+            set(KIND ATTRIBUTE)
+        else()
+            set(KIND UNIFORM)
+        endif()
+
+        # Locations taken by the declaration
+        set(SIZE 1)
+        if(DEFINED STRUCT_${TYPE})
+            list(LENGTH STRUCT_${TYPE} SIZE)
+            set(${PROGRAM}_${KIND}_${NAME}_MEMBERS "${STRUCT_${TYPE}}")
+        elseif(ARRAY)
+            string(REGEX REPLACE "[<>]" "" SIZE "${ARRAY}")
+        endif()
+
+        # Both stages have to agree on shared names
+        if(DEFINED ${PROGRAM}_${KIND}_${NAME})
+            if(NOT ${PROGRAM}_${KIND}_${NAME} EQUAL LOCATION)
+                message(FATAL_ERROR "${STAGE_NAME}.glsl: '${NAME}' is at location ${LOCATION}, another stage of ${PROGRAM} has it at ${${PROGRAM}_${KIND}_${NAME}}.")
+            endif()
+            continue()
+        endif()
+
+        math(EXPR LAST "${LOCATION} + ${SIZE} - 1")
+        foreach(SLOT RANGE ${LOCATION} ${LAST})
+            if(DEFINED ${PROGRAM}_${KIND}_SLOT_${SLOT})
+                message(FATAL_ERROR "${STAGE_NAME}.glsl: '${NAME}' overlaps '${${PROGRAM}_${KIND}_SLOT_${SLOT}}' at location ${SLOT}.")
+            endif()
+            set(${PROGRAM}_${KIND}_SLOT_${SLOT} "${NAME}")
+        endforeach()
+
+        set(${PROGRAM}_${KIND}_${NAME} ${LOCATION})
+        list(APPEND ${PROGRAM}_${KIND}S "${NAME}")
+    endforeach()
+endforeach()
+list(REMOVE_DUPLICATES PROGRAMS)
+
+# Header
+set(HEADER "// Generated by cmake/GenerateShaderInterface.cmake from res/Shaders, do not edit.\n")
+string(APPEND HEADER "// Locations of the layout(location = N) declarations, see Shader::Load().\n\n")
+string(APPEND HEADER "#pragma once\n\nnamespace ShaderInterface\n{\n")
+
+foreach(PROGRAM IN LISTS PROGRAMS)
+    string(APPEND HEADER "    /// ${PROGRAM}_V.glsl, ${PROGRAM}_F.glsl\n")
+    string(APPEND HEADER "    struct ${PROGRAM}\n    {\n")
+
+    foreach(KIND ATTRIBUTE UNIFORM)
+        if(NOT ${PROGRAM}_${KIND}S)
+            continue()
+        endif()
+        if(KIND STREQUAL "ATTRIBUTE")
+            string(APPEND HEADER "        // Attributes\n")
+        else()
+            string(APPEND HEADER "        // Uniforms\n")
+        endif()
+
+        foreach(NAME IN LISTS ${PROGRAM}_${KIND}S)
+            set(LOCATION ${${PROGRAM}_${KIND}_${NAME}})
+            if(DEFINED ${PROGRAM}_${KIND}_${NAME}_MEMBERS)
+                string(APPEND HEADER "        struct ${NAME}\n        {\n")
+                foreach(MEMBER IN LISTS ${PROGRAM}_${KIND}_${NAME}_MEMBERS)
+                    string(APPEND HEADER "            static constexpr int ${MEMBER} = ${LOCATION};\n")
+                    math(EXPR LOCATION "${LOCATION} + 1")
+                endforeach()
+                string(APPEND HEADER "        };\n")
+            else()
+                string(APPEND HEADER "        static constexpr int ${NAME} = ${LOCATION};\n")
+            endif()
+        endforeach()
+    endforeach()
+
+    string(APPEND HEADER "    };\n")
+endforeach()
+string(APPEND HEADER "}\n")
+
+# Keep the timestamp when nothing changed, so dependent sources are not rebuilt
+file(WRITE "${OUTPUT}.tmp" "${HEADER}")
+file(COPY_FILE "${OUTPUT}.tmp" "${OUTPUT}" ONLY_IF_DIFFERENT)
+file(REMOVE "${OUTPUT}.tmp")
@@ -4,6 +4,8 @@ unsigned int Box::VAO           = 0;
 unsigned int Box::VBO           = 0;
 unsigned int Box::textureDiffID = 0;
 unsigned int Box::textureSpecID = 0;
+Bounds       Box::bounds;
+TriangleBvh  Box::triangles;
 
 const float Box::vertices[288] = {
     // positions          // normals           // texture coords
@@ -18,6 +18,8 @@
 #define BOX_H
 
 #include "src/Resources/Texture/Texture.h"
+#include "src/Utils/Bounds.h"
+#include "src/Resources/Mesh/TriangleBvh.h"
 
 enum class TypeBox
 {
@@ -38,6 +40,8 @@ public:
     static unsigned int VAO, VBO;
     static unsigned int textureDiffID, textureSpecID;
     static constexpr bool useTexture = true;
+    static Bounds bounds; ///< of the vertices, shared by all boxes
+    static TriangleBvh triangles; ///< of the vertices for picking, shared by all boxes
 
     Box() = default;
     Box(TypeBox type) : _type(type) {};
@@ -50,6 +54,10 @@ public:
      Texture::LoadTextures(textureDiffID, "res/Models/Box/Diffuse.png");
      Texture::LoadTextures(textureSpecID, "res/Models/Box/Specular.png");
 
+     // bounds of the positions, every vertex is 8 floats
+     bounds = Bounds::FromPositions(vertices, vertexCount, 8);
+     triangles.Build(vertices, vertexCount, 8);
+
      // create VAO and VBO
      glGenVertexArrays(1, &VAO);
      glGenBuffers(1, &VBO);
@@ -1,9 +1,12 @@
 #include "Cat.h"
 
 unsigned int Cat::VAO         = 0;
-unsigned int Cat::VBOPos      = 0;
-unsigned int Cat::VBONorm     = 0;
+unsigned int Cat::VBO         = 0;
+unsigned int Cat::EBO         = 0;
 
-unsigned int Cat::vertexCount = 0;
+unsigned int Cat::indexCount  = 0;
+LodChain     Cat::lods;
+Bounds       Cat::bounds;
+TriangleBvh  Cat::triangles;
 
 bool Cat::isMoving = false;
\ No newline at end of file
@@ -6,9 +6,11 @@
  * \brief      Loading and rendering of a 3D cat mesh.
  *
  *  This file defines the Cat class which loads a 3D cat model from a glTF file into
- *  OpenGL buffers. It sets up vertex array and buffer objects for positions and normals,
- *  configures vertex attribute pointers based on the provided Shader, and manages the
- *  vertex count for rendering the cat mesh. The class supports toggling texture usage.
+ *  OpenGL buffers. The mesh is welded into indexed geometry and uploaded as one
+ *  interleaved vertex buffer plus an index buffer, with vertex attribute pointers
+ *  based on the provided Shader, and drawn with glDrawElements. Simplified levels
+ *  of detail are stored after the full indices in the same index buffer. The
+ *  class supports toggling texture usage.
  *
  */
 //----------------------------------------------------------------------------------------
@@ -17,54 +19,93 @@
 #ifndef CAT_H
 #define CAT_H
 
+#include "src/Resources/Mesh/Mesh.h"
 #include "src/Resources/Mesh/MeshLoader.h"
 #include "src/Resources/Shader/Shader.h"
 
 class Cat
 {
 public:
-    static unsigned int VAO, VBOPos, VBONorm;
+    static unsigned int VAO, VBO, EBO;
     static bool isMoving;
     static constexpr bool useTexture = false;
 
     Cat() = default;
 
-    static unsigned int vertexCount;
+    static unsigned int indexCount;
+    static LodChain lods;
+    static Bounds bounds;
+    static TriangleBvh triangles; ///< full mesh for picking
 
     static void LoadCat(const Shader &shader)
     {
-        MeshSource catMesh = MeshLoader::LoadMesh("Models/Cat/cat.glb", false);
+        MeshSource catMesh = MeshLoader::LoadMesh("Models/Cat/cat.glb", MeshLoader::Indexing::Welded);
 
-        vertexCount = catMesh.VertexCount();
+        // Interleave position | normal | uv, a cached mesh already is one stream in the mapped file
+        std::vector<float> vertices;
+        InterleavedView layout;
+        if (catMesh.HasInterleaved())
+            layout = catMesh.Interleaved();
+        else
+        {
+            catMesh.Interleave(vertices, layout);
+            layout.vertices = vertices.data();
+            layout.indices = catMesh.Indices();
+        }
+
+        indexCount = layout.indexCount;
+        bounds = Bounds::FromPositions(layout.vertices, layout.vertexCount, layout.Stride());
+        triangles.Build(catMesh.Views());
+        const GLsizei stride = layout.Stride() * sizeof(float);
 
         // Create VAO
         glGenVertexArrays(1, &VAO);
         glBindVertexArray(VAO);
 
-        // Create VBO for positions
-        glGenBuffers(1, &VBOPos);
-        glBindBuffer(GL_ARRAY_BUFFER, VBOPos);
-        glBufferData(GL_ARRAY_BUFFER, vertexCount * 3 * sizeof(float), catMesh.Positions(), GL_STATIC_DRAW);
-        glVertexAttribPointer(shader._utils.aPosition, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
+        // Create VBO
+        glGenBuffers(1, &VBO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<size_t>(layout.vertexCount) * stride, layout.vertices, GL_STATIC_DRAW);
+
+        // Positions
+        glVertexAttribPointer(shader._utils.aPosition, 3, GL_FLOAT, GL_FALSE, stride, (void *)0);
         glEnableVertexAttribArray(shader._utils.aPosition);
 
-        // Create VBO for normals
-        if (catMesh.Normals() && shader._utils.aNormal != -1)
+        // Normals
+        if (layout.hasNormals && shader._utils.aNormal != -1)
         {
-            glGenBuffers(1, &VBONorm);
-            glBindBuffer(GL_ARRAY_BUFFER, VBONorm);
-            glBufferData(GL_ARRAY_BUFFER, vertexCount * 3 * sizeof(float), catMesh.Normals(), GL_STATIC_DRAW);
-            glVertexAttribPointer(shader._utils.aNormal, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
+            glVertexAttribPointer(shader._utils.aNormal, 3, GL_FLOAT, GL_FALSE, stride, (void *)(3 * sizeof(float)));
             glEnableVertexAttribArray(shader._utils.aNormal);
         }
 
-        //   layout(location = 3) vec2 aTexCoords; (fake)
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 0, (void *)0);
+        // Texture coordinates
+        if (layout.hasUVs && shader._utils.aTexCoords != -1)
+        {
+            const size_t offset = (layout.hasNormals ? 6 : 3) * sizeof(float);
+            glVertexAttribPointer(shader._utils.aTexCoords, 2, GL_FLOAT, GL_FALSE, stride, (void *)offset);
+            glEnableVertexAttribArray(shader._utils.aTexCoords);
+        }
+        else
+        {
+            //   layout(location = 3) vec2 aTexCoords; (fake)
+            glEnableVertexAttribArray(3);
+            glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 0, (void *)0);
+        }
+
+        // Create EBO: full mesh followed by its levels of detail
+        std::vector<unsigned int> lodIndices;
+#ifdef IMPL_MESH_LOD
+        lods = MeshSimplifier::BuildLodChain(catMesh.Views(), lodIndices);
+#endif
+        glGenBuffers(1, &EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (indexCount + lodIndices.size()) * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexCount * sizeof(unsigned int), layout.indices);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), lodIndices.size() * sizeof(unsigned int), lodIndices.data());
 
         // Disconnect VAO
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 };
 
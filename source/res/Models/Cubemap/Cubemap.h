@@ -0,0 +1 @@
+CubeMap.h
\ No newline at end of file
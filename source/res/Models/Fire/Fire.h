@@ -7,8 +7,8 @@
  *
  *  This file defines the Fire class, which loads a fire texture atlas and sets up a
  *  quad geometry with VBO, VAO, and EBO. It handles frame-based animation by computing
- *  the current frame based on elapsed time and passes it to the shader. The class
- *  configures blending for transparent fire rendering.
+ *  the current frame based on elapsed time and passes it to the shader. Transparency
+ *  relies on the blending of the scene pipeline state.
  *
  */
 //----------------------------------------------------------------------------------------
@@ -19,6 +19,9 @@
 #include <GLFW/glfw3.h>
 #include <string>
 #include "src/Resources/Texture/Texture.h"
+#include "src/Renderer/GLState.h"
+#include "src/Utils/Bounds.h"
+#include "src/Resources/Mesh/TriangleBvh.h"
 
 class Fire {
 public:
@@ -31,6 +34,8 @@ public:
     float frameDuration = 0.0f;
     unsigned int textureID = 0;
     unsigned int VAO = 0, VBO = 0, EBO = 0;
+    Bounds bounds; ///< of the sprite quad
+    TriangleBvh triangles; ///< of the sprite quad for picking, transparent texels included
 
     const int vertexCount = 6;
 
@@ -51,6 +56,8 @@ public:
     // Load texture and set VAO/VBO/EBO
     void LoadFire() {
         Texture::LoadTextures(textureID, "res/Models/Fire/Fire.png");
+        bounds = Bounds::FromPositions(vertices, 4, 5);
+        triangles.Build(vertices, 4, 5, indices, indexCount);
 
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
@@ -82,12 +89,10 @@ public:
         glBindVertexArray(0);
     }
 
-    void Render(const Shader& shader) const {
+    // Draw the sprite, objectIndex selects its ObjectData as base instance
+    void Render(const Shader& shader, const uint32_t objectIndex) const {
         Shader::Bind(shader);
 
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
         int frame = int(float(glfwGetTime()) / frameDuration);
         frame %= cols * rows;
 
@@ -96,13 +101,11 @@ public:
         Shader::SetInt(shader._utils.frame, frame);
 
         // Set texture
-        glActiveTexture(GL_TEXTURE3);
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        GLState::BindTexture(3, textureID);
 
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+        GLState::BindVertexArray(VAO);
+        glDrawElementsInstancedBaseInstance(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr, 1, objectIndex);
 
         Shader::SetInt(shader._utils.useFire, false);
-        glBindVertexArray(0);
     }
 };
@@ -17,6 +17,8 @@
 #ifndef ICOSPHERE_H
 #define ICOSPHERE_H
 #include "src/Resources/Texture/Texture.h"
+#include "src/Utils/Bounds.h"
+#include "src/Resources/Mesh/TriangleBvh.h"
 
 class Icosphere
 {
@@ -27,11 +29,43 @@ public:
   unsigned int VAO = 0, VBO = 0;
   unsigned int textureDiffID = 0, textureSpecID = 0;
   const bool useTexture = true;
+  Bounds bounds; ///< of the vertices and of the sphere the vertex shader morphs them towards
 
   Icosphere() = default;
 
   const int vertexCount = 240;
 
+  /// Position as toSphere() in Shader_V.glsl morphs it, alpha is ObjectData::alphaToSphere
+  static glm::vec3 ToSphere(const glm::vec3 &position, const float alpha)
+  {
+    const glm::vec3 center(1.0f);
+    const float radius = 1.2f;
+
+    const glm::vec3 Q = glm::normalize(position - center) * radius + center;
+    return glm::mix(position, Q, alpha);
+  }
+
+  /**
+   * @brief Nearest hit of an object space ray with the triangles as the vertex shader morphs them this frame.
+   * @param[in,out] distance Hits at or beyond it are ignored, set to the nearest hit found.
+   * @return True if a triangle was hit before distance.
+   *
+   * The morph changes every frame, so the 80 triangles are tested one by one instead of through a TriangleBvh.
+   */
+  bool Raycast(const glm::vec3 &origin, const glm::vec3 &direction, float &distance, const TriangleBvh::Faces faces) const
+  {
+    const auto alpha = static_cast<float>(glm::sin(lastDynamicScale));
+    bool hit = false;
+    for (int i = 0; i < vertexCount; i += 3)
+    {
+      const glm::vec3 a = ToSphere(glm::make_vec3(&vertices[i * 8]), alpha);
+      const glm::vec3 b = ToSphere(glm::make_vec3(&vertices[(i + 1) * 8]), alpha);
+      const glm::vec3 c = ToSphere(glm::make_vec3(&vertices[(i + 2) * 8]), alpha);
+      hit |= TriangleBvh::IntersectTriangle(origin, direction, a, b, c, distance, faces);
+    }
+    return hit;
+  }
+
   void LoadSphere()
 {
   // set textures
@@ -40,6 +74,13 @@ public:
   Texture::LoadTextures(textureSpecID, "res/Models/Icosphere/Specular.png");
   stbi_set_flip_vertically_on_load(false);
 
+  // bounds of the positions, every vertex is 8 floats; toSphere() in Shader_V.glsl mixes them with a sphere
+  // of radius 1.2 around (1, 1, 1) by a factor in [-1, 1], so they stay within 2 * reach + 1.2 of its center
+  bounds = Bounds::FromPositions(vertices, vertexCount, 8);
+  const glm::vec3 morphCenter(1.0f);
+  const float reach = glm::length(bounds.center - morphCenter) + bounds.radius;
+  bounds.Extend(morphCenter, 2.0f * reach + 1.2f);
+
   // create VAO and VBO
   glGenVertexArrays(1, &VAO);
   glGenBuffers(1, &VBO);
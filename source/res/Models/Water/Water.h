@@ -20,12 +20,15 @@
 #include <GL/glew.h>
 #include "src/Resources/Shader/Shader.h"
 #include "src/Resources/Texture/Texture.h"
+#include "src/Renderer/GLState.h"
+#include "src/Utils/Bounds.h"
 
 class Water
 {
 public:
     unsigned int VAO = 0, VBO = 0, EBO = 0;
     unsigned int textureID = 0;
+    Bounds bounds; ///< of the plane
 
     static constexpr int indexCount = 6;
 
@@ -34,6 +37,7 @@ public:
     void LoadWater()
     {
         Texture::LoadTextures(textureID, "res/Models/Water/Water.png");
+        bounds = Bounds::FromPositions(vertices, 4, 5);
 
         // Generate buffers
         glGenVertexArrays(1, &VAO);
@@ -81,22 +85,15 @@ public:
         glBindVertexArray(0);
     }
 
-    void Render(const Shader &shader) const
+    // Draw the plane, objectIndex selects its ObjectData as base instance
+    void Render(const Shader &shader, const uint32_t objectIndex) const
     {
+        // Depth and stencil writes are off in the pipeline state RenderObject applies
         Shader::Bind(shader);
 
-        glDepthMask(GL_FALSE);
-        glStencilMask(0x00);
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
-
-        glDepthMask(GL_TRUE);
-        glStencilMask(0xFF);
-
-        glBindVertexArray(0);
+        GLState::BindTexture(0, textureID);
+        GLState::BindVertexArray(VAO);
+        glDrawElementsInstancedBaseInstance(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr, 1, objectIndex);
     }
 
 private:
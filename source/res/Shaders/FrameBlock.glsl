@@ -0,0 +1,18 @@
+// Per-frame constants shared by all programs, matches FrameConstants in FrameUniforms.h
+layout(std140, binding = 1) uniform FrameBlock {
+    mat4  ViewM;
+    mat4  ProjectionM;
+    mat4  ViewProjectionM;
+    mat4  SkyboxViewM;     // view without translation
+
+    vec3  viewPos;         // camera position
+    float Time;            // seconds since start
+
+    vec3  fogColor;
+    float fogStart;
+    float fogEnd;
+    int   useFog;
+
+    int   useFlashLight;   // light flags
+    int   useFireLight;
+};
@@ -0,0 +1,11 @@
+// Colors of the scene materials, matches MaterialData in MaterialBuffer.h; indexed by ObjectData.materialIndex, 0 is the default
+struct MaterialData {
+    vec3  diffuse;
+    float shininess;
+    vec3  specular;
+    float padding;
+};
+
+layout(std430, binding = 3) readonly buffer MaterialBlock {
+    MaterialData materials[];
+};
@@ -0,0 +1,21 @@
+// Per draw object data, matches ObjectData in ObjectBuffer.h; draws pass the index of their first object as base instance, instances follow it
+struct ObjectData {
+    mat4  ModelM;
+    mat3  NormalM;         // transpose(inverse(mat3(ModelM)))
+
+    uint  materialIndex;
+    int   useTexture;
+    int   useAlpha;
+    float alpha;
+    int   useToSphere;
+    float alphaToSphere;
+
+    // Compact vertices (Mesh::VertexFormat::Compact)
+    vec3  positionScale;
+    int   useQuantization;
+    vec3  positionOffset;
+};
+
+layout(std430, binding = 2) readonly buffer ObjectBlock {
+    ObjectData objects[];
+};
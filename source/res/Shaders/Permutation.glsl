@@ -0,0 +1,13 @@
+// Permutation switches, see ShaderVariants.h. A variant defines VARIANT and every VARIANT_* as 0 or 1,
+// so its conditions are constants and the other paths are compiled out; the uber-shader tests flags per draw.
+#ifdef VARIANT
+#define IS_SKYBOX   (VARIANT_SKYBOX == 1)
+#define IS_FIRE     (VARIANT_FIRE == 1)
+#define IS_TEXTURED (VARIANT_TEXTURED == 1)
+#define IS_FOGGED   (VARIANT_FOG == 1)
+#else
+#define IS_SKYBOX   (useCubeMap == 1)
+#define IS_FIRE     (useFire == 1)
+#define IS_TEXTURED (objects[ObjectIndex].useTexture == 1)
+#define IS_FOGGED   (useFog == 1)
+#endif
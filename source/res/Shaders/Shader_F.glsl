@@ -1,14 +1,17 @@
 #version 450 core
+#include "FrameBlock.glsl"
+#include "ObjectBlock.glsl"
+#include "MaterialBlock.glsl"
+#include "Permutation.glsl"
 
 const int Ambient = 0;
 const int Direct = 1;
 const int Point = 2;
 const int Spot = 3;
 
-const int MAX_LIGHT_COUNT = 8;
+const int MAX_LIGHT_COUNT = 8; // LightBuffer::MaxLights
 
 struct Material {
-    bool useTexture;       // true -> use texture, false -> use vec3
     sampler2D diffuseMap;  // diffuse   texture
     sampler2D specularMap; // specular  texture
 
@@ -18,25 +21,24 @@ struct Material {
     float shininess;       // shininess coefficient
 };
 
+// std140, matches LightData in Light.h; every vec3 shares its 16 bytes with the scalar after it
 struct Light {
+    vec3 position;
     int type;              // Ambient, Direct, Point, Spot
 
-    vec3 position;
     vec3 direction;
+    float constant;        // attenuation
 
     vec3 color;
+    float linear;
 
     vec3 ambient;          // ambient   strength
-    vec3 diffuse;          // diffuse   strength
-    vec3 specular;         // specular  strength
-
-    // Attenuation
-    float constant;
-    float linear;
     float quadratic;
 
-    // Cutoff
-    float cutOff;
+    vec3 diffuse;          // diffuse   strength
+    float cutOff;          // spot cutoff
+
+    vec3 specular;         // specular  strength
     float outerCutOff;
 };
 
@@ -44,50 +46,38 @@ struct Light {
 in vec3 FragPos;           // position of fragment in world
 in vec3 Normal;            // normal direction of fragment
 in vec3 TexCoords3;        // texture coordinates for fragment
+flat in uint ObjectIndex;  // element of objects[] drawn
 
-// Fragment Uniforms
-uniform vec3 viewPos;      // camera position
-
-uniform Material material;
-uniform Light lights[MAX_LIGHT_COUNT];
-uniform int lightCount;    // real number of light on the scene
-uniform samplerCube cubeMap;
-uniform int useCubeMap;    // flag if cubeMap is rendering
+// Fragment Uniforms, locations shared with Shader_V.glsl; a struct takes one per member
+layout(location = 1) uniform Material material;
+layout(std140, binding = 0) uniform LightBlock {
+    Light lights[MAX_LIGHT_COUNT];
+    int lightCount;        // real number of light on the scene
+};
+layout(location = 7) uniform samplerCube cubeMap;
+layout(location = 0) uniform int useCubeMap;    // flag if cubeMap is rendering
 
 // Fragment Output
 out vec4 FragColor;        // out color of fragment
 
 vec2 TexCoords2;
-
-// Fog
-uniform int   useFog;
-uniform vec3  fogColor;
-uniform float fogStart;
-uniform float fogEnd;
+MaterialData surface;       // colors of the drawn material, from materials[] or the material uniforms
 
 // Fire
-uniform int useFire;
-uniform sampler2D fireMap;
-uniform int frame;
-uniform ivec2 pattern = ivec2(14, 1);
-
-// Alpha
-uniform int useAlpha;
-uniform float alpha;
-
-// Light flags
-uniform int useFlashLight;
-uniform int useFireLight;
+layout(location = 8)  uniform int useFire;
+layout(location = 9)  uniform sampler2D fireMap;
+layout(location = 10) uniform int frame;
+layout(location = 11) uniform ivec2 pattern = ivec2(14, 1);
 
 vec3 sampleDiffuse() {
-    return material.useTexture
+    return IS_TEXTURED
     ? vec3(texture(material.diffuseMap, TexCoords2))
-    : material.diffuse;
+    : surface.diffuse;
 }
 vec3 sampleSpecular() {
-    return material.useTexture
+    return IS_TEXTURED
     ? vec3(texture(material.specularMap, TexCoords2))
-    : material.specular;
+    : surface.specular;
 }
 
 vec3 calcAmbient(Light light) {
@@ -101,7 +91,7 @@ vec3 calcDirect(Light light) {
 
     vec3 viewDir = normalize(viewPos - FragPos);
     vec3 reflectDir = reflect(-lightDir, normDir);
-    float spec  = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    float spec  = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
 
     vec3 ambient  = calcAmbient(light);
     vec3 diffuse  = light.diffuse  * diff * sampleDiffuse();
@@ -121,7 +111,7 @@ vec3 calcPoint(Light light) {
 
     vec3 V = normalize(viewPos - FragPos);
     vec3 R = reflect(-lightDir, normDir);
-    float spec  = pow(max(dot(V, R), 0.0), material.shininess);
+    float spec  = pow(max(dot(V, R), 0.0), surface.shininess);
 
     vec3 ambient  = calcAmbient(light);
     vec3 diffuse  = light.diffuse  * diff * sampleDiffuse();
@@ -149,7 +139,7 @@ vec3 calcSpot(Light light) {
 
     vec3 viewDir = normalize(viewPos - FragPos);
     vec3 reflectDir = reflect(-lightDir, normDir);
-    float spec  = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    float spec  = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
 
     vec3 ambient  = calcAmbient(light);
     vec3 diffuse  = light.diffuse  * diff * sampleDiffuse();
@@ -160,13 +150,19 @@ vec3 calcSpot(Light light) {
 
 void main() {
     TexCoords2 = TexCoords3.xy;
+    // The material uniforms remain for programs drawn without the material buffer
+    uint materialIndex = objects[ObjectIndex].materialIndex;
+    surface = materialIndex < uint(materials.length())
+    ? materials[materialIndex]
+    : MaterialData(material.diffuse, material.shininess, material.specular, 0.0);
+
     vec3 color = vec3(0.0);
     vec4 finalColor = vec4(0.0);
 
-    if (useCubeMap == 1)
+    if (IS_SKYBOX)
     {
         finalColor = texture(cubeMap, TexCoords3);
-    } else if (useFire == 1)
+    } else if (IS_FIRE)
     {
         vec2 frameUV = TexCoords2 / vec2(14.0, 1.0);
         if (useFireLight == 1)
@@ -208,14 +204,14 @@ void main() {
             }
         }
 
-        if (useAlpha == 1) {
-            finalColor = vec4(color, alpha);
+        if (objects[ObjectIndex].useAlpha == 1) {
+            finalColor = vec4(color, objects[ObjectIndex].alpha);
         } else {
             finalColor = vec4(color, 1.0);
         }
     }
 
-    if (useFog == 1) {
+    if (IS_FOGGED) {
         float distance = length(FragPos - viewPos);
         float fogFactor = clamp((fogEnd - distance) / (fogEnd - fogStart), 0.0, 1.0);
 
@@ -1,52 +1,74 @@
 #version 450 core
+#extension GL_ARB_shader_draw_parameters : require
+#include "FrameBlock.glsl"
+#include "ObjectBlock.glsl"
+#include "Permutation.glsl"
 
 // Vertex Attributes
 layout (location = 0) in vec3 aPosition;
 layout (location = 2) in vec3 aNormal;
 layout (location = 3) in vec2 aTexCoords;
 
-// Vertex Uniforms
-uniform mat4  ModelM;
-uniform mat4  ViewM;
-uniform mat4  ProjectionM;
-uniform int   useCubeMap;
-uniform int   useToSphere;
-uniform float alphaToSphere;
+// Vertex Uniforms, locations shared with Shader_F.glsl
+layout(location = 0) uniform int useCubeMap;
 
 // Vertex Outputs
 out vec3 FragPos;
 out vec3 Normal;
 out vec3 TexCoords3;
+flat out uint ObjectIndex;
 
-vec3 toSphere()
+vec3 toSphere(vec3 position, float alphaToSphere)
 {
     vec3 center = vec3(1.0);
     float radius = 1.2;
 
-    vec3 Q = normalize(aPosition - center) * radius + center;
+    vec3 Q = normalize(position - center) * radius + center;
 
-    return mix(aPosition, Q, alphaToSphere);
+    return mix(position, Q, alphaToSphere);
+}
+
+// Inverse of MeshQuantizer::OctEncode
+vec3 OctDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
 }
 
 void main()
 {
-    FragPos = vec3(ModelM * vec4(aPosition, 1.0));
+    ObjectIndex = uint(gl_BaseInstanceARB + gl_InstanceID);
+    mat4 ModelM = objects[ObjectIndex].ModelM;
+
+    // Decode compact vertices
+    vec3 position = aPosition;
+    vec3 normal = aNormal;
+    if (objects[ObjectIndex].useQuantization == 1)
+    {
+        position = objects[ObjectIndex].positionOffset + objects[ObjectIndex].positionScale * aPosition;
+        normal = OctDecode(aNormal.xy);
+    }
+
+    FragPos = vec3(ModelM * vec4(position, 1.0));
 
-    if (useCubeMap == 1) {
-        vec4 posCubeMap = ProjectionM * ViewM * vec4(aPosition, 1.0);
+    if (IS_SKYBOX) {
+        vec4 posCubeMap = ProjectionM * SkyboxViewM * vec4(position, 1.0);
         gl_Position = posCubeMap.xyww;
 
         Normal = vec3(0.0);
-        TexCoords3 = aPosition;
+        TexCoords3 = position;
     } else {
-        if (useToSphere == 1)
+        if (objects[ObjectIndex].useToSphere == 1)
         {
-            gl_Position = ProjectionM * ViewM * ModelM * vec4(toSphere(), 1.0);
+            gl_Position = ViewProjectionM * ModelM * vec4(toSphere(position, objects[ObjectIndex].alphaToSphere), 1.0);
         } else
         {
-            gl_Position = ProjectionM * ViewM * ModelM * vec4(aPosition, 1.0);
+            gl_Position = ViewProjectionM * ModelM * vec4(position, 1.0);
         }
-        Normal = mat3(transpose(inverse(ModelM))) * aNormal;
+        Normal = objects[ObjectIndex].NormalM * normal;
         // Set Texture coordinates
         TexCoords3 = vec3(aTexCoords, 0.0);
     }
@@ -1,20 +1,12 @@
 #version 450 core
+#include "FrameBlock.glsl"
 
 in vec3 FragPos;
 in vec2 TexCoords;
 
-uniform vec3 viewPos;
-
-uniform sampler2D WaterTexture;
-uniform float     Time;
-uniform vec2      ScrollSpeed;
-uniform float     Alpha;
-
-// Fog
-uniform bool  useFog;
-uniform vec3  fogColor;
-uniform float fogStart;
-uniform float fogEnd;
+layout(location = 0) uniform sampler2D WaterTexture;
+layout(location = 1) uniform vec2      ScrollSpeed;
+layout(location = 2) uniform float     Alpha;
 
 out vec4 FragColor;
 
@@ -29,7 +21,7 @@ void main() {
     color.a    = Alpha;
 
     // apply fog
-    if (useFog) {
+    if (useFog == 1) {
         float distance = length(FragPos - viewPos);
         float fogFactor = clamp((fogEnd - distance) / (fogEnd - fogStart), 0.0, 1.0);
 
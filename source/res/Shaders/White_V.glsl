@@ -1,9 +1,11 @@
 #version 450 core
+#extension GL_ARB_shader_draw_parameters : require
+#include "FrameBlock.glsl"
+#include "ObjectBlock.glsl"
 
 layout(location=0) in vec3 aPosition;
 
-uniform mat4 ModelM, ViewM, ProjectionM;
-
 void main(){
-    gl_Position = ProjectionM * ViewM * ModelM * vec4(aPosition,1);
+    mat4 ModelM = objects[gl_BaseInstanceARB + gl_InstanceID].ModelM;
+    gl_Position = ViewProjectionM * ModelM * vec4(aPosition,1);
 }
\ No newline at end of file
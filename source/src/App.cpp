@@ -9,6 +9,15 @@
 // Loaders
 #include "Resources/Mesh/MeshLoader.h"
 #include "Resources/Shader/ShaderLoader.h"
+#include "Resources/Shader/FrameUniforms.h"
+#include "Resources/Shader/ProgramCache.h"
+#include "Resources/Shader/ShaderReloader.h"
+#include "Renderer/FrustumCuller.h"
+#include "Renderer/GLState.h"
+#include "Renderer/RenderBenchmarks.h"
+#include "Renderer/RenderQueue.h"
+#include "Utils/AabbTree.h"
+#include "Utils/Stopwatch.h"
 // Models
 #include "res/Models/Box/Box.h"
 #include "res/Models/Icosphere/Icosphere.h"
@@ -48,11 +57,21 @@ std::vector<std::shared_ptr<MeshRenderer>> Renderers;
 std::vector<std::shared_ptr<RenderObject>> RenderObjects;
 
 // Shaders, materials, light
-Shader shader;
+Shader shader; // uber-shader, deciding the features per draw
+ShaderVariants shaderVariants("Shaders/Shader_V.glsl", "Shaders/Shader_F.glsl");
 Shader shaderWater;
 Shader shaderWhite;
+ShaderReloader shaderReloader;
 MaterialPGR material;
+MaterialBuffer materialBuffer;
 std::vector<LightObject> lightObjects;
+LightBuffer lightBuffer;
+FrameUniforms frameUniforms;
+ObjectBuffer objectBuffer;
+RenderQueue renderQueue;
+FrustumCuller sceneCuller;
+AabbTree sceneTree;
+std::vector<int32_t> sceneProxies; ///< tree proxy of every render object, AabbTree::Null for unbounded ones
 
 // Camera
 CameraObject cameraObject;
@@ -92,6 +111,242 @@ void LoadShaders()
     shaderSource = ShaderLoader::LoadShaderSeparate("Shaders/White_V.glsl", "Shaders/White_F.glsl");
     shaderWhite = Shader(shaderSource);
     shaderWhite.LoadWhite();
+
+    // Permutations compiled so far, the others are built when first drawn
+    shaderVariants.Reload();
+}
+#ifdef IMPL_SHADER_HOT_RELOAD
+/**
+ * @brief Register the shaders built by LoadShaders() for background rebuilds on R and on file changes.
+ */
+void WatchShaders()
+{
+    shaderReloader.Watch(shader, "main", "Shaders/Shader_V.glsl", "Shaders/Shader_F.glsl", [](Shader &program)
+    {
+        program.Load();
+        program.LinkTextures();
+    });
+    shaderReloader.Watch(shaderWater, "water", "Shaders/Water_V.glsl", "Shaders/Water_F.glsl", [](Shader &program)
+    {
+        program.LoadWater();
+        program.LinkTexturesWater();
+    });
+    shaderReloader.Watch(shaderWhite, "white", "Shaders/White_V.glsl", "Shaders/White_F.glsl", [](Shader &program)
+    {
+        program.LoadWhite();
+    });
+    shaderVariants.SetReloader(&shaderReloader);
+}
+#endif
+/**
+ * @brief Program an object is drawn with, its permutation of the main shader or the uber-shader.
+ */
+Shader &SceneShader(const RenderObject &obj)
+{
+#ifdef IMPL_SHADER_PERMUTATIONS
+    return shaderVariants.Get(obj.Features() | (App::useFog ? ShaderVariants::Fog : ShaderVariants::None));
+#else
+    return shader;
+#endif
+}
+/**
+ * @brief Whether the frustum culling of this frame rejected an object, see UpdateSceneObjects().
+ */
+bool IsCulled(const size_t item)
+{
+#ifdef IMPL_FRUSTUM_CULLING
+    return item < sceneCuller.Size() && !sceneCuller.Visible(static_cast<uint32_t>(item));
+#else
+    return false;
+#endif
+}
+#ifdef IMPL_RENDER_QUEUE
+/**
+ * @brief Program slot of an object's sort key, its permutation key. Touches no GL state, so render queue workers may call it.
+ */
+uint32_t ProgramSlot(const RenderObject &obj)
+{
+#ifdef IMPL_SHADER_PERMUTATIONS
+    return obj.Features() | (App::useFog ? ShaderVariants::Fog : ShaderVariants::None);
+#else
+    return 0;
+#endif
+}
+/**
+ * @brief Sort key of an object seen through a camera, see RenderQueue::Key().
+ */
+uint64_t SortKey(const RenderObject &obj, const glm::mat4 &view)
+{
+    const float depth = -(view * glm::vec4(obj.Position(), 1.0f)).z;
+#ifdef IMPL_MATERIAL_BUFFER
+    // Materials come from the material buffer, they do not split a multi-draw
+    const uint32_t material = 0;
+#else
+    const uint32_t material = obj.MaterialIndex();
+#endif
+    return RenderQueue::Key(obj.Pass(), ProgramSlot(obj), material, obj.VertexArray(), depth);
+}
+#endif
+#ifdef IMPL_FRUSTUM_CULLING
+/**
+ * @brief Log the objects frustum culling keeps from every preset camera.
+ */
+void LogFrustumCulling()
+{
+    FrustumCuller culler;
+    for (auto &object : RenderObjects)
+        culler.Add(object ? object->WorldBounds() : Bounds{});
+
+    auto &presets = cameraObject.GetTransforms();
+    for (size_t i = 0; i < presets.size(); i++)
+    {
+        Camera camera;
+        camera.LinkTransform(presets[i]);
+        camera.SetProjection(App::WindowWidth / App::WindowHeight, App::WindowFOV);
+        const float pixelScale = MeshSimplifier::PixelScale(camera.GetProjectionMatrix(), App::WindowHeight);
+        culler.Cull(Frustum(camera.GetProjectionMatrix() * camera.GetViewMatrix()), pixelScale, App::CullMinPixels);
+
+        const CullStats &stats = culler.Stats();
+        LOG("Frustum culling from camera {}: {} / {} objects visible, {} outside, {} below {} px.",
+            i, stats.visible, culler.Size(), stats.outside, stats.belowPixels, App::CullMinPixels);
+    }
+}
+#endif
+#ifdef IMPL_MESH_MESHLETS
+/**
+ * @brief Log how many scene triangles meshlet culling rejects from every preset camera.
+ */
+void LogMeshletCulling()
+{
+    DrawRanges ranges;
+    auto &presets = cameraObject.GetTransforms();
+    for (size_t i = 0; i < presets.size(); i++)
+    {
+        Camera camera;
+        camera.LinkTransform(presets[i]);
+        camera.SetProjection(App::WindowWidth / App::WindowHeight, App::WindowFOV);
+        const glm::mat4 viewProjection = camera.GetProjectionMatrix() * camera.GetViewMatrix();
+        const glm::vec3 eye = presets[i].GetWorldPosition();
+
+        MeshletCullStats stats;
+        Stopwatch stopwatch;
+        for (auto &object : RenderObjects)
+        {
+            if (object->GetType() != RenderObject::Type::Mesh)
+                continue;
+
+            const glm::mat4 model = object->GetTransform().GetMatrix();
+            object->GetMeshRenderer().GetMesh().CullMeshlets(Frustum(viewProjection * model), glm::vec3(glm::inverse(model) * glm::vec4(eye, 1.0f)),
+                                                             ranges, &stats);
+        }
+
+        LOG("Meshlet culling from camera {}: {} / {} triangles rejected ({:.1f}%), meshlets {} frustum + {} cone of {}, {:.3f} ms.",
+            i, stats.trianglesCulled, stats.triangles, stats.CulledRatio() * 100.0, stats.frustumCulled, stats.coneCulled, stats.meshlets,
+            stopwatch.ElapsedMs());
+    }
+}
+#endif
+#ifdef IMPL_MESH_GEOMETRY_ARENA
+/**
+ * @brief Log occupancy and fragmentation of the shared geometry buffers.
+ */
+void LogGeometryArenas()
+{
+    for (const auto &[key, arena] : Mesh::Arenas())
+    {
+        const GeometryArenaStats stats = arena->Stats();
+        LOG("Geometry arena {} (stride {} B): {} ranges, vertices {} / {} ({:.1f}% fragmented), indices {:.1f} / {:.1f} KB ({:.1f}% fragmented), {} grows.",
+            key, stats.stride, stats.vertices.allocations, stats.vertices.used, stats.vertices.capacity, stats.vertices.Fragmentation() * 100.0,
+            stats.indices.used / 1024.0, stats.indices.capacity / 1024.0, stats.indices.Fragmentation() * 100.0, stats.grows);
+    }
+}
+#endif
+#ifdef IMPL_MESH_LOD
+/**
+ * @brief Log the generated levels of detail and the triangles drawn with them from every preset camera.
+ *
+ * Triangle counts stand in for throughput, the object space error of the selected level projected
+ * to pixels bounds the image error against the full meshes.
+ */
+void LogLodSelection()
+{
+    // chain of the whole scene, level by level
+    std::vector<size_t> levelTriangles;
+    size_t simplified = 0, meshes = 0;
+    for (auto &object : RenderObjects)
+    {
+        if (object->GetType() != RenderObject::Type::Mesh)
+            continue;
+
+        const LodChain &lods = object->GetMeshRenderer().GetMesh().Lods();
+        meshes++;
+        simplified += lods.levels.size() > 1;
+        for (size_t level = 0; level < lods.levels.size(); level++)
+        {
+            if (levelTriangles.size() <= level)
+                levelTriangles.push_back(0);
+            levelTriangles[level] += lods.levels[level].indexCount / 3;
+        }
+    }
+    std::string chain;
+    for (size_t level = 0; level < levelTriangles.size(); level++)
+        chain += std::format("{}{}", level ? " / " : "", levelTriangles[level]);
+    LOG("Scene LODs: {} of {} meshes simplified, triangles per level {}.", simplified, meshes, chain);
+
+    chain.clear();
+    for (size_t level = 0; level < Cat::lods.levels.size(); level++)
+        chain += std::format("{}{} ({:.3f})", level ? " / " : "", Cat::lods.levels[level].indexCount / 3, Cat::lods.levels[level].error);
+    LOG("Cat LODs, triangles (error): {}.", chain);
+
+    // selection from the preset cameras
+    auto &presets = cameraObject.GetTransforms();
+    for (size_t i = 0; i < presets.size(); i++)
+    {
+        Camera camera;
+        camera.LinkTransform(presets[i]);
+        camera.SetProjection(App::WindowWidth / App::WindowHeight, App::WindowFOV);
+        const glm::vec3 eye = presets[i].GetWorldPosition();
+        const float pixelScale = MeshSimplifier::PixelScale(camera.GetProjectionMatrix(), App::WindowHeight);
+        RenderObject::SetCullCamera(camera.GetProjectionMatrix() * camera.GetViewMatrix(), eye, pixelScale);
+
+        size_t full = 0, drawn = 0, reduced = 0;
+        float maxPixelError = 0.0f;
+        for (auto &object : RenderObjects)
+        {
+            const LodChain *lods = object->GetType() == RenderObject::Type::Mesh ? &object->GetMeshRenderer().GetMesh().Lods()
+                                 : object->GetType() == RenderObject::Type::CatType ? &Cat::lods : nullptr;
+            if (!lods || lods->levels.empty())
+                continue;
+
+            const glm::mat4 model = object->GetTransform().GetMatrix();
+            const uint32_t lod = RenderObject::SelectLod(*lods, model);
+            const MeshLod &level = lods->levels[lod];
+            full  += lods->levels[0].indexCount / 3;
+            drawn += level.indexCount / 3;
+            if (lod > 0)
+            {
+                const glm::vec3 localEye = glm::vec3(glm::inverse(model) * glm::vec4(eye, 1.0f));
+                const float distance = glm::length(localEye - lods->center) - lods->radius;
+                maxPixelError = std::max(maxPixelError, level.error * pixelScale / distance);
+                reduced++;
+            }
+        }
+
+        LOG("LOD selection from camera {}: {} / {} triangles drawn ({:.1f}%), {} objects reduced, max projected error {:.2f} px.",
+            i, drawn, full, full ? drawn * 100.0 / full : 0.0, reduced, maxPixelError);
+    }
+}
+#endif
+/**
+ * @brief Log the uniform calls of one frame.
+ *
+ * Camera matrices and position, time and fog used to be 21 uniform calls per frame (23 with a
+ * highlighted object), set on each program and again for every box; they are now the single
+ * FrameUniforms update counted here.
+ */
+void LogFrameUniformCalls(uint64_t uniformCalls, uint64_t frameUploads)
+{
+    LOG("Frame uniform calls: {} loose uniforms, {} frame block update of {} B.", uniformCalls, frameUploads, sizeof(FrameConstants));
 }
 void LoadObjects()
 {
@@ -108,14 +363,21 @@ void LoadObjects()
     for (size_t i = 0; i < lightObjects.size(); i++)
     {
         lightObjects[i].SetData(i);
+        lightObjects[i].ApplyData(lightBuffer);
     }
+    lightBuffer.SetCount(lightObjects.size());
+    lightBuffer.Create();
+    frameUniforms.Create();
+    objectBuffer.Create();
+    RenderObject::SetObjectBuffer(objectBuffer);
 
     scene = MeshLoader::LoadScene("res/Models/Scene/scene.glb", shader);
+    QuantizeStats quantizeStats;
     for (auto& sceneMesh : scene)
     {
         // Create mesh based from MeshLoader
         auto mesh = std::make_unique<Mesh>();
-        mesh->CreateGLBuffers(sceneMesh.meshSource);
+        mesh->CreateGLBuffers(sceneMesh.meshSource, Mesh::DefaultFormat, &quantizeStats);
 
         // Create meshRenderer from mesh, shader and material
         auto meshRenderer = std::make_unique<MeshRenderer>(*mesh, shader, sceneMesh.material);
@@ -127,7 +389,22 @@ void LoadObjects()
         RenderObjects.emplace_back(std::make_unique<RenderObject>(transformFromMatrix, *meshRenderer));
         Meshes.emplace_back(std::move(mesh));
         Renderers.emplace_back(std::move(meshRenderer));
+#ifdef IMPL_MATERIAL_BUFFER
+        materialBuffer.Set(sceneMesh.material);
+#endif
     }
+#ifdef IMPL_MATERIAL_BUFFER
+    // Objects without a material, like the cat, are lit as bronze
+    materialBuffer.SetDefault(material);
+    materialBuffer.Create();
+    LOG("Material buffer: {} materials.", materialBuffer.Count());
+#endif
+    LOG("Scene GPU geometry: {} vertices, {:.1f} KB -> {:.1f} KB ({:.2f}x), max error: position {:.2e}, normal {:.3f} deg, uv {:.2e}, tangent {:.3f} deg.",
+        quantizeStats.vertices, quantizeStats.floatBytes / 1024.0, quantizeStats.compactBytes / 1024.0, quantizeStats.Ratio(),
+        quantizeStats.maxPositionError, quantizeStats.maxNormalError, quantizeStats.maxUVError, quantizeStats.maxTangentError);
+#ifdef IMPL_MESH_GEOMETRY_ARENA
+    LogGeometryArenas();
+#endif
 
     Cat::LoadCat(shader);
     cameraObject.SetStaticParent(catObj.get()->GetTransform());
@@ -157,6 +434,51 @@ void LoadObjects()
     RenderObjects.emplace_back(boxObjSmlA);
     RenderObjects.emplace_back(boxObjMidA);
     RenderObjects.emplace_back(boxObjBigA);
+
+#ifdef IMPL_AABB_TREE
+    // Scene tree over the world bounds, moved every frame by UpdateSceneObjects(); the skybox has none
+    sceneTree.Clear();
+    sceneProxies.assign(RenderObjects.size(), AabbTree::Null);
+    for (size_t i = 0; i < RenderObjects.size(); i++)
+    {
+        const Bounds bounds = RenderObjects[i]->WorldBounds();
+        if (!bounds.Empty())
+            sceneProxies[i] = sceneTree.Insert(bounds, static_cast<uint32_t>(i));
+    }
+    LOG("Scene tree: {} of {} objects, height {}.", sceneTree.Size(), RenderObjects.size(), sceneTree.Height());
+#endif
+
+#ifdef IMPL_RENDER_BENCHMARKS
+    RenderBenchmarks::UniformLookups(shader);
+    RenderBenchmarks::ObjectBufferThroughput();
+    RenderBenchmarks::BoxInstancing(SceneShader(*boxObjBigT));
+#endif
+#ifdef IMPL_FRUSTUM_CULLING
+    LogFrustumCulling();
+#endif
+#ifdef IMPL_MESH_MESHLETS
+    LogMeshletCulling();
+#endif
+#ifdef IMPL_MESH_LOD
+    LogLodSelection();
+#endif
+}
+
+/**
+ * @brief Log the time spent loading shaders and objects at startup.
+ *
+ * Programs restored from the binary cache skip compilation, so the shader time of a second start
+ * compared to the first one (or to a start after clearing the cache) shows what the cache saves.
+ */
+void LogStartupTiming(double shadersMs, double objectsMs)
+{
+#ifdef IMPL_PROGRAM_CACHE
+    const ProgramCacheStats &stats = ProgramCache::Stats();
+    LOG("Startup: shaders {:.1f} ms ({} from program cache, {} compiled, {} cached binaries rejected), objects {:.1f} ms.",
+        shadersMs, stats.hits, stats.misses, stats.rejected, objectsMs);
+#else
+    LOG("Startup: shaders {:.1f} ms, objects {:.1f} ms.", shadersMs, objectsMs);
+#endif
 }
 
 void App::InitWindow(GLFWwindow* window)
@@ -164,18 +486,21 @@ void App::InitWindow(GLFWwindow* window)
     _window = window;
 
     // Set common settings
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::Apply(Pipelines::Scene);
 
     // Set shaders
+    Stopwatch stopwatch;
     LoadShaders();
+    const double shadersMs = stopwatch.ElapsedMs();
+#ifdef IMPL_SHADER_HOT_RELOAD
+    shaderReloader.Create(window);
+    WatchShaders();
+#endif
 
     // Set objects
+    stopwatch.Restart();
     LoadObjects();
+    LogStartupTiming(shadersMs, stopwatch.ElapsedMs());
 }
 
 void App::Update()
@@ -248,11 +573,12 @@ void ApplyLightAndCamera()
 {
     Shader::Bind(shader);
 
-    // Light
+    // Light, only the ones whose transform or parameters changed are uploaded
     for (auto & lightObject : lightObjects)
     {
-        lightObject.ApplyData();
+        lightObject.ApplyData(lightBuffer);
     }
+    lightBuffer.Upload();
 
     if (!App::flyMode)
     {
@@ -266,6 +592,25 @@ void ApplyLightAndCamera()
     }
 
     // Check camera sphere collision
+#ifdef IMPL_AABB_TREE
+    // Only objects whose bounds are within the collision distance can be that close
+    {
+        const glm::vec3 cameraPosition = cameraObject.GetTransform().GetPosition();
+        sceneTree.QuerySphere(cameraPosition, App::CollisionDistance, [&cameraPosition](uint32_t item)
+        {
+            RenderObject &obj = *RenderObjects[item];
+            if (obj.GetType() != RenderObject::Type::Sphere)
+                return;
+
+            const glm::vec3 spherePosition = obj.GetTransform().GetPosition();
+            if (glm::distance(cameraPosition, spherePosition) < App::CollisionDistance)
+            {
+                const glm::vec3 dir = glm::normalize(cameraPosition - spherePosition);
+                cameraObject.GetTransform().SetPosition(spherePosition + dir * App::CollisionDistance);
+            }
+        });
+    }
+#else
     {
         const glm::vec3 cameraPosition = cameraObject.GetTransform().GetPosition();
         const glm::vec3 spherePosition = sphereObj->GetTransform().GetPosition();
@@ -276,29 +621,37 @@ void ApplyLightAndCamera()
             cameraObject.GetTransform().SetPosition(spherePosition + dir * App::CollisionDistance);
         }
     }
+#endif
 }
 void ApplyShaderData()
 {
-    Shader::Bind(shader);
-
-    // Matrices and Uniforms
-    Shader::SetMat4(shader._utils.ViewM, cameraObject.GetCamera().GetViewMatrix());
-    Shader::SetMat4(shader._utils.ProjectionM, cameraObject.GetCamera().GetProjectionMatrix());
-
-    Shader::SetVec3(shader._utils.ViewPosition, cameraObject.GetTransform().GetWorldPosition());
-
-    Shader::SetInt(shader._utils.lightCount, lightObjects.size());
-    Shader::SetInt(shader._utils.useFlashLight, App::useFlashLight);
-    Shader::SetInt(shader._utils.useFireLight, Fire::pointFlag);
-    Shader::SetInt(shader._utils.useCubeMap, false);
+    // Camera, computed once for the frame
+    const CameraState &camera = cameraObject.GetCamera().Update();
+    RenderObject::SetCullCamera(camera.viewProjection, camera.position,
+                                MeshSimplifier::PixelScale(camera.projection, App::WindowHeight));
 
     // Fog
-    Shader::SetInt(shader._utils.useFog, App::useFog);
     App::FogColor += App::FogColorStep;
     if (App::FogColor < App::FogColorMin || App::FogColor > App::FogColorMax ) App::FogColorStep *= -1;
-    Shader::SetVec3(shader._utils.fogColor, glm::vec3(App::FogColor));
-    Shader::SetFloat(shader._utils.fogStart, App::FogStart);
-    Shader::SetFloat(shader._utils.fogEnd, App::FogEnd);
+
+    // Frame constants shared by all shaders
+    FrameConstants constants;
+    constants.view           = camera.view;
+    constants.projection     = camera.projection;
+    constants.viewProjection = camera.viewProjection;
+    constants.skyboxView     = glm::mat4(glm::mat3(camera.view));
+    constants.viewPosition   = camera.position;
+    constants.time           = static_cast<float>(glfwGetTime());
+    constants.fogColor       = glm::vec3(App::FogColor);
+    constants.fogStart       = App::FogStart;
+    constants.fogEnd         = App::FogEnd;
+    constants.useFog         = App::useFog;
+    constants.useFlashLight  = App::useFlashLight;
+    constants.useFireLight   = Fire::pointFlag;
+    frameUniforms.Update(constants);
+
+    Shader::Bind(shader);
+    Shader::SetInt(shader._utils.useCubeMap, false);
 
     // Water
     Shader::Bind(shaderWater);
@@ -306,14 +659,6 @@ void ApplyShaderData()
     Shader::SetInt(shaderWater._water.WaterTexture, 0);
     Shader::SetVec2(shaderWater._water.ScrollSpeed, App::WaterDir);
     Shader::SetFloat(shaderWater._utils.alpha,      App::WaterAlpha);
-    Shader::SetMat4(shaderWater._utils.ModelM, waterObj->GetTransform().GetMatrix());
-    Shader::SetMat4(shaderWater._utils.ViewM, cameraObject.GetCamera().GetViewMatrix());
-    Shader::SetMat4(shaderWater._utils.ProjectionM, cameraObject.GetCamera().GetProjectionMatrix());
-
-    Shader::SetInt(shaderWater._utils.useFog, App::useFog);
-    Shader::SetVec3(shaderWater._utils.fogColor, glm::vec3(App::FogColor));
-    Shader::SetFloat(shaderWater._utils.fogStart, App::FogStart);
-    Shader::SetFloat(shaderWater._utils.fogEnd, App::FogEnd);
 }
 void ApplyBoxSettings(RenderObject &obj)
 {
@@ -345,28 +690,26 @@ void ApplyBoxSettings(RenderObject &obj)
         }
         case(TypeBox::BoxBigA):
         {
-            Shader::SetInt(shader._utils.useAlpha, true);
-            Shader::SetFloat(shader._utils.alpha, App::BoxBigAlpha);
+            obj.SetAlpha(App::BoxBigAlpha);
             break;
         }
         case(TypeBox::BoxMidA):
         {
-            Shader::SetInt(shader._utils.useAlpha, true);
-            Shader::SetFloat(shader._utils.alpha, App::BoxMidAlpha);
+            obj.SetAlpha(App::BoxMidAlpha);
             break;
         }
         case(TypeBox::BoxSmlA):
         {
-            Shader::SetInt(shader._utils.useAlpha, true);
-            Shader::SetFloat(shader._utils.alpha, App::BoxSmlAlpha);
+            obj.SetAlpha(App::BoxSmlAlpha);
             break;
         }
         default:
             break;
     }
 }
-void RenderSceneObjects()
+void UpdateSceneObjects()
 {
+    // Animate, then write the per draw data of every object once for the frame
     for (auto& ptr : RenderObjects)
     {
         // safety check
@@ -375,41 +718,329 @@ void RenderSceneObjects()
 
         if (obj.GetType() == RenderObject::Type::Box)
         {
-            Shader::Bind(shader);
-            Shader::SetMat4(shader._utils.ViewM, cameraObject.GetCamera().GetViewMatrix());
             ApplyBoxSettings(obj);
         }
-        else if (obj.GetType() == RenderObject::Type::CubeMap)
+        obj.Animate();
+    }
+
+    // World bounds of every object, moved in the scene tree and tested against the camera
+#ifdef IMPL_FRUSTUM_CULLING
+    sceneCuller.Clear();
+#endif
+    for (size_t i = 0; i < RenderObjects.size(); i++)
+    {
+        const Bounds bounds = RenderObjects[i] ? RenderObjects[i]->WorldBounds() : Bounds{};
+#ifdef IMPL_AABB_TREE
+        if (i < sceneProxies.size() && sceneProxies[i] != AabbTree::Null)
+            sceneTree.Move(sceneProxies[i], bounds);
+#endif
+#ifdef IMPL_FRUSTUM_CULLING
+        sceneCuller.Add(bounds);
+#endif
+    }
+#ifdef IMPL_FRUSTUM_CULLING
+    // Culled objects are not drawn
+    const CameraState &camera = cameraObject.GetCamera().GetState();
+    sceneCuller.Cull(Frustum(camera.viewProjection), MeshSimplifier::PixelScale(camera.projection, App::WindowHeight), App::CullMinPixels);
+#endif
+
+#ifdef IMPL_RENDER_QUEUE
+    // Keys of all objects in draw order, the data follows that order so objects drawn one after another can be instanced
+    const glm::mat4 view = cameraObject.GetCamera().GetState().view;
+    renderQueue.Build(RenderObjects.size(), [&view](size_t begin, size_t end, std::vector<RenderQueueEntry> &bucket)
+    {
+        for (size_t i = begin; i < end; i++)
+            if (RenderObjects[i] && !IsCulled(i))
+                bucket.push_back({SortKey(*RenderObjects[i], view), static_cast<uint32_t>(i)});
+    });
+    renderQueue.Sort();
+
+    objectBuffer.BeginFrame();
+    for (const RenderQueueEntry &entry : renderQueue.Entries())
+        RenderObjects[entry.item]->WriteObjectData(objectBuffer);
+
+    // The highlight may still draw a culled object, its data goes after the queued objects
+    for (size_t i = 0; i < RenderObjects.size(); i++)
+        if (RenderObjects[i] && IsCulled(i))
+            RenderObjects[i]->WriteObjectData(objectBuffer);
+#else
+    objectBuffer.BeginFrame();
+    for (auto& ptr : RenderObjects)
+        if (ptr) ptr->WriteObjectData(objectBuffer);
+#endif
+}
+#ifdef IMPL_GL_STATE_CACHE
+/**
+ * @brief Log the GL calls of one frame GLState forwarded to the driver and the redundant ones it skipped.
+ *
+ * Without the cache every object bound its program, vertex array and textures, reset its depth and
+ * stencil masks and unbound its vertex array again, and every uniform was uploaded even when unchanged.
+ */
+void LogGLStateCalls(const GLStateCounters &counters)
+{
+    constexpr const char *Kinds[GLStateCounters::KindCount] = {"program", "vertex array", "texture", "pipeline", "uniform"};
+    for (int kind = 0; kind < GLStateCounters::KindCount; kind++)
+        LOG("GL {} calls: {} issued, {} filtered.", Kinds[kind], counters.issued[kind], counters.filtered[kind]);
+
+    const uint32_t requested = counters.Issued() + counters.Filtered();
+    LOG("GL state calls: {} of {} issued, {:.1f}% filtered as redundant.", counters.Issued(), requested,
+        requested ? 100.0 * counters.Filtered() / requested : 0.0);
+}
+#endif
+#if defined(IMPL_RENDER_QUEUE) && defined(IMPL_RENDER_BENCHMARKS)
+/// Time the submission of the opaque scene meshes in render queue order, see RenderBenchmarks::SceneSubmission().
+void LogSceneSubmission()
+{
+    std::vector<RenderObject *> meshes;
+    for (const RenderQueueEntry &entry : renderQueue.Entries())
+    {
+        RenderObject &obj = *RenderObjects[entry.item];
+        if (obj.GetType() == RenderObject::Type::Mesh && obj.Pass() == RenderQueue::Pass::Opaque)
+            meshes.push_back(&obj);
+    }
+    RenderBenchmarks::SceneSubmission(meshes, SceneShader);
+}
+#endif
+/**
+ * @brief Index of the object the stencil picking pass finds at a window pixel, -1 for none.
+ *
+ * Every visible object is drawn again with its index + 1 as stencil reference and the pixel is read back,
+ * which waits for the GPU to finish. The stencil has 8 bits, so indices from 255 on wrap around.
+ */
+int StencilPick(const int winX, const int winY)
+{
+    // Depth tested, colors masked, fragments passing the depth test write ref into the stencil
+    PipelineState picking = Pipelines::Picking;
+
+    // Depth and stencil masks have to be enabled to clear buffers
+    GLState::Apply(picking);
+    glClearStencil(0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    // Culled objects cover no pixel to click on
+    for (size_t i = 0; i < RenderObjects.size(); i++) {
+        if (IsCulled(i)) continue;
+        picking.stencilRef = static_cast<GLint>(i + 1);
+        RenderObjects[i]->Render(SceneShader(*RenderObjects[i]), picking);
+    }
+
+    // The next pass applies its own state, colors and stencil test are restored there
+
+    // Read stencil pixel
+    unsigned char pixelID = 0;
+    glReadPixels(winX, winY, 1, 1,
+                 GL_STENCIL_INDEX, GL_UNSIGNED_BYTE,
+                 &pixelID);
+
+    return pixelID == 0 ? -1 : pixelID - 1;
+}
+/**
+ * @brief Index of the nearest object under a window pixel, -1 for none, found by casting a ray on the CPU.
+ *
+ * The ray runs through the pixel center from the near plane (distance 0) to the far plane (distance 1) of the
+ * camera of the last frame. The scene tree skips every object whose box the ray misses or enters behind the
+ * nearest hit so far, the others test their triangles, see RenderObject::Raycast(). Nothing waits for the GPU.
+ */
+int RaycastPick(const int winX, const int winY)
+{
+    const CameraState &camera = cameraObject.GetCamera().GetState();
+    const glm::vec4 viewport(0.0f, 0.0f, App::WindowWidth, App::WindowHeight);
+    const glm::vec2 pixel(static_cast<float>(winX) + 0.5f, static_cast<float>(winY) + 0.5f);
+    const glm::vec3 nearPoint = glm::unProject(glm::vec3(pixel, 0.0f), camera.view, camera.projection, viewport);
+    const glm::vec3 farPoint = glm::unProject(glm::vec3(pixel, 1.0f), camera.view, camera.projection, viewport);
+    const glm::vec3 direction = farPoint - nearPoint;
+
+    // Culled objects cover no pixel to click on
+    int picked = -1;
+    float nearest = 1.0f;
+    sceneTree.QueryRay(nearPoint, direction, nearest, [&](const uint32_t item, float)
+    {
+        if (!IsCulled(item) && RenderObjects[item]->Raycast(nearPoint, direction, nearest))
+            picked = static_cast<int>(item);
+        return nearest;
+    });
+    return picked;
+}
+#ifdef IMPL_RENDER_BENCHMARKS
+/**
+ * @brief Log the ray cast picking against the stencil picking on a grid of scripted clicks over the window.
+ *
+ * Clicks whose objects differ are listed, expected ones fall on the transparent texels of the fire sprite, which
+ * the ray hits but the shader discards, and on the silhouettes of simplified levels of detail. Objects from index
+ * 255 on are beyond the stencil and only counted. The frame is cleared afterwards.
+ */
+void LogPicking()
+{
+    constexpr int Columns = 16;
+    constexpr int Rows = 9;
+    constexpr int Repeats = 100;
+    constexpr int MaxListed = 4;
+
+    std::vector<glm::ivec2> clicks;
+    for (int row = 0; row < Rows; row++)
+    {
+        for (int column = 0; column < Columns; column++)
         {
-            Shader::Bind(shader);
-            Shader::SetMat4(shader._utils.ViewM, glm::mat4(glm::mat3(cameraObject.GetCamera().GetViewMatrix())));
+            clicks.emplace_back(static_cast<int>((column + 0.5f) * App::WindowWidth / Columns),
+                                static_cast<int>((row + 0.5f) * App::WindowHeight / Rows));
         }
-        else if (obj.GetType() == RenderObject::Type::Water)
+    }
+
+    std::vector<int> rayPicks(clicks.size());
+    Stopwatch stopwatch;
+    for (int repeat = 0; repeat < Repeats; repeat++)
+    {
+        for (size_t i = 0; i < clicks.size(); i++)
+            rayPicks[i] = RaycastPick(clicks[i].x, clicks[i].y);
+    }
+    const double rayUs = stopwatch.ElapsedMs() * 1000.0 / (Repeats * clicks.size());
+
+    std::vector<int> stencilPicks(clicks.size());
+    glFinish();
+    stopwatch.Restart();
+    for (size_t i = 0; i < clicks.size(); i++)
+        stencilPicks[i] = StencilPick(clicks[i].x, clicks[i].y);
+    const double stencilMs = stopwatch.ElapsedMs() / clicks.size();
+
+    uint32_t agree = 0, differ = 0, beyondStencil = 0;
+    for (size_t i = 0; i < clicks.size(); i++)
+    {
+        if (rayPicks[i] >= 255)
+            beyondStencil++;
+        else if (rayPicks[i] == stencilPicks[i])
+            agree++;
+        else if (differ++ < MaxListed)
+            LOG("Picking at ({}, {}): ray cast {}, stencil {}.", clicks[i].x, clicks[i].y, rayPicks[i], stencilPicks[i]);
+    }
+
+    LOG("Picking, {} scripted clicks: ray cast {:.2f} us per pick, stencil {:.3f} ms per pick ({:.0f}x); "
+        "{} agree, {} differ, {} beyond the stencil.", clicks.size(), rayUs, stencilMs,
+        rayUs > 0.0 ? stencilMs * 1000.0 / rayUs : 0.0, agree, differ, beyondStencil);
+
+    GLState::Apply(Pipelines::Scene);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+}
+#endif
+void RenderSceneObject(RenderObject &obj, const GLsizei instances = 1)
+{
+    if (obj.GetType() == RenderObject::Type::Water)
+    {
+        obj.Render(shaderWater);
+    }
+
+    obj.Render(SceneShader(obj), Pipelines::Scene, instances);
+}
+void RenderSceneObjects()
+{
+#ifdef IMPL_RENDER_QUEUE
+    // One submission in key order, runs of objects sharing their draw become one instanced draw
+    // and runs of scene meshes one multi-draw
+    static std::vector<RenderObject *> batch;
+    const std::vector<RenderQueueEntry> &entries = renderQueue.Entries();
+    for (size_t i = 0; i < entries.size();)
+    {
+        RenderObject &obj = *RenderObjects[entries[i].item];
+
+        if (obj.GetType() == RenderObject::Type::Mesh)
         {
-            obj.Render(shaderWater);
+            batch.clear();
+            batch.push_back(&obj);
+            while (i + batch.size() < entries.size() && obj.CanMultiDraw(*RenderObjects[entries[i + batch.size()].item]))
+                batch.push_back(RenderObjects[entries[i + batch.size()].item].get());
+
+            RenderObject::RenderMeshes(SceneShader(obj), batch);
+            i += batch.size();
+            continue;
         }
 
-        obj.Render(shader);
+        GLsizei instances = 1;
+        while (i + instances < entries.size() && obj.CanInstance(*RenderObjects[entries[i + instances].item], instances))
+            instances++;
+
+        RenderSceneObject(obj, instances);
+        i += instances;
     }
+#else
+    for (size_t i = 0; i < RenderObjects.size(); i++)
+    {
+        // safety check
+        if (!RenderObjects[i] || IsCulled(i)) continue;
+        RenderSceneObject(*RenderObjects[i]);
+    }
+#endif
 }
 void App::Render()
 {
+    // Depth and stencil masks of the last draw may block the clear
+    GLState::BeginFrame();
+    GLState::Apply(Pipelines::Scene);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
+#ifdef IMPL_SHADER_HOT_RELOAD
+    // Finished rebuilds replace their programs before anything is drawn
+    shaderReloader.Update();
+#endif
+
+    const uint64_t uniformCalls = Shader::UniformCalls();
+    const uint64_t frameUploads = frameUniforms.Uploads();
+
     ApplyLightAndCamera();
     ApplyShaderData();
+    UpdateSceneObjects();
 
     // Objects
     RenderSceneObjects();
 
+    // Reported once: uniform calls of the first frame, variant costs after the first frame compiled them
+    static uint64_t frameIndex = 0;
+    if (frameIndex == 0)
+    {
+        LogFrameUniformCalls(Shader::UniformCalls() - uniformCalls, frameUniforms.Uploads() - frameUploads);
+    }
+#if defined(IMPL_SHADER_PERMUTATIONS) && defined(IMPL_RENDER_BENCHMARKS)
+    else if (frameIndex == 1)
+    {
+        RenderBenchmarks::ShaderVariantCost(RenderObjects, shader, shaderVariants, App::useFog);
+        RenderSceneObjects();
+    }
+#endif
+#ifdef IMPL_GL_STATE_CACHE
+    else if (frameIndex == 3)
+    {
+        // First frame without a benchmark in it
+        LogGLStateCalls(GLState::Frame());
+#ifdef IMPL_FRUSTUM_CULLING
+        const CullStats &culling = sceneCuller.Stats();
+        LOG("Frustum culling this frame: {} / {} objects visible, {} outside, {} below {} px.", culling.visible,
+            sceneCuller.Size(), culling.outside, culling.belowPixels, App::CullMinPixels);
+#endif
+    }
+#endif
+#if defined(IMPL_RENDER_QUEUE) && defined(IMPL_RENDER_BENCHMARKS)
+    else if (frameIndex == 4)
+    {
+        LogSceneSubmission();
+        RenderSceneObjects();
+    }
+#endif
+#ifdef IMPL_RENDER_BENCHMARKS
+    else if (frameIndex == 5)
+    {
+        LogPicking();
+        RenderSceneObjects();
+    }
+#endif
+    frameIndex++;
+
     // Picking
     if ((App::stencilIdx >= 0 || App::stencilIdxLast >= 0))  {
 
         // Check if user have clicked on the same object -> off white mode
         if (App::stencilIdx == App::stencilIdxLast)
         {
-            RenderObjects[stencilIdx]->Render(shader);
+            RenderObjects[stencilIdx]->Render(SceneShader(*RenderObjects[stencilIdx]));
             App::stencilIdx = App::stencilIdxLast = -1;
+            objectBuffer.EndFrame();
             return;
         }
 
@@ -428,55 +1059,21 @@ void App::Render()
         }
 
         Shader::Bind(shaderWhite);
-
-        // Set matrices
-        Shader::SetMat4(shaderWhite._utils.ViewM, cameraObject.GetCamera().GetViewMatrix());
-        Shader::SetMat4(shaderWhite._utils.ProjectionM, cameraObject.GetCamera().GetProjectionMatrix());
-
         RenderObjects[idx]->Render(shaderWhite);
 
         // Set primary shader back
         Shader::Bind(shader);
     }
+
+    objectBuffer.EndFrame();
 }
 
 void DoPicking(const int winX, const int winY) {
-    // Enable tests
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
-    glEnable(GL_STENCIL_TEST);
-
-    // Enable stencil mask and clear buffers
-    glStencilMask(0xFF);
-    glClearStencil(0);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-
-    // Disable color and enable depth mask
-    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-    glDepthMask(GL_TRUE);
-
-    // When depth test success then switch stencil to ref
-    glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-
-    int ref = 1;
-    for (const auto & RenderObject : RenderObjects) {
-        glStencilFunc(GL_ALWAYS, ref, 0xFF);
-        RenderObject->Render(shader);
-        ++ref;
-    }
-
-    // Enable color
-    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-    // glDepthMask(GL_TRUE);
-    glDisable(GL_STENCIL_TEST);
-
-    // Read stencil pixel
-    unsigned char pixelID = 0;
-    glReadPixels(winX, winY, 1, 1,
-                 GL_STENCIL_INDEX, GL_UNSIGNED_BYTE,
-                 &pixelID);
-
-    App::stencilIdx = (pixelID == 0 ? -1 : pixelID - 1);
+#ifdef IMPL_TRIANGLE_BVH
+    App::stencilIdx = RaycastPick(winX, winY);
+#else
+    App::stencilIdx = StencilPick(winX, winY);
+#endif
     LOG("stencilIdx: {}", App::stencilIdx);
 
     // Update models based on selected item
@@ -603,9 +1200,18 @@ void App::OnKeyChanged(const int key, const bool pressed)
         switch (key)
         {
             case GLFW_KEY_R:
+            {
+#ifdef IMPL_SHADER_HOT_RELOAD
+                // Ctrl+R is the reload benchmark: every program compiled from source, logged once all have swapped
+                shaderReloader.RebuildAll(input.keyCtrl);
+                LOG("Shaders reloading{}", input.keyCtrl ? " from source" : "");
+#else
+                Stopwatch stopwatch;
                 LoadShaders();
-                LOG("Shaders reloaded");
+                LOG("Shaders reloaded in {:.1f} ms", stopwatch.ElapsedMs());
+#endif
                 break;
+            }
 
             case GLFW_KEY_G:
                 if (!input.keyCtrl) break;
@@ -755,14 +1361,20 @@ void App::End()
     Shader::Delete(shader);
     Shader::Delete(shaderWater);
     Shader::Delete(shaderWhite);
+    shaderVariants.Clear();
+    shaderReloader.Destroy();
+    lightBuffer.Destroy();
+    materialBuffer.Destroy();
+    frameUniforms.Destroy();
+    objectBuffer.Destroy();
 
     // Free meshes
     glDeleteBuffers(1, &Box::VBO);
     glDeleteVertexArrays(1, &Box::VAO);
 
-    glDeleteBuffers(1, &Cat::VBOPos);
-    glDeleteBuffers(1, &Cat::VBONorm);
-    glDeleteBuffers(1, &Cat::VAO);
+    glDeleteBuffers(1, &Cat::VBO);
+    glDeleteBuffers(1, &Cat::EBO);
+    glDeleteVertexArrays(1, &Cat::VAO);
 
     glDeleteBuffers(1, &cubeMapObj->GetCubemap().VBO);
     glDeleteVertexArrays(1, &cubeMapObj->GetCubemap().VAO);
@@ -778,6 +1390,7 @@ void App::End()
     {
         mesh->DestroyGLBuffers();
     }
+    Mesh::DestroyArenas();
 
     glDeleteBuffers(1, &waterObj->GetWater().EBO);
     glDeleteBuffers(1, &waterObj->GetWater().VBO);
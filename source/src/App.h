@@ -35,6 +35,7 @@ public:
     static constexpr float WindowFOV = 35.0f;
     static constexpr float WindowZNear = 0.1f;
     static constexpr float WindowZFar = 100.0f;
+    static constexpr float CullMinPixels = 1.0f; ///< objects whose bounding sphere covers fewer pixels are not drawn
 
     // Title and window pointer
     static constexpr std::string WindowTitle = "PGR timofili";
@@ -41,9 +41,11 @@ void Camera::SetSpeedVertical(float speed) { _speedVer = speed; }
 
 glm::mat4 Camera::GetViewMatrix() const {
     if (!_transform) return glm::mat4(1.0f);
-    glm::vec3 pos     = _transform->GetWorldPosition();
-    glm::vec3 forward = _transform->GetWorldForward();
-    glm::vec3 up      = _transform->GetWorldUp();
+    // one world matrix instead of one per GetWorldPosition/Forward/Up
+    const glm::mat4 world   = _transform->GetMatrix();
+    const glm::vec3 pos     = glm::vec3(world[3]);
+    const glm::vec3 forward = glm::normalize(glm::vec3(world * glm::vec4(0, 0, -1, 0)));
+    const glm::vec3 up      = glm::normalize(glm::vec3(world * glm::vec4(0, 1, 0, 0)));
     return glm::lookAt(pos, pos + forward, up);
 }
 
@@ -51,3 +53,12 @@ glm::mat4 Camera::GetViewMatrix() const {
 glm::mat4 Camera::GetProjectionMatrix() const {
     return _projection;
 }
+
+const CameraState &Camera::Update() {
+    _state.view           = GetViewMatrix();
+    _state.projection     = _projection;
+    _state.viewProjection = _projection * _state.view;
+    // the view matrix is a rigid transform, its inverse translation is the eye
+    _state.position       = glm::vec3(glm::inverse(_state.view)[3]);
+    return _state;
+}
@@ -17,6 +17,17 @@
 #define HORIZONTAL_TO_VERTICAL_FOV(horizontalFov, aspectRatio) glm::degrees(2 * atan(tan(glm::radians((float)horizontalFov) / 2.0) / (aspectRatio)))
 #include "Transform.h"
 
+/**
+ * @struct CameraState
+ * @brief Matrices and position of a camera, computed once per frame by Camera::Update().
+ */
+struct CameraState
+{
+    glm::mat4 view           = glm::mat4(1.0f);
+    glm::mat4 projection     = glm::mat4(1.0f);
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+    glm::vec3 position       = glm::vec3(0.0f);
+};
 
 class Camera
 {
@@ -46,6 +57,8 @@ private:
     glm::mat4 _projection = glm::mat4(1.0f);
     Transform* _transform = nullptr;
 
+    CameraState _state;
+
 public:
     Camera(Type type, float near, float far);
     Camera();
@@ -78,4 +91,10 @@ public:
     // Matrices
     [[nodiscard]] glm::mat4 GetViewMatrix() const;
     [[nodiscard]] glm::mat4 GetProjectionMatrix() const;
+
+    /// Recompute the cached state from the linked Transform, walking its parent chain once.
+    /// @return The updated state, valid until the next call.
+    const CameraState &Update();
+    /// State of the last Update().
+    [[nodiscard]] const CameraState &GetState() const { return _state; }
 };
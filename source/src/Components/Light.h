@@ -6,9 +6,10 @@
  * \brief      Encapsulates various types of light sources for scene illumination.
  *
  *  This file defines the Light class, representing ambient, directional, point,
- *  and spot lights. It provides methods to configure color, intensity, attenuation
- *  parameters, and spot cone angles, and uploads light data to a Shader for real-time
- *  lighting calculations.
+ *  and spot lights, and LightData, its packed std140 layout in the light
+ *  uniform block. It provides methods to configure color, intensity,
+ *  attenuation parameters, and spot cone angles, and writes them into the
+ *  LightData uploaded by LightBuffer for real-time lighting calculations.
  *
  */
 //----------------------------------------------------------------------------------------
@@ -20,6 +21,29 @@
 // #define IMPL_LIGHT_USE_COLOR_FOR_SPECULAR
 // #define IMPL_LIGHT_USE_DEDICATED_AMBIENT_LIGHT
 
+/**
+ * @struct LightData
+ * @brief One element of the std140 light array, matching struct Light in Shader_F.glsl.
+ *
+ * Every vec3 is followed by a 4-byte scalar, so the struct has no padding in either language.
+ */
+struct LightData
+{
+    glm::vec3 position  = glm::vec3(0.0f);
+    int       type      = 0;
+    glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f);
+    float     constant  = 1.0f;
+    glm::vec3 color     = glm::vec3(1.0f);
+    float     linear    = 0.0f;
+    glm::vec3 ambient   = glm::vec3(0.0f);
+    float     quadratic = 0.0f;
+    glm::vec3 diffuse   = glm::vec3(0.0f);
+    float     cutOff    = 0.0f;
+    glm::vec3 specular  = glm::vec3(0.0f);
+    float     outerCutOff = 0.0f;
+};
+static_assert(sizeof(LightData) == 96, "LightData must match the std140 layout of struct Light");
+
 class Light
 {
 public:
@@ -27,33 +51,9 @@ public:
     const static inline std::string TypeNames[] = {"Ambient", "Direct", "Point", "Spot"};
 
 private:
-    struct LightValue
-    {
-        enum
-        {
-            INT,
-            FLOAT,
-            VEC2,
-            VEC3,
-            VEC4,
-            MAT3,
-            MAT4
-        } type;
-        union
-        {
-            int i;
-            float f;
-            glm::vec2 v2;
-            glm::vec3 v3;
-            glm::vec4 v4;
-            glm::mat3 m3;
-            glm::mat4 m4;
-        };
-    };
-
     Type _type;
     int  _idx = -2;
-    std::unordered_map<std::string, LightValue> _data;
+    LightData _data; ///< parameters, position and direction come from the Transform
 
     static constexpr glm::vec3 LightColor = glm::vec3(1.0f, 1.0f, 1.0f);
     static constexpr glm::vec3 LightAmbient = glm::vec3(0.1f, 0.1f, 0.1f);
@@ -78,27 +78,20 @@ public:
 #ifndef IMPL_LIGHT_USE_COLOR_FOR_SPECULAR
     void SetSpecularColor(const glm::vec3 &specularColor);
 #endif
+    /// Attenuation (constant, linear, quadratic) and the spot cutoff cosine in w
     void SetSpotAttenuation(glm::vec4 spotAttenuation);
 
     Type GetType();
     void SetType(Type type);
 
-    void SetInt(const std::string &name, int value);
-    void SetFloat(const std::string &name, float value);
-    void SetVec2(const std::string &name, const glm::vec2 &value);
-    void SetVec3(const std::string &name, const glm::vec3 &value);
-    void SetVec4(const std::string &name, const glm::vec4 &value);
-    void SetMat3(const std::string &name, const glm::mat3 &value);
-    void SetMat4(const std::string &name, const glm::mat4 &value);
-
     /**
-     * @brief Set the index for shader array uniforms.
-     * @param idx Zero-based index used in uniform names.
+     * @brief Set the index in the light array and the default parameters of the type.
+     * @param idx Zero-based index of the light in the uniform block.
      */
     void SetData(const size_t idx);
     /**
-     * @brief Upload light data to GPU via shader uniforms.
-     * @param shader Shader instance to receive uniform updates.
+     * @brief Write the light parameters into its element of the light uniform block.
+     * @param data Element to fill, position and direction are left untouched.
      */
-    void ApplyData(const Shader &shader) const;
+    void ApplyData(LightData &data) const;
 };
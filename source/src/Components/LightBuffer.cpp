@@ -0,0 +1,67 @@
+#include "LightBuffer.h"
+
+void LightBuffer::Create()
+{
+    Destroy();
+
+    glCreateBuffers(1, &_ubo);
+    glNamedBufferStorage(_ubo, sizeof(Block), &_block, GL_DYNAMIC_STORAGE_BIT);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Binding, _ubo);
+
+    _dirtyBegin = SIZE_MAX;
+    _dirtyEnd   = 0;
+}
+
+void LightBuffer::Destroy()
+{
+    if (_ubo) glDeleteBuffers(1, &_ubo);
+    _ubo = 0;
+}
+
+void LightBuffer::Set(uint32_t index, const LightData &light)
+{
+    if (index >= MaxLights)
+    {
+        LOG_WARNING("Light {} exceeds the {} lights of the light buffer.", index, MaxLights);
+        return;
+    }
+
+    LightData &stored = _block.lights[index];
+    if (std::memcmp(&stored, &light, sizeof(LightData)) == 0)
+        return;
+
+    stored = light;
+    const size_t offset = offsetof(Block, lights) + index * sizeof(LightData);
+    MarkDirty(offset, offset + sizeof(LightData));
+}
+
+void LightBuffer::SetCount(uint32_t count)
+{
+    const int lightCount = static_cast<int>(std::min(count, MaxLights));
+    if (_block.lightCount == lightCount)
+        return;
+
+    _block.lightCount = lightCount;
+    MarkDirty(offsetof(Block, lightCount), offsetof(Block, lightCount) + sizeof(int));
+}
+
+size_t LightBuffer::Upload()
+{
+    if (!_ubo || _dirtyBegin >= _dirtyEnd)
+        return 0;
+
+    const size_t bytes = _dirtyEnd - _dirtyBegin;
+    glNamedBufferSubData(_ubo, static_cast<GLintptr>(_dirtyBegin), static_cast<GLsizeiptr>(bytes),
+                         reinterpret_cast<const uint8_t *>(&_block) + _dirtyBegin);
+
+    _uploadedBytes += bytes;
+    _dirtyBegin = SIZE_MAX;
+    _dirtyEnd   = 0;
+    return bytes;
+}
+
+void LightBuffer::MarkDirty(size_t begin, size_t end)
+{
+    _dirtyBegin = std::min(_dirtyBegin, begin);
+    _dirtyEnd   = std::max(_dirtyEnd, end);
+}
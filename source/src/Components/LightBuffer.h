@@ -0,0 +1,75 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       LightBuffer.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Uniform buffer holding the lights of the scene.
+ *
+ *  This file declares the LightBuffer class, the CPU copy and the GPU buffer
+ *  of the std140 light uniform block. Lights are written every frame, but a
+ *  write that does not change the stored element costs only a comparison;
+ *  changed elements widen a dirty range that is uploaded once with
+ *  glNamedBufferSubData. The buffer is bound to a fixed binding point, so
+ *  every program declaring the block sees the same lights.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "Light.h"
+
+class LightBuffer
+{
+public:
+    /// MAX_LIGHT_COUNT in Shader_F.glsl
+    static constexpr uint32_t MaxLights = 8;
+    /// layout(binding) of LightBlock
+    static constexpr GLuint Binding = 0;
+
+    /**
+     * @struct Block
+     * @brief CPU mirror of LightBlock.
+     */
+    struct Block
+    {
+        LightData lights[MaxLights];
+        int       lightCount = 0;
+        int       padding[3] = {};
+    };
+    static_assert(sizeof(Block) == MaxLights * sizeof(LightData) + 16, "Block must match the std140 layout of LightBlock");
+
+    LightBuffer() = default;
+    ~LightBuffer() { Destroy(); }
+
+    LightBuffer(const LightBuffer &) = delete;
+    LightBuffer &operator=(const LightBuffer &) = delete;
+
+    /// Create the buffer with the current contents and bind it to Binding.
+    void Create();
+    void Destroy();
+
+    /// Store a light, marking it dirty only if it differs from the stored one.
+    void Set(uint32_t index, const LightData &light);
+    void SetCount(uint32_t count);
+
+    /**
+     * @brief Upload the dirty range, if any.
+     * @return Bytes uploaded.
+     */
+    size_t Upload();
+
+    [[nodiscard]] const LightData &Get(uint32_t index) const { return _block.lights[index]; }
+    [[nodiscard]] uint64_t UploadedBytes() const { return _uploadedBytes; }
+
+private:
+    void MarkDirty(size_t begin, size_t end);
+
+    GLuint _ubo = 0;
+    Block  _block;
+
+    // Byte range of _block changed since the last upload
+    size_t _dirtyBegin = SIZE_MAX;
+    size_t _dirtyEnd   = 0;
+
+    uint64_t _uploadedBytes = 0;
+};
@@ -13,7 +13,7 @@
 //----------------------------------------------------------------------------------------
 
 #pragma once
-#include "../Resources/Material/MaterialPGR.h"
+#include "../Resources/Material/MaterialBuffer.h"
 #include "../Resources/Mesh/Mesh.h"
 #include "../Resources/Shader/Shader.h"
 
@@ -49,18 +49,21 @@ public:
     MeshRenderer& operator=(MeshRenderer&&)     = default;
 
     /**
-     * @brief Bind the shader and apply the material if it matches.
-     * @param shader The Shader instance to bind.
+     * @brief Bind the shader and apply the material.
+     * @param shader The Shader instance to bind, the mesh's shader or one of its variants.
      *
-     * If a material was provided at construction and its shader
-     * matches the one being bound, the material's values are applied.
+     * If a material was provided at construction, its values are applied
+     * to the uniforms the bound program uses. With the material buffer the
+     * shaders read the colors through the object data instead.
      */
     void Bind(const Shader &shader) const
     {
         Shader::Bind(shader);
 
-        if (_material && *_shader == shader)
-            _material->ApplyValues();
+#ifndef IMPL_MATERIAL_BUFFER
+        if (_material)
+            _material->ApplyValues(shader);
+#endif
     }
 
     [[nodiscard]] Mesh&     GetMesh()     const    { return *_mesh; }
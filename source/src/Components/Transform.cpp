@@ -142,15 +142,8 @@ void Transform::RotateLocal(const glm::vec3& axis, float angle) {
 }
 #endif
 
-void Transform::SetData(const size_t idx)
+void Transform::ApplyData(LightData &data) const
 {
-    _idx = idx;
-}
-void Transform::ApplyData(const Shader &shader) const
-{
-    std::string i = std::to_string(_idx);
-    int location = shader.GetUniformLocationSafe("lights[" + i + "].position");
-    Shader::SetVec3(location, _position);
-    location = shader.GetUniformLocationSafe("lights[" + i + "].direction");
-    Shader::SetVec3(location, this->GetForward());
+    data.position  = _position;
+    data.direction = this->GetForward();
 }
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "src/Resources/Shader/Shader.h"
+#include "Light.h"
 #include <glm/glm.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 
@@ -39,7 +40,6 @@ public:
     double lastCircleAngle = 0.0f;
 
 private:
-    size_t _idx = 0;
     glm::vec3 _position;
     glm::vec3 _startPosition = _position;
     glm::quat _rotation;
@@ -131,13 +131,8 @@ public:
     void UpdateRotationFromEuler();
 
     /**
-     * @brief Set the index for shader array uniforms.
-     * @param idx Zero-based index used in uniform names.
+     * @brief Write position and direction into the light uniform block element of a light.
+     * @param data Element to fill.
      */
-    void SetData(const size_t idx);
-    /**
-     * @brief Upload transform data to GPU via shader uniforms.
-     * @param shader Shader instance to receive uniform updates.
-     */
-    void ApplyData(const Shader &shader) const;
+    void ApplyData(LightData &data) const;
 };
@@ -18,23 +18,19 @@ void LightObject::SetLight(const Light &light)
 
 void LightObject::SetData(const size_t idx)
 {
-    if (_transform != nullptr)
-    {
-        _transform->SetData(idx);
-    } else
-    {
-        _ownTransform.SetData(idx);
-    }
+    _idx = idx;
     _light.SetData(idx);
 }
-void LightObject::ApplyData()
+void LightObject::ApplyData(LightBuffer &buffer) const
 {
+    LightData data;
     if (_transform != nullptr)
     {
-        _transform->ApplyData(*_shader);
+        _transform->ApplyData(data);
     } else
     {
-        _ownTransform.ApplyData(*_shader);
+        _ownTransform.ApplyData(data);
     }
-    _light.ApplyData(*_shader);
-}
\ No newline at end of file
+    _light.ApplyData(data);
+    buffer.Set(static_cast<uint32_t>(_idx), data);
+}
@@ -7,13 +7,14 @@
  *
  *  This file defines the LightObject class, which associates a Light instance
  *  with a Transform to position and orient it within the scene. It provides
- *  methods to configure light parameters and upload indexed light data to a
- *  Shader for real-time rendering.
+ *  methods to configure light parameters and write indexed light data into the
+ *  LightBuffer for real-time rendering.
  *
  */
 //----------------------------------------------------------------------------------------
 #pragma once
 #include "../Components/Light.h"
+#include "../Components/LightBuffer.h"
 #include "../Components/Transform.h"
 
 
@@ -24,6 +25,7 @@ private:
     Transform  _ownTransform;
     Transform *_transform = nullptr;
     Light _light;
+    size_t _idx = 0;
 
 public:
     LightObject();
@@ -37,5 +39,6 @@ public:
     void SetLight(const Light &light);
 
     void SetData(const size_t idx);
-    void ApplyData();
+    /// Write the light into its element of the buffer, which marks it dirty only if it changed.
+    void ApplyData(LightBuffer &buffer) const;
 };
@@ -0,0 +1,136 @@
+#include "ObjectBuffer.h"
+
+namespace
+{
+    constexpr GLbitfield StorageFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    constexpr GLuint64   FenceTimeout = 1'000'000'000; ///< 1 s in ns, per wait
+}
+
+void ObjectData::SetModel(const glm::mat4 &matrix)
+{
+    model = matrix;
+    const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(matrix)));
+    for (int column = 0; column < 3; ++column)
+        normal[column] = glm::vec4(normalMatrix[column], 0.0f);
+}
+
+void ObjectBuffer::Ring::Create(uint32_t elementStride, uint32_t elements, size_t alignment)
+{
+    stride   = elementStride;
+    capacity = elements;
+    segment  = (static_cast<size_t>(stride) * capacity + alignment - 1) / alignment * alignment;
+    count    = 0;
+
+    glCreateBuffers(1, &buffer);
+    glNamedBufferStorage(buffer, static_cast<GLsizeiptr>(segment * FrameCount), nullptr, StorageFlags);
+    mapped = static_cast<uint8_t *>(glMapNamedBufferRange(buffer, 0, static_cast<GLsizeiptr>(segment * FrameCount), StorageFlags));
+}
+
+void ObjectBuffer::Ring::Destroy()
+{
+    if (buffer)
+    {
+        glUnmapNamedBuffer(buffer);
+        glDeleteBuffers(1, &buffer);
+    }
+    buffer = 0;
+    mapped = nullptr;
+}
+
+void ObjectBuffer::Ring::Grow(uint32_t frame, size_t alignment)
+{
+    // draws already issued keep the old buffer alive until the GPU is done with it
+    Ring old = *this;
+    Create(stride, capacity * 2, alignment);
+    std::memcpy(Element(frame, 0), old.Element(frame, 0), static_cast<size_t>(old.count) * stride);
+    count = old.count;
+    old.Destroy();
+}
+
+void ObjectBuffer::Create(uint32_t objects, uint32_t commands)
+{
+    Destroy();
+
+    GLint alignment = 0;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    _alignment = std::max<size_t>(alignment, sizeof(DrawElementsIndirectCommand));
+
+    if (!GLEW_ARB_shader_draw_parameters)
+        LOG_ERROR("GL_ARB_shader_draw_parameters is not supported, objects cannot read their data.");
+
+    _objects.Create(sizeof(ObjectData), objects, _alignment);
+    _commands.Create(sizeof(DrawElementsIndirectCommand), commands, _alignment);
+    _frame = 0;
+    BindObjects();
+}
+
+void ObjectBuffer::Destroy()
+{
+    for (GLsync &fence : _fences)
+    {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    _objects.Destroy();
+    _commands.Destroy();
+}
+
+void ObjectBuffer::BeginFrame()
+{
+    _frame = (_frame + 1) % FrameCount;
+
+    // the segment is free again once the frame that wrote it FrameCount frames ago has finished
+    if (GLsync &fence = _fences[_frame])
+    {
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED)
+        {
+            _waits++;
+            do
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FenceTimeout);
+            while (status == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    _objects.count  = 0;
+    _commands.count = 0;
+    BindObjects();
+}
+
+void ObjectBuffer::EndFrame()
+{
+    if (_fences[_frame]) glDeleteSync(_fences[_frame]);
+    _fences[_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+uint32_t ObjectBuffer::Push(const ObjectData &data)
+{
+    if (_objects.count == _objects.capacity)
+    {
+        _objects.Grow(_frame, _alignment);
+        BindObjects();
+        LOG("Object buffer grown to {} objects per frame.", _objects.capacity);
+    }
+
+    std::memcpy(_objects.Element(_frame, _objects.count), &data, sizeof(ObjectData));
+    return _objects.count++;
+}
+
+DrawElementsIndirectCommand *ObjectBuffer::PushCommands(uint32_t count, GLintptr &offset)
+{
+    while (_commands.count + count > _commands.capacity)
+        _commands.Grow(_frame, _alignment);
+
+    uint8_t *commands = _commands.Element(_frame, _commands.count);
+    offset = commands - _commands.mapped;
+    _commands.count += count;
+    return reinterpret_cast<DrawElementsIndirectCommand *>(commands);
+}
+
+void ObjectBuffer::BindObjects() const
+{
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, Binding, _objects.buffer, static_cast<GLintptr>(_frame * _objects.segment),
+                      static_cast<GLsizeiptr>(_objects.segment));
+}
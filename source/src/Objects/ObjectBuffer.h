@@ -0,0 +1,145 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       ObjectBuffer.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Ring buffer with the per draw data of all RenderObjects.
+ *
+ *  This file declares ObjectData, the CPU mirror of one element of
+ *  ObjectBlock in res/Shaders/ObjectBlock.glsl, and the ObjectBuffer class.
+ *  Every RenderObject writes its model and normal matrices and its draw
+ *  flags once per frame into a persistently mapped shader storage buffer
+ *  split into FrameCount segments; a fence per segment keeps the CPU from
+ *  overwriting data the GPU still reads. Draws pass the element index as
+ *  their base instance, which the vertex shader reads as gl_BaseInstanceARB,
+ *  so no uniform is set per object. The buffer also carries the indirect
+ *  commands of multi-draws that need a base instance per command.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "GL/glew.h"
+
+/**
+ * @struct ObjectData
+ * @brief CPU mirror of ObjectData in ObjectBlock.glsl, member order and padding follow std430.
+ */
+struct ObjectData
+{
+    glm::mat4 model  = glm::mat4(1.0f);
+    glm::vec4 normal[3] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}}; ///< mat3, std430 pads its columns to vec4
+
+    uint32_t materialIndex = 0; ///< MaterialPGR::Index(), 0 without a material
+    int      useTexture    = 0;
+    int      useAlpha      = 0;
+    float    alpha         = 1.0f;
+    int      useToSphere   = 0;
+    float    alphaToSphere = 0.0f;
+    int      padding[2]    = {};
+
+    // Compact vertices (Mesh::VertexFormat::Compact)
+    glm::vec3 positionScale   = glm::vec3(1.0f);
+    int       useQuantization = 0;
+    glm::vec3 positionOffset  = glm::vec3(0.0f);
+    float     padding2        = 0.0f;
+
+    /// Set the model matrix and the normal matrix derived from it.
+    void SetModel(const glm::mat4 &matrix);
+};
+static_assert(sizeof(ObjectData) == 176, "ObjectData must match the std430 layout of ObjectBlock");
+
+/**
+ * @struct DrawElementsIndirectCommand
+ * @brief Layout read by glMultiDrawElementsIndirect.
+ */
+struct DrawElementsIndirectCommand
+{
+    uint32_t count         = 0;
+    uint32_t instanceCount = 1;
+    uint32_t firstIndex    = 0; ///< in indices, not bytes
+    int32_t  baseVertex    = 0;
+    uint32_t baseInstance  = 0; ///< object index
+};
+
+class ObjectBuffer
+{
+public:
+    /// layout(binding) of ObjectBlock
+    static constexpr GLuint Binding = 2;
+    /// Segments of the ring, frames the CPU may run ahead of the GPU
+    static constexpr uint32_t FrameCount = 3;
+
+    static constexpr uint32_t InitialObjects  = 1024;
+    static constexpr uint32_t InitialCommands = 4096;
+
+    ObjectBuffer() = default;
+    ~ObjectBuffer() { Destroy(); }
+
+    ObjectBuffer(const ObjectBuffer &) = delete;
+    ObjectBuffer &operator=(const ObjectBuffer &) = delete;
+
+    /// Create and map both rings.
+    void Create(uint32_t objects = InitialObjects, uint32_t commands = InitialCommands);
+    void Destroy();
+
+    /**
+     * @brief Move to the next segment, waiting until the GPU finished the frame that used it last.
+     *
+     * Binds the segment to Binding, so indices returned by Push() start at 0 every frame.
+     */
+    void BeginFrame();
+    /// Fence the segment written this frame.
+    void EndFrame();
+
+    /**
+     * @brief Append the data of one object to the current segment, growing the ring when it is full.
+     * @return Index of the object, the base instance of its draws.
+     */
+    uint32_t Push(const ObjectData &data);
+
+    /**
+     * @brief Reserve indirect commands in the current segment.
+     * @param count       Number of commands.
+     * @param[out] offset Byte offset of the first command in CommandBuffer().
+     * @return Commands to fill before the draw that reads them.
+     */
+    DrawElementsIndirectCommand *PushCommands(uint32_t count, GLintptr &offset);
+
+    [[nodiscard]] GLuint CommandBuffer() const { return _commands.buffer; }
+    [[nodiscard]] uint32_t ObjectCount() const { return _objects.count; }
+    [[nodiscard]] uint32_t ObjectCapacity() const { return _objects.capacity; }
+    [[nodiscard]] uint64_t Waits() const { return _waits; }
+
+private:
+    /**
+     * @struct Ring
+     * @brief One persistently mapped buffer of FrameCount equal segments.
+     */
+    struct Ring
+    {
+        GLuint    buffer   = 0;
+        uint8_t  *mapped   = nullptr;
+        uint32_t  stride   = 0; ///< bytes per element
+        uint32_t  capacity = 0; ///< elements per segment
+        size_t    segment  = 0; ///< bytes per segment, aligned
+        uint32_t  count    = 0; ///< elements written to the current segment
+
+        void Create(uint32_t elementStride, uint32_t elements, size_t alignment);
+        void Destroy();
+        /// Replace by a ring of twice the capacity, keeping the elements of the current frame.
+        void Grow(uint32_t frame, size_t alignment);
+        [[nodiscard]] uint8_t *Element(uint32_t frame, uint32_t index) const { return mapped + frame * segment + static_cast<size_t>(index) * stride; }
+    };
+
+    void BindObjects() const;
+
+    Ring _objects;
+    Ring _commands;
+
+    uint32_t _frame = 0;
+    GLsync   _fences[FrameCount] = {};
+    size_t   _alignment = 256; ///< GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT
+
+    uint64_t _waits = 0; ///< BeginFrame() calls that found their segment still in use
+};
@@ -9,7 +9,15 @@
  *  and one of several renderable types (Mesh, Box, Icosphere, CubeMap, Water,
  *  Fire, Cat). It provides a unified Render() method that dispatches to the
  *  appropriate type-specific rendering routine, handling shader binding,
- *  VAO setup, and material or texture parameters.
+ *  VAO setup, and material or texture parameters. Per object matrices and
+ *  flags are written once per frame into the ObjectBuffer and every draw
+ *  selects them through its base instance plus its instance. Boxes and
+ *  spheres sharing their geometry with the objects written after them draw
+ *  all of them in one instanced draw, scene meshes of the geometry arena
+ *  go out together as one multi-draw indirect. Pipeline state, program,
+ *  vertex array and texture changes go through GLState, so only the
+ *  differences between consecutive draws reach the driver. Picking casts
+ *  rays against the object space triangles of the objects on the CPU.
  *
  */
 //----------------------------------------------------------------------------------------
@@ -26,6 +34,10 @@
 
 #include "../Components/MeshRenderer.h"
 #include "../Components/Transform.h"
+#include "../Resources/Shader/ShaderVariants.h"
+#include "../Renderer/GLState.h"
+#include "../Renderer/RenderQueue.h"
+#include "ObjectBuffer.h"
 
 /**
  * @class RenderObject
@@ -100,24 +112,211 @@ public:
         return _type;
     }
 
+    /// Shader features the object is drawn with, see ShaderVariants::Feature.
+    [[nodiscard]] ShaderVariants::Key Features() const
+    {
+        switch (_type)
+        {
+            case Type::CubeMap:
+                return ShaderVariants::Skybox;
+            case Type::Fire:
+                return ShaderVariants::FireSprite;
+            case Type::Box:
+                return Box::useTexture ? ShaderVariants::Textured : ShaderVariants::None;
+            case Type::Sphere:
+                return _sphere.useTexture ? ShaderVariants::Textured : ShaderVariants::None;
+            case Type::CatType:
+                return Cat::useTexture ? ShaderVariants::Textured : ShaderVariants::None;
+            default:
+                return ShaderVariants::None;
+        }
+    }
+
+    /// Pass of the render queue the object is drawn in.
+    [[nodiscard]] RenderQueue::Pass Pass() const
+    {
+        if (_type == Type::CubeMap)
+            return RenderQueue::Pass::Sky;
+        if (_type == Type::Water || _type == Type::Fire || _useAlpha)
+            return RenderQueue::Pass::Transparent;
+        return RenderQueue::Pass::Opaque;
+    }
+    /// Vertex array the object is drawn from, shared by all meshes of one geometry arena.
+    [[nodiscard]] GLuint VertexArray() const
+    {
+        switch (_type)
+        {
+            case Type::Mesh:
+                return _renderer->GetMesh().VAO();
+            case Type::Box:
+                return Box::VAO;
+            case Type::Sphere:
+                return _sphere.VAO;
+            case Type::CubeMap:
+                return _cubemap.VAO;
+            case Type::Water:
+                return _water.VAO;
+            case Type::Fire:
+                return _fire.VAO;
+            case Type::CatType:
+                return Cat::VAO;
+            default:
+                return 0;
+        }
+    }
+    /// World position the render queue orders the object by, the center of the geometry for scene meshes.
+    [[nodiscard]] glm::vec3 Position() const
+    {
+        if (_type == Type::Mesh)
+            return glm::vec3(_transform.GetMatrix() * glm::vec4(_renderer->GetMesh().Lods().center, 1.0f));
+        return _transform.GetWorldPosition();
+    }
+    /// World space bounds for frustum culling, empty for the skybox, which is never culled.
+    [[nodiscard]] Bounds WorldBounds() const
+    {
+        const Bounds *local = nullptr;
+        switch (_type)
+        {
+            case Type::Mesh:    local = &_renderer->GetMesh().LocalBounds(); break;
+            case Type::Box:     local = &Box::bounds; break;
+            case Type::Sphere:  local = &_sphere.bounds; break;
+            case Type::Water:   local = &_water.bounds; break;
+            case Type::Fire:    local = &_fire.bounds; break;
+            case Type::CatType: local = &Cat::bounds; break;
+            default:            return {};
+        }
+        return local->Transformed(_transform.GetMatrix());
+    }
+    /**
+     * @brief Intersect a world space ray with the triangles the object is drawn with.
+     * @param origin    Start of the ray.
+     * @param direction Direction of the ray, distances are multiples of its length.
+     * @param[in,out] distance Hits at or beyond it are ignored, set to the nearest hit found.
+     * @return True if a front face was hit before distance.
+     *
+     * Only the faces the scene pass draws count, like in the stencil picking: back faces are culled, and the
+     * skybox and the water, which write no stencil, are never hit. Meshes and the cat are tested at full detail.
+     */
+    [[nodiscard]] bool Raycast(const glm::vec3 &origin, const glm::vec3 &direction, float &distance) const
+    {
+        if (_type == Type::CubeMap || _type == Type::Water)
+            return false;
+
+        // The object space ray keeps the distances of the world space one
+        glm::vec3 localOrigin = origin, localDirection = direction;
+        const TriangleBvh::Faces faces = TriangleBvh::ToObjectSpace(_transform.GetMatrix(), localOrigin, localDirection);
+
+        switch (_type)
+        {
+            case Type::Mesh:    return _renderer->GetMesh().Triangles().Raycast(localOrigin, localDirection, distance, faces);
+            case Type::Box:     return Box::triangles.Raycast(localOrigin, localDirection, distance, faces);
+            case Type::Sphere:  return _sphere.Raycast(localOrigin, localDirection, distance, faces);
+            case Type::Fire:    return _fire.triangles.Raycast(localOrigin, localDirection, distance, faces);
+            case Type::CatType: return Cat::triangles.Raycast(localOrigin, localDirection, distance, faces);
+            default:            return false;
+        }
+    }
+    /// Material of a scene mesh, see MaterialPGR::Index(), 0 for the other types.
+    [[nodiscard]] uint32_t MaterialIndex() const
+    {
+        return _type == Type::Mesh && _renderer->GetMaterial() ? _renderer->GetMaterial()->Index() : 0;
+    }
+
+    /// Blend the object with the given alpha, see ObjectData::alpha.
+    void SetAlpha(const float alpha)
+    {
+        _useAlpha = true;
+        _alpha = alpha;
+    }
+
+    /// Object buffer that the meshlet multi-draws reserve their indirect commands in.
+    static void SetObjectBuffer(ObjectBuffer &buffer)
+    {
+        _objectBuffer = &buffer;
+    }
+
+    /**
+     * @brief Advance the animations driven by the object itself, once per frame before WriteObjectData().
+     */
+    void Animate()
+    {
+        if (_type == Type::CatType && Cat::isMoving)
+            UpdateCirclePosition(_transform, 0.5f, 1.0f);
+        else if (_type == Type::Sphere && Icosphere::useToSphere)
+            Icosphere::lastDynamicScale += 0.01;
+    }
+
+    /**
+     * @brief Write the matrices and flags of this frame into the object buffer.
+     * @param buffer Buffer in the current frame, see ObjectBuffer::BeginFrame().
+     *
+     * Every draw of the object passes the returned index as its base instance until the next call,
+     * re-renders of the same frame (highlight, picking) reuse it.
+     */
+    void WriteObjectData(ObjectBuffer &buffer)
+    {
+        ObjectData data;
+        data.SetModel(_transform.GetMatrix());
+        data.useAlpha = _useAlpha;
+        data.alpha = _alpha;
+
+        switch (_type)
+        {
+            case Type::Mesh:
+            {
+                const Mesh &M = _renderer->GetMesh();
+                data.materialIndex = _renderer->GetMaterial() ? _renderer->GetMaterial()->Index() : 0;
+                data.useQuantization = M.IsQuantized();
+                if (M.IsQuantized())
+                {
+                    data.positionScale = M.Quantization().scale;
+                    data.positionOffset = M.Quantization().offset;
+                }
+                break;
+            }
+            case Type::Box:
+                data.useTexture = Box::useTexture;
+                break;
+            case Type::Sphere:
+                data.useTexture = _sphere.useTexture;
+                data.useToSphere = true;
+                data.alphaToSphere = glm::sin(Icosphere::lastDynamicScale);
+                break;
+            case Type::CubeMap:
+                data.useTexture = _cubemap.useTexture;
+                break;
+            case Type::CatType:
+                data.useTexture = Cat::useTexture;
+                break;
+            default:
+                break;
+        }
+
+        _objectIndex = buffer.Push(data);
+    }
+
     /**
      * @brief Render the object with the provided shader.
-     * @param shader Shader to bind and use for drawing.
+     * @param shader    Shader to bind and use for drawing.
+     * @param pass      Pipeline state of the pass, the object applies its own variant of it.
+     * @param instances Objects drawn by one instanced draw, this one and the following ones CanInstance() accepted.
      *
      * Delegates to the specific Render method based on Type.
      */
-    void Render(const Shader &shader)
+    void Render(const Shader &shader, const PipelineState &pass = Pipelines::Scene, const GLsizei instances = 1)
     {
+        GLState::Apply(Pipeline(pass));
+
         switch (_type)
         {
             case Type::Mesh:
                 RenderMesh(shader);
                 break;
             case Type::Box:
-                RenderBox(shader);
+                RenderBox(shader, instances);
                 break;
             case Type::Sphere:
-                RenderSphere(shader);
+                RenderSphere(shader, instances);
                 break;
             case Type::CubeMap:
                 RenderCubeMap(shader);
@@ -136,131 +335,201 @@ public:
         }
     }
 
+    /**
+     * @brief Whether other can be drawn as instance number instance of an instanced draw of this object.
+     *
+     * Instances share the geometry, textures, program and pass, and their object data follows the data
+     * of this object in the object buffer, which holds for objects written in render queue order.
+     */
+    [[nodiscard]] bool CanInstance(const RenderObject &other, const GLsizei instance) const
+    {
+        if (_type != other._type || Pass() != other.Pass() || other._objectIndex != _objectIndex + static_cast<uint32_t>(instance))
+            return false;
+
+        switch (_type)
+        {
+            case Type::Box:
+                return true;
+            case Type::Sphere:
+                return _sphere.VAO == other._sphere.VAO && _sphere.textureDiffID == other._sphere.textureDiffID &&
+                       _sphere.textureSpecID == other._sphere.textureSpecID && _sphere.useTexture == other._sphere.useTexture;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief Whether other can go into the same multi-draw as this Mesh object.
+     *
+     * The meshes of the geometry arena share their vertex array and index buffer, so a batch only needs
+     * the same pass, shader features and index type. Materials come from the material buffer, without it
+     * they split batches too.
+     */
+    [[nodiscard]] bool CanMultiDraw(const RenderObject &other) const
+    {
+        if (_type != Type::Mesh || other._type != Type::Mesh || Pass() != other.Pass() || Features() != other.Features())
+            return false;
+
+        const Mesh &mesh = _renderer->GetMesh();
+        const Mesh &otherMesh = other._renderer->GetMesh();
+        if (!mesh.IsIndexed() || !otherMesh.IsIndexed() || mesh.VAO() != otherMesh.VAO() || mesh.IndexType() != otherMesh.IndexType())
+            return false;
+#ifndef IMPL_MATERIAL_BUFFER
+        if (_renderer->GetMaterial() != other._renderer->GetMaterial())
+            return false;
+#endif
+        return true;
+    }
+
+    /**
+     * @brief Draw Mesh objects CanMultiDraw() accepted with one multi-draw indirect.
+     * @param shader  Program of the first object, shared by the batch.
+     * @param objects Batch in draw order, the first one binds the program and the vertex array.
+     * @param pass    Pipeline state of the pass.
+     */
+    static void RenderMeshes(const Shader &shader, const std::vector<RenderObject*> &objects, const PipelineState &pass = Pipelines::Scene)
+    {
+        if (objects.empty())
+            return;
+
+        const RenderObject &first = *objects.front();
+        GLState::Apply(first.Pipeline(pass));
+        first._renderer->Bind(shader);
+        const Mesh &mesh = first._renderer->GetMesh();
+        GLState::BindVertexArray(mesh.VAO());
+
+        _commands.clear();
+        for (const RenderObject *object : objects)
+            object->AppendCommands(_commands);
+        SubmitCommands(mesh.IndexType(), _commands);
+    }
+
+    /**
+     * @brief Pipeline state this object draws with in a pass.
+     *
+     * The skybox and the water are drawn without writing depth or stencil,
+     * so they neither hide nor get picked in place of the objects behind them.
+     */
+    [[nodiscard]] PipelineState Pipeline(const PipelineState &pass) const
+    {
+        PipelineState state = pass;
+        if (_type == Type::CubeMap || _type == Type::Water)
+        {
+            state.depthWrite       = false;
+            state.stencilWriteMask = 0x00;
+        }
+        return state;
+    }
+
+    /**
+     * @brief Set the camera that meshlets of Mesh objects are culled against and levels of detail are selected for.
+     * @param viewProjection Projection * view matrix of the camera.
+     * @param eye            World position of the camera.
+     * @param pixelScale     Pixels per unit at distance one, see MeshSimplifier::PixelScale(); 0 always draws the full mesh.
+     */
+    static void SetCullCamera(const glm::mat4 &viewProjection, const glm::vec3 &eye, const float pixelScale = 0.0f)
+    {
+        _cullViewProjection = viewProjection;
+        _cullEye = eye;
+        _cullEnabled = true;
+        _lodPixelScale = pixelScale;
+    }
+
+    /// Level of detail of a chain for an object with the given model matrix as seen from the cull camera.
+    static uint32_t SelectLod(const LodChain &lods, const glm::mat4 &model)
+    {
+        if (!_cullEnabled || _lodPixelScale <= 0.0f || lods.levels.size() < 2)
+            return 0;
+        const glm::vec3 eye = glm::vec3(glm::inverse(model) * glm::vec4(_cullEye, 1.0f));
+        return lods.Select(eye, _lodPixelScale, LodPixelError);
+    }
+
     void RenderMesh(const Shader &shader) const
     {
         auto &R = *_renderer;
         R.Bind(shader);
-        Shader::SetMat4(shader._utils.ModelM,
-                        _transform.GetMatrix());
         auto &M = R.GetMesh();
-        glBindVertexArray(M.VAO());
+
+        GLState::BindVertexArray(M.VAO());
         if (M.IsIndexed())
-            glDrawElements(GL_TRIANGLES, M.IndexCount(),
-                           GL_UNSIGNED_INT, nullptr);
+        {
+            _commands.clear();
+            AppendCommands(_commands);
+            SubmitCommands(M.IndexType(), _commands);
+        }
         else
-            glDrawArrays(GL_TRIANGLES, 0, M.VertexCount());
+            glDrawArraysInstancedBaseInstance(GL_TRIANGLES, M.BaseVertex(), M.VertexCount(), 1, _objectIndex);
     }
-    void RenderBox(const Shader &shader)
+    void RenderBox(const Shader &shader, const GLsizei instances)
     {
         Shader::Bind(shader);
         // Connect box VAO
-        glBindVertexArray(Box::VAO);
+        GLState::BindVertexArray(Box::VAO);
 
         // Set textures
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, Box::textureDiffID);
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, Box::textureSpecID);
-
-        Shader::SetInt(shader._utils.useTexture, Box::useTexture);
-        Shader::SetMat4(shader._utils.ModelM, _transform.GetMatrix());
-
-        glDrawArrays(GL_TRIANGLES, 0, Box::vertexCount);
+        GLState::BindTexture(1, Box::textureDiffID);
+        GLState::BindTexture(2, Box::textureSpecID);
 
-        Shader::SetInt(shader._utils.useAlpha, false);
-        Shader::SetFloat(shader._utils.alpha, 1.0f);
-
-        // Reset texture using
-        Shader::SetInt(shader._utils.useTexture, !Box::useTexture);
-        glBindVertexArray(0);
+        glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, Box::vertexCount, instances, _objectIndex);
     }
-    void RenderSphere(const Shader &shader)
+    void RenderSphere(const Shader &shader, const GLsizei instances)
     {
         Shader::Bind(shader);
 
         // Connect sphere VAO
-        glBindVertexArray(_sphere.VAO);
-
-        // Set uniforms
-        Shader::SetMat4(shader._utils.ModelM, _transform.GetMatrix());
-        Shader::SetInt(shader._utils.useTexture, _sphere.useTexture);
-        Shader::SetInt(shader._utils.useToSphere, true);
-        if (Icosphere::useToSphere)
-        {
-            Icosphere::lastDynamicScale += 0.01;
-            Shader::SetFloat(shader._utils.alphaToSphere, glm::sin(Icosphere::lastDynamicScale));
-        }
+        GLState::BindVertexArray(_sphere.VAO);
 
         // Set textures
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, _sphere.textureDiffID);
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, _sphere.textureSpecID);
-
-        // Draw sphere
-        glDrawArrays(GL_TRIANGLES, 0, _sphere.vertexCount);
+        GLState::BindTexture(1, _sphere.textureDiffID);
+        GLState::BindTexture(2, _sphere.textureSpecID);
 
-        Shader::SetInt(shader._utils.useTexture, false);
-        Shader::SetInt(shader._utils.useToSphere, false);
-        glBindVertexArray(0);
+        // Draw sphere, morphed by its object data
+        glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, _sphere.vertexCount, instances, _objectIndex);
     }
     void RenderCubeMap(const Shader &shader)
     {
         Shader::Bind(shader);
 
         // Connect cube map VAO
-        glBindVertexArray(_cubemap.VAO);
+        GLState::BindVertexArray(_cubemap.VAO);
 
         // Set uniforms
         Shader::SetInt(shader._utils.useCubeMap, true);
-        Shader::SetInt(shader._utils.useTexture, _cubemap.useTexture);
-        Shader::SetMat4(shader._utils.ModelM, _transform.GetMatrix());
-        glDepthMask(GL_FALSE);
-        glStencilMask(0x00);
 
         // Set textures
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, _cubemap.textureDiffID);
-        glDrawArrays(GL_TRIANGLES, 0, _cubemap.vertexCount);
+        GLState::BindTexture(0, _cubemap.textureDiffID);
+        glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, _cubemap.vertexCount, 1, _objectIndex);
 
         // Reset uniforms
         Shader::SetInt(shader._utils.useCubeMap, false);
-        glDepthMask(GL_TRUE);
-        glStencilMask(0xFF);
-
-        glBindVertexArray(0);
     }
     void RenderWater(const Shader &shader)
     {
-        Shader::Bind(shader);
-
-        const double t = glfwGetTime();
-        Shader::SetFloat(shader._water.Time, static_cast<float>(t));
-
-        _water.Render(shader);
+        // Time comes from the frame uniform block
+        _water.Render(shader, _objectIndex);
     }
     void RenderFire(const Shader &shader)
     {
-        Shader::SetMat4(shader._utils.ModelM, _transform.GetMatrix());
-        _fire.Render(shader);
+        _fire.Render(shader, _objectIndex);
     }
     void RenderCat(const Shader &shader)
     {
         Shader::Bind(shader);
 
         // Connect cat VAO
-        glBindVertexArray(Cat::VAO);
+        GLState::BindVertexArray(Cat::VAO);
 
-        // Set uniforms
-        if (Cat::isMoving) UpdateCirclePosition(_transform, 0.5f, 1.0f);
-        Shader::SetMat4(shader._utils.ModelM, _transform.GetMatrix());
-        Shader::SetInt(shader._utils.useTexture, Cat::useTexture);
         // material.ApplyValues(); // Bronze
 
-        // Draw cat
-        glDrawArrays(GL_TRIANGLES, 0, Cat::vertexCount);
-
-        glBindVertexArray(0);
+        // Draw cat, simplified when far away
+#ifdef IMPL_MESH_LOD
+        const MeshLod &level = Cat::lods.levels.empty() ? MeshLod{0, Cat::indexCount, 0.0f}
+                                                         : Cat::lods.levels[SelectLod(Cat::lods, _transform.GetMatrix())];
+        glDrawElementsInstancedBaseInstance(GL_TRIANGLES, level.indexCount, GL_UNSIGNED_INT,
+                                            (void*)(level.indexOffset * sizeof(unsigned int)), 1, _objectIndex);
+#else
+        glDrawElementsInstancedBaseInstance(GL_TRIANGLES, Cat::indexCount, GL_UNSIGNED_INT, nullptr, 1, _objectIndex);
+#endif
     }
 
     /**
@@ -293,6 +562,69 @@ public:
         transform.SetRotation(rotation);
     }
 private:
+    /**
+     * @brief Append the draws of an indexed Mesh object, every command carries the object index as base instance.
+     *
+     * Distant objects draw one simplified index range, culled meshes one command per visible meshlet
+     * and all others the full index range.
+     */
+    void AppendCommands(std::vector<DrawElementsIndirectCommand> &commands) const
+    {
+        const Mesh &M = _renderer->GetMesh();
+        const glm::mat4 model = _transform.GetMatrix();
+        const uint32_t indexSize = M.IndexType() == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+        const uint32_t firstIndex = static_cast<uint32_t>(M.IndexByteOffset() / indexSize);
+#ifdef IMPL_MESH_LOD
+        const uint32_t lod = SelectLod(M.Lods(), model);
+        if (lod > 0)
+        {
+            const MeshLod &level = M.Lods().levels[lod];
+            commands.push_back({level.indexCount, 1, firstIndex + level.indexOffset, M.BaseVertex(), _objectIndex});
+            return;
+        }
+#endif
+#ifdef IMPL_MESH_MESHLETS
+        if (_cullEnabled && !M.Meshlets().empty())
+        {
+            // only the meshlets inside the frustum and facing the camera
+            const glm::vec3 eye = glm::vec3(glm::inverse(model) * glm::vec4(_cullEye, 1.0f));
+            M.CullMeshlets(Frustum(_cullViewProjection * model), eye, _drawRanges);
+            for (GLsizei i = 0; i < _drawRanges.Size(); i++)
+            {
+                commands.push_back({static_cast<uint32_t>(_drawRanges.counts[i]), 1,
+                                    static_cast<uint32_t>(reinterpret_cast<uintptr_t>(_drawRanges.offsets[i]) / indexSize),
+                                    _drawRanges.baseVertices[i], _objectIndex});
+            }
+            return;
+        }
+#endif
+        commands.push_back({M.IndexCount(), 1, firstIndex, M.BaseVertex(), _objectIndex});
+    }
+
+    /// Draw the commands, a single one directly and more through the command buffer with one multi-draw.
+    static void SubmitCommands(const GLenum indexType, const std::vector<DrawElementsIndirectCommand> &commands)
+    {
+        if (commands.empty())
+            return;
+
+        const size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+        if (commands.size() == 1)
+        {
+            const DrawElementsIndirectCommand &command = commands.front();
+            glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(command.count), indexType,
+                                                          (void*)(command.firstIndex * indexSize), command.instanceCount,
+                                                          command.baseVertex, command.baseInstance);
+            return;
+        }
+
+        GLintptr offset = 0;
+        const auto count = static_cast<uint32_t>(commands.size());
+        std::memcpy(_objectBuffer->PushCommands(count, offset), commands.data(), count * sizeof(DrawElementsIndirectCommand));
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _objectBuffer->CommandBuffer());
+        glMultiDrawElementsIndirect(GL_TRIANGLES, indexType, (void*)offset, static_cast<GLsizei>(count), 0);
+    }
+
     Transform _transform;
     MeshRenderer*  _renderer = nullptr;
 
@@ -304,4 +636,21 @@ private:
     Cat _cat;
 
     Type _type;
+
+    // Per draw data
+    bool  _useAlpha = false;
+    float _alpha = 1.0f;
+    uint32_t _objectIndex = 0; ///< element of the object buffer written this frame
+    inline static ObjectBuffer *_objectBuffer = nullptr;
+
+    // Meshlet culling
+    inline static glm::mat4 _cullViewProjection = glm::mat4(1.0f);
+    inline static glm::vec3 _cullEye = glm::vec3(0.0f);
+    inline static bool _cullEnabled = false;
+    inline static DrawRanges _drawRanges;
+    inline static std::vector<DrawElementsIndirectCommand> _commands; ///< scratch of RenderMesh() and RenderMeshes()
+
+    // Level of detail selection
+    static constexpr float LodPixelError = 1.0f; ///< allowed screen-space error in pixels
+    inline static float _lodPixelScale = 0.0f;
 };
@@ -0,0 +1,237 @@
+#include "FrustumCuller.h"
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FRUSTUM_CULLER_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FRUSTUM_CULLER_SSE2
+#endif
+
+#if defined(FRUSTUM_CULLER_AVX2)
+const FrustumCuller::Kernel FrustumCuller::Best = Kernel::AVX2;
+#elif defined(FRUSTUM_CULLER_SSE2)
+const FrustumCuller::Kernel FrustumCuller::Best = Kernel::SSE2;
+#else
+const FrustumCuller::Kernel FrustumCuller::Best = Kernel::Scalar;
+#endif
+
+namespace
+{
+    /// Half size of empty bounds, no plane or pixel threshold rejects them
+    constexpr float Unbounded = 1e30f;
+
+    /// Lane masks of one block to bytes, 1 where neither outside nor small
+    void StoreVisible(uint8_t *visible, uint32_t culledMask, uint32_t lanes)
+    {
+        for (uint32_t lane = 0; lane < lanes; lane++)
+            visible[lane] = (culledMask >> lane & 1) == 0;
+    }
+}
+
+const char *FrustumCuller::Name(Kernel kernel)
+{
+    switch (kernel)
+    {
+        case Kernel::SSE2: return "SSE2";
+        case Kernel::AVX2: return "AVX2";
+        default: return "scalar";
+    }
+}
+
+void FrustumCuller::Clear()
+{
+    _count = 0;
+}
+
+uint32_t FrustumCuller::Add(const Bounds &bounds)
+{
+    // Grow by whole blocks, so kernels read full lanes past the last slot
+    if (_count == _centerX.size())
+    {
+        const size_t capacity = std::max<size_t>(Lanes, _centerX.size() * 2);
+        for (std::vector<float> *array : {&_centerX, &_centerY, &_centerZ, &_extentX, &_extentY, &_extentZ,
+                                          &_sphereX, &_sphereY, &_sphereZ, &_radius})
+            array->resize(capacity, 0.0f);
+        _visible.resize(capacity);
+    }
+
+    const bool empty = bounds.Empty();
+    const glm::vec3 center = empty ? glm::vec3(0.0f) : bounds.Center();
+    const glm::vec3 extents = empty ? glm::vec3(Unbounded) : bounds.Extents();
+    _centerX[_count] = center.x;
+    _centerY[_count] = center.y;
+    _centerZ[_count] = center.z;
+    _extentX[_count] = extents.x;
+    _extentY[_count] = extents.y;
+    _extentZ[_count] = extents.z;
+    _sphereX[_count] = bounds.center.x;
+    _sphereY[_count] = bounds.center.y;
+    _sphereZ[_count] = bounds.center.z;
+    _radius[_count]  = empty ? Unbounded : bounds.radius;
+    return _count++;
+}
+
+void FrustumCuller::Cull(const Frustum &frustum, float pixelScale, float minPixels, Kernel kernel)
+{
+    _stats = {};
+    if (_count == 0)
+        return;
+
+    // Without a pixel scale nothing is too small: 0 < 0 never holds
+    if (pixelScale <= 0.0f)
+        pixelScale = minPixels = 0.0f;
+
+#ifdef FRUSTUM_CULLER_AVX2
+    if (kernel == Kernel::AVX2)
+    {
+        CullAVX2(frustum, pixelScale, minPixels);
+        return;
+    }
+#endif
+#ifdef FRUSTUM_CULLER_SSE2
+    if (kernel != Kernel::Scalar)
+    {
+        CullSSE2(frustum, pixelScale, minPixels);
+        return;
+    }
+#endif
+    CullScalar(frustum, pixelScale, minPixels);
+}
+
+void FrustumCuller::CullScalar(const Frustum &frustum, float pixelScale, float minPixels)
+{
+    const std::array<glm::vec4, 6> &planes = frustum.Planes();
+    const glm::vec4 &nearPlane = planes[4];
+    for (uint32_t i = 0; i < _count; i++)
+    {
+        bool outside = false;
+        for (const glm::vec4 &plane : planes)
+        {
+            // Signed distance of the box center plus the box projected onto the plane normal
+            const float distance = plane.x * _centerX[i] + plane.y * _centerY[i] + plane.z * _centerZ[i] + plane.w;
+            const float reach = std::abs(plane.x) * _extentX[i] + std::abs(plane.y) * _extentY[i] + std::abs(plane.z) * _extentZ[i];
+            outside |= distance + reach < 0.0f;
+        }
+
+        // Diameter * pixelScale / depth < minPixels, multiplied out; depth behind the near plane never passes
+        const float depth = nearPlane.x * _sphereX[i] + nearPlane.y * _sphereY[i] + nearPlane.z * _sphereZ[i] + nearPlane.w;
+        const bool small = !outside && 2.0f * _radius[i] * pixelScale < minPixels * depth;
+
+        _visible[i] = !outside && !small;
+        _stats.outside += outside;
+        _stats.belowPixels += small;
+    }
+    _stats.visible = _count - _stats.outside - _stats.belowPixels;
+}
+
+#ifdef FRUSTUM_CULLER_SSE2
+void FrustumCuller::CullSSE2(const Frustum &frustum, float pixelScale, float minPixels)
+{
+    const std::array<glm::vec4, 6> &planes = frustum.Planes();
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 nx[6], ny[6], nz[6], nw[6], ax[6], ay[6], az[6];
+    for (int p = 0; p < 6; p++)
+    {
+        nx[p] = _mm_set1_ps(planes[p].x);
+        ny[p] = _mm_set1_ps(planes[p].y);
+        nz[p] = _mm_set1_ps(planes[p].z);
+        nw[p] = _mm_set1_ps(planes[p].w);
+        ax[p] = _mm_andnot_ps(signMask, nx[p]);
+        ay[p] = _mm_andnot_ps(signMask, ny[p]);
+        az[p] = _mm_andnot_ps(signMask, nz[p]);
+    }
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 diameterScale = _mm_set1_ps(2.0f * pixelScale);
+    const __m128 threshold = _mm_set1_ps(minPixels);
+
+    uint32_t outsideCount = 0, smallCount = 0;
+    for (uint32_t i = 0; i < _count; i += 4)
+    {
+        const __m128 cx = _mm_loadu_ps(&_centerX[i]), cy = _mm_loadu_ps(&_centerY[i]), cz = _mm_loadu_ps(&_centerZ[i]);
+        const __m128 ex = _mm_loadu_ps(&_extentX[i]), ey = _mm_loadu_ps(&_extentY[i]), ez = _mm_loadu_ps(&_extentZ[i]);
+
+        __m128 outside = zero;
+        for (int p = 0; p < 6; p++)
+        {
+            const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)), _mm_mul_ps(nz[p], cz)), nw[p]);
+            const __m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey)), _mm_mul_ps(az[p], ez));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, reach), zero));
+        }
+
+        const __m128 sx = _mm_loadu_ps(&_sphereX[i]), sy = _mm_loadu_ps(&_sphereY[i]), sz = _mm_loadu_ps(&_sphereZ[i]);
+        const __m128 depth = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[4], sx), _mm_mul_ps(ny[4], sy)), _mm_mul_ps(nz[4], sz)), nw[4]);
+        const __m128 small = _mm_andnot_ps(outside, _mm_cmplt_ps(_mm_mul_ps(diameterScale, _mm_loadu_ps(&_radius[i])), _mm_mul_ps(threshold, depth)));
+
+        const uint32_t lanes = std::min(4u, _count - i);
+        const uint32_t valid = (1u << lanes) - 1;
+        const uint32_t outsideMask = static_cast<uint32_t>(_mm_movemask_ps(outside)) & valid;
+        const uint32_t smallMask = static_cast<uint32_t>(_mm_movemask_ps(small)) & valid;
+        StoreVisible(&_visible[i], outsideMask | smallMask, lanes);
+        outsideCount += std::popcount(outsideMask);
+        smallCount += std::popcount(smallMask);
+    }
+
+    _stats.outside = outsideCount;
+    _stats.belowPixels = smallCount;
+    _stats.visible = _count - outsideCount - smallCount;
+}
+#endif
+
+#ifdef FRUSTUM_CULLER_AVX2
+void FrustumCuller::CullAVX2(const Frustum &frustum, float pixelScale, float minPixels)
+{
+    const std::array<glm::vec4, 6> &planes = frustum.Planes();
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 nx[6], ny[6], nz[6], nw[6], ax[6], ay[6], az[6];
+    for (int p = 0; p < 6; p++)
+    {
+        nx[p] = _mm256_set1_ps(planes[p].x);
+        ny[p] = _mm256_set1_ps(planes[p].y);
+        nz[p] = _mm256_set1_ps(planes[p].z);
+        nw[p] = _mm256_set1_ps(planes[p].w);
+        ax[p] = _mm256_andnot_ps(signMask, nx[p]);
+        ay[p] = _mm256_andnot_ps(signMask, ny[p]);
+        az[p] = _mm256_andnot_ps(signMask, nz[p]);
+    }
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 diameterScale = _mm256_set1_ps(2.0f * pixelScale);
+    const __m256 threshold = _mm256_set1_ps(minPixels);
+
+    uint32_t outsideCount = 0, smallCount = 0;
+    for (uint32_t i = 0; i < _count; i += 8)
+    {
+        const __m256 cx = _mm256_loadu_ps(&_centerX[i]), cy = _mm256_loadu_ps(&_centerY[i]), cz = _mm256_loadu_ps(&_centerZ[i]);
+        const __m256 ex = _mm256_loadu_ps(&_extentX[i]), ey = _mm256_loadu_ps(&_extentY[i]), ez = _mm256_loadu_ps(&_extentZ[i]);
+
+        __m256 outside = zero;
+        for (int p = 0; p < 6; p++)
+        {
+            const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[p], cx), _mm256_mul_ps(ny[p], cy)),
+                                                                _mm256_mul_ps(nz[p], cz)), nw[p]);
+            const __m256 reach = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax[p], ex), _mm256_mul_ps(ay[p], ey)), _mm256_mul_ps(az[p], ez));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, reach), zero, _CMP_LT_OQ));
+        }
+
+        const __m256 sx = _mm256_loadu_ps(&_sphereX[i]), sy = _mm256_loadu_ps(&_sphereY[i]), sz = _mm256_loadu_ps(&_sphereZ[i]);
+        const __m256 depth = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[4], sx), _mm256_mul_ps(ny[4], sy)),
+                                                         _mm256_mul_ps(nz[4], sz)), nw[4]);
+        const __m256 small = _mm256_andnot_ps(outside, _mm256_cmp_ps(_mm256_mul_ps(diameterScale, _mm256_loadu_ps(&_radius[i])),
+                                                                     _mm256_mul_ps(threshold, depth), _CMP_LT_OQ));
+
+        const uint32_t lanes = std::min(8u, _count - i);
+        const uint32_t valid = (1u << lanes) - 1;
+        const uint32_t outsideMask = static_cast<uint32_t>(_mm256_movemask_ps(outside)) & valid;
+        const uint32_t smallMask = static_cast<uint32_t>(_mm256_movemask_ps(small)) & valid;
+        StoreVisible(&_visible[i], outsideMask | smallMask, lanes);
+        outsideCount += std::popcount(outsideMask);
+        smallCount += std::popcount(smallMask);
+    }
+
+    _stats.outside = outsideCount;
+    _stats.belowPixels = smallCount;
+    _stats.visible = _count - outsideCount - smallCount;
+}
+#endif
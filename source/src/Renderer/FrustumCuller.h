@@ -0,0 +1,86 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       FrustumCuller.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Batched visibility test of world bounds against a camera frustum.
+ *
+ *  This file declares the FrustumCuller class. World bounds are stored as
+ *  structure of arrays, so one kernel pass tests 8 (AVX2), 4 (SSE2) or 1
+ *  (scalar) boxes against the six planes at once. A box is culled if it lies
+ *  outside one plane, or if its bounding sphere projects to fewer pixels than
+ *  the threshold.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "src/Utils/Bounds.h"
+#include "src/Utils/Frustum.h"
+
+// Features
+#define IMPL_FRUSTUM_CULLING
+
+/**
+ * @struct CullStats
+ * @brief Results of the last Cull() call.
+ */
+struct CullStats
+{
+    uint32_t visible     = 0;
+    uint32_t outside     = 0; ///< outside a frustum plane
+    uint32_t belowPixels = 0; ///< inside, but smaller than the pixel threshold
+
+    [[nodiscard]] uint32_t Culled() const { return outside + belowPixels; }
+};
+
+class FrustumCuller
+{
+public:
+    /**
+     * @enum Kernel
+     * @brief Implementations of the plane test, all compiled ones are interchangeable.
+     */
+    enum class Kernel
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+    };
+    /// Widest kernel the build targets, see USE_AVX2 in CMakeLists.txt
+    static const Kernel Best;
+    [[nodiscard]] static const char *Name(Kernel kernel);
+
+    /// Remove all bounds, keeps the memory.
+    void Clear();
+    /// Append world bounds, returns their slot. Empty bounds are always visible.
+    uint32_t Add(const Bounds &bounds);
+
+    /**
+     * @brief Test every slot against a frustum.
+     * @param frustum    World space frustum of the camera.
+     * @param pixelScale Pixels per unit at distance one, see MeshSimplifier::PixelScale(); 0 disables the size test.
+     * @param minPixels  Smallest visible diameter of a bounding sphere in pixels.
+     * @param kernel     Implementation, kernels the build does not target fall back to the next narrower one.
+     */
+    void Cull(const Frustum &frustum, float pixelScale, float minPixels, Kernel kernel = Best);
+
+    [[nodiscard]] bool Visible(uint32_t slot) const { return _visible[slot] != 0; }
+    [[nodiscard]] uint32_t Size() const { return _count; }
+    [[nodiscard]] const CullStats &Stats() const { return _stats; }
+
+private:
+    static constexpr uint32_t Lanes = 8; ///< slots are padded to the widest kernel
+
+    // Kernels, write _visible and _stats; the SIMD ones exist where the build targets them
+    void CullScalar(const Frustum &frustum, float pixelScale, float minPixels);
+    void CullSSE2(const Frustum &frustum, float pixelScale, float minPixels);
+    void CullAVX2(const Frustum &frustum, float pixelScale, float minPixels);
+
+    uint32_t _count = 0;
+    std::vector<float> _centerX, _centerY, _centerZ;    ///< of the boxes
+    std::vector<float> _extentX, _extentY, _extentZ;    ///< half sizes of the boxes
+    std::vector<float> _sphereX, _sphereY, _sphereZ, _radius;
+    std::vector<uint8_t> _visible;
+    CullStats _stats;
+};
@@ -0,0 +1,187 @@
+#include "GLState.h"
+
+uint32_t GLStateCounters::Issued() const
+{
+    uint32_t total = 0;
+    for (const uint32_t count : issued)
+        total += count;
+    return total;
+}
+
+uint32_t GLStateCounters::Filtered() const
+{
+    uint32_t total = 0;
+    for (const uint32_t count : filtered)
+        total += count;
+    return total;
+}
+
+void GLState::BeginFrame()
+{
+    _lastFrame = _frame;
+    _frame     = {};
+
+    // loading meshes and textures binds them directly
+    _vertexArray = Unknown;
+    std::fill(std::begin(_textures), std::end(_textures), Unknown);
+}
+
+void GLState::Invalidate()
+{
+    _program         = Unknown;
+    _programUniforms = nullptr;
+    _vertexArray     = Unknown;
+    std::fill(std::begin(_textures), std::end(_textures), Unknown);
+    _pipelineKnown = false;
+    _uniforms.clear();
+}
+
+void GLState::UseProgram(GLuint program)
+{
+    const bool changed = program != _program;
+    Count(GLStateCounters::Program, changed);
+    if (!changed)
+        return;
+
+    glUseProgram(program);
+    _program         = program;
+    _programUniforms = program ? &_uniforms[program] : nullptr;
+}
+
+void GLState::BindVertexArray(GLuint vertexArray)
+{
+    const bool changed = vertexArray != _vertexArray;
+    Count(GLStateCounters::VertexArray, changed);
+    if (!changed)
+        return;
+
+    glBindVertexArray(vertexArray);
+    _vertexArray = vertexArray;
+}
+
+void GLState::BindTexture(GLuint unit, GLuint texture)
+{
+    if (unit >= TextureUnits)
+    {
+        Count(GLStateCounters::Texture, true);
+        glBindTextureUnit(unit, texture);
+        return;
+    }
+
+    const bool changed = texture != _textures[unit];
+    Count(GLStateCounters::Texture, changed);
+    if (!changed)
+        return;
+
+    glBindTextureUnit(unit, texture);
+    _textures[unit] = texture;
+}
+
+void GLState::Apply(const PipelineState &state)
+{
+    const PipelineState &current = _pipeline;
+    const bool known = _pipelineKnown;
+
+    // Counts one issued or filtered call
+    auto changed = [known](bool differs)
+    {
+        const bool issue = !known || differs;
+        Count(GLStateCounters::Pipeline, issue);
+        return issue;
+    };
+
+    // Depth
+    if (changed(state.depthTest != current.depthTest))
+        Toggle(GL_DEPTH_TEST, state.depthTest);
+    if (changed(state.depthFunc != current.depthFunc))
+        glDepthFunc(state.depthFunc);
+    if (changed(state.depthWrite != current.depthWrite))
+        glDepthMask(state.depthWrite ? GL_TRUE : GL_FALSE);
+
+    // Blend
+    if (changed(state.blend != current.blend))
+        Toggle(GL_BLEND, state.blend);
+    if (changed(state.blendSrc != current.blendSrc || state.blendDst != current.blendDst))
+        glBlendFunc(state.blendSrc, state.blendDst);
+
+    // Rasterizer
+    if (changed(state.cull != current.cull))
+        Toggle(GL_CULL_FACE, state.cull);
+    if (changed(state.cullFace != current.cullFace))
+        glCullFace(state.cullFace);
+    if (changed(state.colorWrite != current.colorWrite))
+    {
+        const GLboolean mask = state.colorWrite ? GL_TRUE : GL_FALSE;
+        glColorMask(mask, mask, mask, mask);
+    }
+
+    // Stencil
+    if (changed(state.stencilTest != current.stencilTest))
+        Toggle(GL_STENCIL_TEST, state.stencilTest);
+    if (changed(state.stencilWriteMask != current.stencilWriteMask))
+        glStencilMask(state.stencilWriteMask);
+    if (changed(state.stencilFunc != current.stencilFunc || state.stencilRef != current.stencilRef ||
+                state.stencilReadMask != current.stencilReadMask))
+        glStencilFunc(state.stencilFunc, state.stencilRef, state.stencilReadMask);
+    if (changed(state.stencilFail != current.stencilFail || state.stencilDepthFail != current.stencilDepthFail ||
+                state.stencilPass != current.stencilPass))
+        glStencilOp(state.stencilFail, state.stencilDepthFail, state.stencilPass);
+
+    _pipeline      = state;
+    _pipelineKnown = true;
+}
+
+bool GLState::UniformChanged(int location, const void *value, size_t size)
+{
+    // GL ignores location -1, uniforms a variant optimized out
+    if (location < 0)
+    {
+        Count(GLStateCounters::Uniform, false);
+        return false;
+    }
+    if (!_programUniforms || size > sizeof(UniformValue::data))
+    {
+        Count(GLStateCounters::Uniform, true);
+        return true;
+    }
+
+    std::vector<UniformValue> &uniforms = *_programUniforms;
+    if (static_cast<size_t>(location) >= uniforms.size())
+        uniforms.resize(location + 1);
+
+    UniformValue &uniform = uniforms[location];
+    const bool changed = uniform.size != size || std::memcmp(uniform.data, value, size) != 0;
+    Count(GLStateCounters::Uniform, changed);
+    if (changed)
+    {
+        uniform.size = static_cast<uint32_t>(size);
+        std::memcpy(uniform.data, value, size);
+    }
+    return changed;
+}
+
+void GLState::ForgetProgram(GLuint program)
+{
+    _uniforms.erase(program);
+    if (program == _program)
+    {
+        _program         = Unknown;
+        _programUniforms = nullptr;
+    }
+}
+
+void GLState::Count(GLStateCounters::Kind kind, bool issued)
+{
+    if (issued)
+        _frame.issued[kind]++;
+    else
+        _frame.filtered[kind]++;
+}
+
+void GLState::Toggle(GLenum capability, bool enabled)
+{
+    if (enabled)
+        glEnable(capability);
+    else
+        glDisable(capability);
+}
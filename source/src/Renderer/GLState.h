@@ -0,0 +1,101 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       GLState.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Shadow of the GL binding, pipeline and uniform state.
+ *
+ *  This file declares the GLState class, a thin cache in front of the GL
+ *  calls the renderer repeats per draw. It remembers the bound program,
+ *  vertex array, textures of every unit, the current PipelineState and the
+ *  last value of each uniform per program, and only forwards calls that
+ *  change something. Issued and filtered calls are counted per frame.
+ *
+ *  Code that binds vertex arrays or textures directly (resource loading)
+ *  stays valid, as BeginFrame() forgets those bindings; programs, pipeline
+ *  state and uniforms must only change through this class.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "PipelineState.h"
+
+// Features
+#define IMPL_GL_STATE_CACHE
+
+/**
+ * @struct GLStateCounters
+ * @brief GL calls forwarded to the driver and calls skipped as redundant, by kind.
+ */
+struct GLStateCounters
+{
+    enum Kind
+    {
+        Program,
+        VertexArray,
+        Texture,
+        Pipeline,
+        Uniform,
+        KindCount
+    };
+
+    uint32_t issued[KindCount]   = {};
+    uint32_t filtered[KindCount] = {};
+
+    [[nodiscard]] uint32_t Issued() const;
+    [[nodiscard]] uint32_t Filtered() const;
+};
+
+class GLState
+{
+public:
+    static constexpr GLuint TextureUnits = 16;
+
+    /// Start counting a new frame and forget the bindings resource loading may have changed.
+    static void BeginFrame();
+    /// Forget everything, the next call of every kind is issued.
+    static void Invalidate();
+
+    static void UseProgram(GLuint program);
+    static void BindVertexArray(GLuint vertexArray);
+    /// Bind a texture of any target to a unit, without changing the active unit.
+    static void BindTexture(GLuint unit, GLuint texture);
+    /// Issue the pipeline state calls for every field that differs from the current state.
+    static void Apply(const PipelineState &state);
+
+    /**
+     * @brief Record a uniform value of the current program.
+     * @return True if the value differs from the last one set at this location and has to be uploaded.
+     */
+    static bool UniformChanged(int location, const void *value, size_t size);
+    /// Drop the cached uniforms of a deleted program, its name may be reused.
+    static void ForgetProgram(GLuint program);
+
+    [[nodiscard]] static const GLStateCounters &Frame() { return _frame; }
+    [[nodiscard]] static const GLStateCounters &LastFrame() { return _lastFrame; }
+
+private:
+    static constexpr GLuint Unknown = UINT32_MAX;
+
+    struct UniformValue
+    {
+        uint32_t size = 0; ///< 0 until set once
+        alignas(16) uint8_t data[sizeof(glm::mat4)];
+    };
+
+    static void Count(GLStateCounters::Kind kind, bool issued);
+    static void Toggle(GLenum capability, bool enabled);
+
+    inline static GLuint _program     = Unknown;
+    inline static GLuint _vertexArray = Unknown;
+    inline static GLuint _textures[TextureUnits];
+    inline static PipelineState _pipeline;
+    inline static bool _pipelineKnown = false;
+
+    inline static std::unordered_map<GLuint, std::vector<UniformValue>> _uniforms;
+    inline static std::vector<UniformValue> *_programUniforms = nullptr; ///< of _program
+
+    inline static GLStateCounters _frame;
+    inline static GLStateCounters _lastFrame;
+};
@@ -0,0 +1,65 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       PipelineState.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Fixed-function state of a draw as one comparable value.
+ *
+ *  This file defines PipelineState, the depth, blend, rasterizer and stencil
+ *  state a draw needs, and the Pipelines presets of the passes. A pass hands
+ *  its preset to the objects, an object derives its own copy from it (e.g.
+ *  the skybox does not write depth) and GLState::Apply() issues only the
+ *  GL calls for the fields that differ from the current state.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include <GL/glew.h>
+
+/**
+ * @struct PipelineState
+ * @brief Depth, blend, rasterizer and stencil state applied as a whole by GLState.
+ */
+struct PipelineState
+{
+    // Depth
+    bool   depthTest  = true;
+    GLenum depthFunc  = GL_LEQUAL;
+    bool   depthWrite = true;
+
+    // Blend
+    bool   blend    = true;
+    GLenum blendSrc = GL_SRC_ALPHA;
+    GLenum blendDst = GL_ONE_MINUS_SRC_ALPHA;
+
+    // Rasterizer
+    bool   cull       = true;
+    GLenum cullFace   = GL_BACK;
+    bool   colorWrite = true;
+
+    // Stencil
+    bool   stencilTest      = false;
+    GLuint stencilWriteMask = 0xFF;
+    GLenum stencilFunc      = GL_ALWAYS;
+    GLint  stencilRef       = 0;
+    GLuint stencilReadMask  = 0xFF;
+    GLenum stencilFail      = GL_KEEP;
+    GLenum stencilDepthFail = GL_KEEP;
+    GLenum stencilPass      = GL_KEEP;
+
+    bool operator==(const PipelineState &other) const = default;
+};
+
+namespace Pipelines
+{
+    /// Scene pass: depth tested, alpha blended, back faces culled
+    inline constexpr PipelineState Scene{};
+
+    /// Stencil picking pass: every fragment writes stencilRef, set per object, colors are not written
+    inline constexpr PipelineState Picking{
+        .colorWrite  = false,
+        .stencilTest = true,
+        .stencilPass = GL_REPLACE,
+    };
+}
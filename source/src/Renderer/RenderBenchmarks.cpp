@@ -0,0 +1,223 @@
+#include "RenderBenchmarks.h"
+#include "src/Components/Transform.h"
+#include "src/Objects/ObjectBuffer.h"
+#include "src/Objects/RenderObject.h"
+#include "src/Utils/Stopwatch.h"
+#include "res/Models/Box/Box.h"
+
+void RenderBenchmarks::UniformLookups(const Shader &shader)
+{
+    constexpr int Iterations = 1000;
+
+    std::vector<UniformId> ids;
+    for (UniformId id = 0; id < UniformNames::Count(); ++id)
+        if (shader.GetUniform(id) != -1)
+            ids.push_back(id);
+
+    int sink = 0;
+    Stopwatch stopwatch;
+    for (int i = 0; i < Iterations; ++i)
+        for (const UniformId id : ids)
+            sink += shader.GetUniformLocation(std::string(UniformNames::Name(id)));
+    const double byName = stopwatch.ElapsedMs();
+
+    stopwatch.Restart();
+    for (int i = 0; i < Iterations; ++i)
+        for (const UniformId id : ids)
+            sink += shader.GetUniform(id);
+    const double byId = stopwatch.ElapsedMs();
+
+    LOG("Uniform lookups, {} names x {}: by name {:.3f} ms, by interned id {:.3f} ms ({:.0f}x), checksum {}.",
+        ids.size(), Iterations, byName, byId, byId > 0.0 ? byName / byId : 0.0, sink);
+}
+
+void RenderBenchmarks::ObjectBufferThroughput()
+{
+    constexpr uint32_t Counts[] = {1000, 10000, 100000};
+
+    ObjectBuffer buffer;
+    buffer.Create();
+    for (const uint32_t count : Counts)
+    {
+        Stopwatch stopwatch;
+        buffer.BeginFrame();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            Transform transform(glm::vec3(i % 100, (i / 100) % 100, i / 10000), 0.5f);
+            transform.RotateLocal(glm::vec3(0.0f, 1.0f, 0.0f), static_cast<float>(i));
+
+            ObjectData data;
+            data.SetModel(transform.GetMatrix());
+            data.useTexture = i & 1;
+            buffer.Push(data);
+        }
+        buffer.EndFrame();
+
+        const double ms = stopwatch.ElapsedMs();
+        LOG("Object buffer, {} objects: {:.3f} ms, {:.0f} objects/ms, {:.1f} MB/s, capacity {}.", count, ms, count / ms,
+            count * sizeof(ObjectData) / (ms * 1000.0), buffer.ObjectCapacity());
+    }
+    buffer.Destroy();
+}
+
+void RenderBenchmarks::ShaderVariantCost(const std::vector<std::shared_ptr<RenderObject>> &objects, const Shader &uberShader,
+                                         ShaderVariants &variants, bool fog)
+{
+    constexpr int Repeats = 16;
+
+    std::map<ShaderVariants::Key, std::vector<RenderObject *>> groups;
+    for (const auto &object : objects)
+        if (object)
+            groups[object->Features() | (fog ? ShaderVariants::Fog : ShaderVariants::None)].push_back(object.get());
+
+    GLuint query = 0;
+    glGenQueries(1, &query);
+    auto measure = [query](const std::vector<RenderObject *> &group, const Shader &program)
+    {
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        for (int repeat = 0; repeat < Repeats; repeat++)
+            for (RenderObject *object : group)
+                object->Render(program);
+        glEndQuery(GL_TIME_ELAPSED);
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+        return elapsed / 1e6;
+    };
+
+    double uberTotal = 0.0, variantTotal = 0.0;
+    for (const auto &[key, group] : groups)
+    {
+        const double uber = measure(group, uberShader);
+        const double variant = measure(group, variants.Get(key));
+        uberTotal += uber;
+        variantTotal += variant;
+        LOG("Shader variant {}: {} objects x {}, uber-shader {:.3f} ms, variant {:.3f} ms ({:.2f}x).",
+            ShaderVariants::Name(key), group.size(), Repeats, uber, variant, variant > 0.0 ? uber / variant : 0.0);
+    }
+    LOG("Shader variants, {} compiled: uber-shader {:.3f} ms, variants {:.3f} ms ({:.2f}x).", variants.Count(), uberTotal,
+        variantTotal, variantTotal > 0.0 ? uberTotal / variantTotal : 0.0);
+
+    glDeleteQueries(1, &query);
+    GLState::Apply(Pipelines::Scene);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+}
+
+void RenderBenchmarks::BoxInstancing(const Shader &program)
+{
+    constexpr uint32_t Count = 50000;
+
+    ObjectBuffer buffer;
+    buffer.Create(Count);
+    buffer.BeginFrame();
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        ObjectData data;
+        data.SetModel(glm::translate(glm::vec3(i % 250, (i / 250) % 8, i / 2000) * 0.5f) * glm::scale(glm::vec3(0.2f)));
+        data.useTexture = Box::useTexture;
+        buffer.Push(data);
+    }
+
+    GLState::Apply(Pipelines::Scene);
+    Shader::Bind(program);
+    GLState::BindVertexArray(Box::VAO);
+    GLState::BindTexture(1, Box::textureDiffID);
+    GLState::BindTexture(2, Box::textureSpecID);
+
+    GLuint query = 0;
+    glGenQueries(1, &query);
+    auto measure = [query](const std::function<void()> &draw, double &cpuMs)
+    {
+        glFinish();
+        Stopwatch stopwatch;
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        draw();
+        glEndQuery(GL_TIME_ELAPSED);
+        cpuMs = stopwatch.ElapsedMs();
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+        return elapsed / 1e6;
+    };
+
+    double separateCpuMs = 0.0, instancedCpuMs = 0.0;
+    const double separateGpuMs = measure([]
+    {
+        for (uint32_t i = 0; i < Count; i++)
+            glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, Box::vertexCount, 1, i);
+    }, separateCpuMs);
+    const double instancedGpuMs = measure([]
+    {
+        glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, Box::vertexCount, Count, 0);
+    }, instancedCpuMs);
+
+    LOG("Box instancing, {} boxes: {} draws {:.3f} ms CPU / {:.3f} ms GPU, 1 instanced draw {:.3f} ms CPU / {:.3f} ms GPU ({:.1f}x CPU).",
+        Count, Count, separateCpuMs, separateGpuMs, instancedCpuMs, instancedGpuMs, instancedCpuMs > 0.0 ? separateCpuMs / instancedCpuMs : 0.0);
+
+    glDeleteQueries(1, &query);
+    buffer.EndFrame();
+    glFinish();
+    buffer.Destroy();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+}
+
+void RenderBenchmarks::SceneSubmission(const std::vector<RenderObject *> &meshes, const ProgramOf &programOf)
+{
+    constexpr int Repeats = 64;
+    if (meshes.empty())
+        return;
+
+    struct Submission
+    {
+        double   cpuMs        = 0.0;
+        uint32_t stateCalls   = 0;
+        uint64_t uniformCalls = 0;
+        uint32_t draws        = 0;
+    };
+    auto measure = [](const std::function<uint32_t()> &submit)
+    {
+        glFinish();
+        const uint32_t stateCalls = GLState::Frame().Issued();
+        const uint64_t uniformCalls = Shader::UniformCalls();
+        uint32_t draws = 0;
+
+        Stopwatch stopwatch;
+        for (int repeat = 0; repeat < Repeats; repeat++)
+            draws += submit();
+        const double cpuMs = stopwatch.ElapsedMs();
+        glFinish();
+
+        return Submission{cpuMs / Repeats, (GLState::Frame().Issued() - stateCalls) / Repeats,
+                          (Shader::UniformCalls() - uniformCalls) / Repeats, draws / Repeats};
+    };
+
+    const Submission separate = measure([&meshes, &programOf]
+    {
+        for (RenderObject *obj : meshes)
+            obj->Render(programOf(*obj));
+        return static_cast<uint32_t>(meshes.size());
+    });
+
+    std::vector<RenderObject *> batch;
+    const Submission batched = measure([&meshes, &batch, &programOf]
+    {
+        uint32_t draws = 0;
+        for (size_t i = 0; i < meshes.size(); i += batch.size(), draws++)
+        {
+            batch.assign(1, meshes[i]);
+            while (i + batch.size() < meshes.size() && meshes[i]->CanMultiDraw(*meshes[i + batch.size()]))
+                batch.push_back(meshes[i + batch.size()]);
+            RenderObject::RenderMeshes(programOf(*meshes[i]), batch);
+        }
+        return draws;
+    });
+
+    LOG("Scene submission, {} meshes: {} draws {:.3f} ms CPU, {} state + {} uniform calls; "
+        "{} multi-draws {:.3f} ms CPU, {} state + {} uniform calls ({:.1f}x CPU).",
+        meshes.size(), separate.draws, separate.cpuMs, separate.stateCalls, separate.uniformCalls,
+        batched.draws, batched.cpuMs, batched.stateCalls, batched.uniformCalls,
+        batched.cpuMs > 0.0 ? separate.cpuMs / batched.cpuMs : 0.0);
+
+    GLState::Apply(Pipelines::Scene);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+}
@@ -0,0 +1,75 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       RenderBenchmarks.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Opt-in benchmarks that run inside the application.
+ *
+ *  This file declares the RenderBenchmarks class, measurements that need
+ *  the GL context of the running application, e.g. because they time
+ *  driver calls or draws. Each logs its result once. They are only called
+ *  with IMPL_RENDER_BENCHMARKS defined, so a normal start does not pay
+ *  for them. Benchmarks without GL calls are in the PGR_Bench executable.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include <functional>
+#include "src/Resources/Shader/Shader.h"
+#include "src/Resources/Shader/ShaderVariants.h"
+
+class RenderObject;
+
+// Features
+// #define IMPL_RENDER_BENCHMARKS
+
+class RenderBenchmarks
+{
+public:
+    /// Program an object is drawn with in the scene pass.
+    using ProgramOf = std::function<const Shader &(const RenderObject &)>;
+
+    /**
+     * @brief Compare resolving the uniforms of a program by name with the interned location table.
+     *
+     * The name path rebuilds every name and asks the driver, as the light and material uploads did before.
+     */
+    static void UniformLookups(const Shader &shader);
+    /**
+     * @brief Log how fast object data is written into the ring for generated scenes of thousands of objects.
+     *
+     * Each object costs its matrices and one copy into mapped memory and no GL call, where it used
+     * to cost three to six uniform calls plus a matrix inverse per vertex.
+     */
+    static void ObjectBufferThroughput();
+    /**
+     * @brief Log the CPU submission and GPU time of 50k boxes drawn one draw per box and as one instanced draw.
+     *
+     * Both read the same object data, so the difference is the draw call overhead. The frame is cleared afterwards,
+     * the live object buffer is bound again by its next BeginFrame().
+     *
+     * @param program Scene program of the boxes.
+     */
+    static void BoxInstancing(const Shader &program);
+    /**
+     * @brief Log the CPU submission time and GL calls of the opaque scene meshes drawn one draw per mesh and batched into multi-draws.
+     *
+     * Both go over the meshes in render queue order Repeats times, GL calls are the state calls GLState issued
+     * plus the draws. The frame is cleared afterwards.
+     *
+     * @param meshes    Opaque meshes in render queue order.
+     * @param programOf Scene program an object is drawn with.
+     */
+    static void SceneSubmission(const std::vector<RenderObject *> &meshes, const ProgramOf &programOf);
+    /**
+     * @brief Log the GPU time of the objects of every permutation drawn with it and with the uber-shader.
+     *
+     * Every group is drawn Repeats times over the depth tested frame, so fragment shading dominates the
+     * GL_TIME_ELAPSED queries. The frame is cleared afterwards.
+     *
+     * @param fog Whether the objects are drawn with fog, see ShaderVariants::Fog.
+     */
+    static void ShaderVariantCost(const std::vector<std::shared_ptr<RenderObject>> &objects, const Shader &uberShader,
+                                  ShaderVariants &variants, bool fog);
+};
@@ -0,0 +1,133 @@
+#include "RenderQueue.h"
+#include <bit>
+
+namespace
+{
+    constexpr uint64_t Bits(uint64_t value, int width)
+    {
+        return value & ((uint64_t(1) << width) - 1);
+    }
+
+    /// 24 bits ordered like the depth, the bits of a positive float compare like the float itself
+    uint64_t DepthBits(float depth)
+    {
+        if (!(depth > 0.0f))
+            return 0;
+        return std::bit_cast<uint32_t>(depth) >> 8;
+    }
+}
+
+uint64_t RenderQueue::Key(Pass pass, uint32_t program, uint32_t material, uint32_t mesh, float depth)
+{
+    const uint64_t state = Bits(program, 8) << 30 | Bits(material, 10) << 20 | Bits(mesh, 20);
+    const uint64_t key = static_cast<uint64_t>(pass) << 62;
+
+    // Far surfaces first, blending needs them below the near ones
+    if (pass == Pass::Transparent)
+        return key | Bits(~DepthBits(depth), 24) << 38 | state;
+
+    return key | state << 24 | DepthBits(depth);
+}
+
+void RenderQueue::Build(size_t count, const Emit &emit)
+{
+    const size_t blocks = Blocks(count);
+    if (_buckets.size() < blocks)
+        _buckets.resize(blocks);
+
+    ForBlocks(blocks, [&](size_t block)
+    {
+        std::vector<RenderQueueEntry> &bucket = _buckets[block];
+        bucket.clear();
+        emit(count * block / blocks, count * (block + 1) / blocks, bucket);
+    });
+
+    // Buckets in item order, so Sort() keeps equal keys in that order
+    size_t total = 0;
+    for (size_t block = 0; block < blocks; block++)
+        total += _buckets[block].size();
+
+    _entries.clear();
+    _entries.reserve(total);
+    for (size_t block = 0; block < blocks; block++)
+        _entries.insert(_entries.end(), _buckets[block].begin(), _buckets[block].end());
+}
+
+void RenderQueue::Sort()
+{
+    const size_t count = _entries.size();
+    const size_t blocks = Blocks(count);
+    _scratch.resize(count);
+    _histograms.resize(blocks);
+
+    // Least significant digit first, each pass is stable
+    RenderQueueEntry *source = _entries.data();
+    RenderQueueEntry *target = _scratch.data();
+    for (int shift = 0; shift < 64; shift += RadixBits)
+    {
+        auto range = [count, blocks](size_t block) { return std::pair(count * block / blocks, count * (block + 1) / blocks); };
+
+        ForBlocks(blocks, [&](size_t block)
+        {
+            std::array<uint32_t, Radix> &histogram = _histograms[block];
+            histogram.fill(0);
+            const auto [begin, end] = range(block);
+            for (size_t i = begin; i < end; i++)
+                histogram[(source[i].key >> shift) & (Radix - 1)]++;
+        });
+
+        // A digit all keys share does not reorder anything, e.g. the pass bits of a single pass
+        bool uniform = false;
+        for (size_t digit = 0; digit < Radix && !uniform; digit++)
+        {
+            size_t total = 0;
+            for (size_t block = 0; block < blocks; block++)
+                total += _histograms[block][digit];
+            uniform = total == count;
+        }
+        if (uniform)
+            continue;
+
+        // Target offsets by digit, then by block, so blocks keep their order within a digit
+        uint32_t offset = 0;
+        for (size_t digit = 0; digit < Radix; digit++)
+        {
+            for (size_t block = 0; block < blocks; block++)
+            {
+                const uint32_t digitCount = _histograms[block][digit];
+                _histograms[block][digit] = offset;
+                offset += digitCount;
+            }
+        }
+
+        ForBlocks(blocks, [&](size_t block)
+        {
+            std::array<uint32_t, Radix> &offsets = _histograms[block];
+            const auto [begin, end] = range(block);
+            for (size_t i = begin; i < end; i++)
+                target[offsets[(source[i].key >> shift) & (Radix - 1)]++] = source[i];
+        });
+        std::swap(source, target);
+    }
+
+    if (source != _entries.data())
+        _entries.swap(_scratch);
+}
+
+size_t RenderQueue::Blocks(size_t count)
+{
+    if (count < ParallelThreshold || _threadCount == 1)
+        return 1;
+
+    if (!_pool)
+        _pool = std::make_unique<ThreadPool>(_threadCount);
+    return _pool->ThreadCount();
+}
+
+void RenderQueue::ForBlocks(size_t blocks, const std::function<void(size_t)> &job)
+{
+    if (blocks == 1)
+        job(0);
+    else
+        _pool->ParallelFor(blocks, job);
+}
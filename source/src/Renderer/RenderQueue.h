@@ -0,0 +1,94 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       RenderQueue.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Draw list ordered by 64-bit sort keys.
+ *
+ *  This file declares the RenderQueue class. Every visible item emits one
+ *  key packing its pass, program, material, mesh and view depth, the keys are
+ *  collected into one bucket per worker, radix sorted and submitted in order,
+ *  so consecutive draws share state and every pass is drawn in the order it
+ *  needs: opaque grouped by state and front to back within a state, the
+ *  skybox after them at the far plane and transparent back to front.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include <functional>
+#include "src/Utils/ThreadPool.h"
+
+// Features
+#define IMPL_RENDER_QUEUE
+
+/**
+ * @struct RenderQueueEntry
+ * @brief Sort key of a draw and the index of the item it draws.
+ */
+struct RenderQueueEntry
+{
+    uint64_t key  = 0;
+    uint32_t item = 0;
+};
+
+class RenderQueue
+{
+public:
+    /**
+     * @enum Pass
+     * @brief Passes in draw order, the top bits of a key.
+     */
+    enum class Pass : uint64_t
+    {
+        Opaque,      ///< by program, material and mesh, then front to back
+        Sky,         ///< at the far plane, only where nothing opaque was drawn
+        Transparent, ///< back to front, blended over everything before
+    };
+
+    /// Fills the bucket with the entries of items [begin, end), called on a worker per bucket.
+    using Emit = std::function<void(size_t begin, size_t end, std::vector<RenderQueueEntry> &bucket)>;
+
+    /// @param threadCount Workers building and sorting large queues, 0 uses the hardware concurrency, 1 never starts any
+    explicit RenderQueue(unsigned int threadCount = 0) : _threadCount(threadCount) {}
+
+    /**
+     * @brief Key of a draw.
+     * @param pass     Pass the draw belongs to.
+     * @param program  Program slot, 8 bits.
+     * @param material Material slot, 10 bits.
+     * @param mesh     Mesh slot, e.g. its vertex array, 20 bits.
+     * @param depth    View space depth of the draw, negative (behind the camera) counts as 0.
+     *
+     * Opaque and sky keys are pass | program | material | mesh | depth, transparent keys are
+     * pass | inverted depth | program | material | mesh. Wider slots are truncated, which only costs
+     * state sharing, never the pass or depth order.
+     */
+    [[nodiscard]] static uint64_t Key(Pass pass, uint32_t program, uint32_t material, uint32_t mesh, float depth);
+
+    /// Collect the entries of count items, in parallel buckets when there are enough of them.
+    void Build(size_t count, const Emit &emit);
+    /// Order the entries by key, stable for equal keys.
+    void Sort();
+
+    [[nodiscard]] const std::vector<RenderQueueEntry> &Entries() const { return _entries; }
+    [[nodiscard]] size_t Size() const { return _entries.size(); }
+
+private:
+    static constexpr size_t ParallelThreshold = 4096; ///< smaller queues are built and sorted on the calling thread
+    static constexpr int RadixBits = 8;
+    static constexpr size_t Radix = 1 << RadixBits;
+
+    /// Blocks a queue of count entries is split into, one per worker.
+    [[nodiscard]] size_t Blocks(size_t count);
+    /// Run job(block) for every block, on the workers if there are several.
+    void ForBlocks(size_t blocks, const std::function<void(size_t)> &job);
+
+    unsigned int _threadCount = 0;
+    std::unique_ptr<ThreadPool> _pool; ///< started by the first large queue
+
+    std::vector<std::vector<RenderQueueEntry>> _buckets;
+    std::vector<RenderQueueEntry> _entries;
+    std::vector<RenderQueueEntry> _scratch;
+    std::vector<std::array<uint32_t, Radix>> _histograms; ///< per block
+};
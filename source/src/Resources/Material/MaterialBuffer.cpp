@@ -0,0 +1,43 @@
+#include "MaterialBuffer.h"
+
+void MaterialBuffer::Set(const MaterialPGR &material)
+{
+    if (material.Index() != 0)
+        Store(material, material.Index());
+}
+
+void MaterialBuffer::Store(const MaterialPGR &material, uint32_t index)
+{
+    if (_materials.size() <= index)
+        _materials.resize(index + 1);
+
+    static const UniformId Diffuse   = UniformNames::Intern("material.diffuse");
+    static const UniformId Specular  = UniformNames::Intern("material.specular");
+    static const UniformId Shininess = UniformNames::Intern("material.shininess");
+
+    MaterialData &data = _materials[index];
+    for (const auto &[id, value] : material._values)
+    {
+        if (id == Diffuse && value.type == MaterialPGR::MaterialValue::VEC3)
+            data.diffuse = value.v3;
+        else if (id == Specular && value.type == MaterialPGR::MaterialValue::VEC3)
+            data.specular = value.v3;
+        else if (id == Shininess && value.type == MaterialPGR::MaterialValue::FLOAT)
+            data.shininess = value.f;
+    }
+}
+
+void MaterialBuffer::Create()
+{
+    Destroy();
+
+    glCreateBuffers(1, &_ssbo);
+    glNamedBufferStorage(_ssbo, static_cast<GLsizeiptr>(_materials.size() * sizeof(MaterialData)), _materials.data(), 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, Binding, _ssbo);
+}
+
+void MaterialBuffer::Destroy()
+{
+    if (_ssbo) glDeleteBuffers(1, &_ssbo);
+    _ssbo = 0;
+}
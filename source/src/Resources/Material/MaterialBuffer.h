@@ -0,0 +1,64 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       MaterialBuffer.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Storage buffer holding the colors of the scene materials.
+ *
+ *  This file declares the MaterialBuffer class, the std430 material array
+ *  indexed by MaterialPGR::Index(). Shaders read the material of a draw
+ *  through ObjectData::materialIndex, so objects with different materials
+ *  need no uniform uploads in between and the scene meshes can go out in
+ *  one multi-draw. Element 0 holds the default material of the objects
+ *  without one.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "MaterialPGR.h"
+
+// Features
+#define IMPL_MATERIAL_BUFFER
+
+/**
+ * @struct MaterialData
+ * @brief CPU mirror of MaterialData in MaterialBlock.glsl, every vec3 shares its 16 bytes with the scalar after it.
+ */
+struct MaterialData
+{
+    glm::vec3 diffuse   = glm::vec3(0.0f);
+    float     shininess = 0.0f;
+    glm::vec3 specular  = glm::vec3(0.0f);
+    float     padding   = 0.0f;
+};
+static_assert(sizeof(MaterialData) == 32, "MaterialData must match the std430 layout of MaterialBlock");
+
+class MaterialBuffer
+{
+public:
+    /// layout(binding) of MaterialBlock
+    static constexpr GLuint Binding = 3;
+
+    MaterialBuffer() = default;
+    ~MaterialBuffer() { Destroy(); }
+
+    MaterialBuffer(const MaterialBuffer &) = delete;
+    MaterialBuffer &operator=(const MaterialBuffer &) = delete;
+
+    /// Store the colors of a material at its index, materials without an index are ignored.
+    void Set(const MaterialPGR &material);
+    /// Store the colors objects without a material are lit with.
+    void SetDefault(const MaterialPGR &material) { Store(material, 0); }
+    /// Create the buffer with the stored materials and bind it to Binding, again after materials were added.
+    void Create();
+    void Destroy();
+
+    [[nodiscard]] size_t Count() const { return _materials.size(); }
+
+private:
+    void Store(const MaterialPGR &material, uint32_t index);
+
+    GLuint _ssbo = 0;
+    std::vector<MaterialData> _materials = std::vector<MaterialData>(1); ///< by MaterialPGR::Index(), the default at 0
+};
@@ -3,36 +3,36 @@
 #define ENABLE_BUILTIN_MATERIAL
 
 #if defined(ENABLE_BUILTIN_MATERIAL) && defined(IMPL_SHADER)
-MaterialPGR::MaterialPGR(const Shader &shader) : _shader(&shader)
+MaterialPGR::MaterialPGR(const Shader &shader) : _shader(&shader), _index(_count.fetch_add(1, std::memory_order_relaxed) + 1)
 {}
 
 void MaterialPGR::SetInt(const std::string &name, int value)
 {
-    _values[name] = {MaterialValue::INT, {.i = value}};
+    _values[UniformNames::Intern(name)] = {MaterialValue::INT, {.i = value}};
 }
 void MaterialPGR::SetFloat(const std::string &name, float value)
 {
-    _values[name] = {MaterialValue::FLOAT, {.f = value}};
+    _values[UniformNames::Intern(name)] = {MaterialValue::FLOAT, {.f = value}};
 }
 void MaterialPGR::SetVec2(const std::string &name, const glm::vec2 &value)
 {
-    _values[name] = {MaterialValue::VEC2, {.v2 = value}};
+    _values[UniformNames::Intern(name)] = {MaterialValue::VEC2, {.v2 = value}};
 }
 void MaterialPGR::SetVec3(const std::string &name, const glm::vec3 &value)
 {
-    _values[name] = {MaterialValue::VEC3, {.v3 = value}};
+    _values[UniformNames::Intern(name)] = {MaterialValue::VEC3, {.v3 = value}};
 }
 void MaterialPGR::SetVec4(const std::string &name, const glm::vec4 &value)
 {
-    _values[name] = {MaterialValue::VEC4, {.v4 = value}};
+    _values[UniformNames::Intern(name)] = {MaterialValue::VEC4, {.v4 = value}};
 }
 void MaterialPGR::SetMat3(const std::string &name, const glm::mat3 &value)
 {
-    _values[name] = {MaterialValue::MAT3, {.m3 = value}};
+    _values[UniformNames::Intern(name)] = {MaterialValue::MAT3, {.m3 = value}};
 }
 void MaterialPGR::SetMat4(const std::string &name, const glm::mat4 &value)
 {
-    _values[name] = {MaterialValue::MAT4, {.m4 = value}};
+    _values[UniformNames::Intern(name)] = {MaterialValue::MAT4, {.m4 = value}};
 }
 
 void MaterialPGR::SetValues()
@@ -42,11 +42,13 @@ void MaterialPGR::SetValues()
     SetVec3("material.specular", Specular);
     SetFloat("material.shininess", Shininess);
 }
-void MaterialPGR::ApplyValues() const
+void MaterialPGR::ApplyValues(const Shader &shader) const
 {
-    for (const auto &[name, value] : _values)
+    for (const auto &[id, value] : _values)
     {
-        const int location = _shader->GetUniformLocationSafe(name);
+        const int location = shader.GetUniform(id);
+        if (location == -1)
+            continue;
 
         switch (value.type)
         {
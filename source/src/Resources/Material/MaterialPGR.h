@@ -15,6 +15,7 @@
 //----------------------------------------------------------------------------------------
 
 #pragma once
+#include <atomic>
 #include "../Shader/Shader.h"
 
 #define USE_BUILTIN_MATERIAL
@@ -32,6 +33,10 @@
 class MaterialPGR
 {
 public:
+    // Persists derived values of scene materials
+    friend class MeshCache;
+    // Copies the colors into the material storage buffer
+    friend class MaterialBuffer;
 
 private:
     static constexpr glm::vec3 Diffuse = glm::vec3(1.0f, 0.5f, 0.31f);
@@ -62,7 +67,10 @@ private:
         };
     };
     const Shader *_shader;
-    std::unordered_map<std::string, MaterialValue> _values;
+    std::unordered_map<UniformId, MaterialValue> _values; ///< by interned uniform name
+    uint32_t _index = 0;
+
+    inline static std::atomic<uint32_t> _count = 0; ///< materials are built on the scene import workers
 
 public:
     MaterialPGR() = default;
@@ -76,6 +84,9 @@ public:
     void SetMat3(const std::string &name, const glm::mat3 &value);
     void SetMat4(const std::string &name, const glm::mat4 &value);
 
+    /// Unique per constructed material and shared by its copies, 0 for none; stored in ObjectData::materialIndex.
+    [[nodiscard]] uint32_t Index() const { return _index; }
+
     /**
      * @brief Initialize the material with default PBR-like values.
      *
@@ -84,12 +95,14 @@ public:
      */
     void SetValues();
     /**
-     * @brief Apply all stored uniform values to the Shader.
+     * @brief Apply all stored uniform values to the bound Shader.
+     * @param shader The bound program, the material's shader or one of its variants.
      *
      * Iterates over the internal map of names and values, binding
-     * each to the associated Shader via the appropriate uniform calls.
+     * each via the appropriate uniform calls; uniforms the program
+     * does not use are skipped.
      */
-    void ApplyValues() const;
+    void ApplyValues(const Shader &shader) const;
 
 private:
 };
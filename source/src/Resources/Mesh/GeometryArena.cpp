@@ -0,0 +1,206 @@
+#include "GeometryArena.h"
+
+namespace
+{
+    constexpr GLbitfield StorageFlags = GL_DYNAMIC_STORAGE_BIT | GL_MAP_WRITE_BIT;
+    constexpr GLbitfield MapFlags     = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+}
+
+GeometryArena::GeometryArena(uint32_t stride, const std::function<void()> &specifyFormat)
+    : _stride(stride), _vertexAllocator(InitialVertices), _indexAllocator(InitialIndexBytes)
+{
+    _vbo = Reallocate(0, static_cast<size_t>(InitialVertices) * _stride, 0);
+    _ebo = Reallocate(0, InitialIndexBytes, 0);
+
+    glCreateVertexArrays(1, &_vao);
+    glVertexArrayVertexBuffer(_vao, 0, _vbo, 0, static_cast<GLsizei>(_stride));
+    glVertexArrayElementBuffer(_vao, _ebo);
+
+    glBindVertexArray(_vao);
+    specifyFormat();
+    glBindVertexArray(0);
+}
+
+GeometryArena::~GeometryArena()
+{
+    if (_ebo) glDeleteBuffers(1, &_ebo);
+    if (_vbo) glDeleteBuffers(1, &_vbo);
+    if (_vao) glDeleteVertexArrays(1, &_vao);
+}
+
+GeometryArena::Handle GeometryArena::Allocate(uint32_t vertexCount, uint32_t indexBytes)
+{
+    GeometryRange range;
+    range.vertexCount = vertexCount;
+    range.indexBytes  = indexBytes;
+
+    // reserve both ranges, growing the buffers until they fit
+    for (;;)
+    {
+        range.baseVertex = vertexCount ? _vertexAllocator.Allocate(vertexCount) : 0;
+        range.indexOffset = indexBytes ? _indexAllocator.Allocate(indexBytes, IndexAlignment) : 0;
+        if (range.baseVertex != RangeAllocator::Invalid && range.indexOffset != RangeAllocator::Invalid)
+            break;
+
+        if (range.baseVertex != RangeAllocator::Invalid)
+            _vertexAllocator.Free(range.baseVertex, vertexCount);
+        if (range.indexOffset != RangeAllocator::Invalid)
+            _indexAllocator.Free(range.indexOffset, indexBytes);
+        Grow(vertexCount, indexBytes);
+    }
+
+    // reuse a freed handle
+    Handle handle;
+    if (!_freeHandles.empty())
+    {
+        handle = _freeHandles.back();
+        _freeHandles.pop_back();
+        _ranges[handle] = range;
+        _live[handle] = true;
+    }
+    else
+    {
+        handle = static_cast<Handle>(_ranges.size());
+        _ranges.push_back(range);
+        _live.push_back(true);
+    }
+    return handle;
+}
+
+void GeometryArena::Free(Handle handle)
+{
+    if (handle >= _ranges.size() || !_live[handle])
+        return;
+
+    const GeometryRange &range = _ranges[handle];
+    if (range.vertexCount)
+        _vertexAllocator.Free(range.baseVertex, range.vertexCount);
+    if (range.indexBytes)
+        _indexAllocator.Free(range.indexOffset, range.indexBytes);
+
+    _ranges[handle] = {};
+    _live[handle] = false;
+    _freeHandles.push_back(handle);
+}
+
+void *GeometryArena::MapVertices(Handle handle) const
+{
+    const GeometryRange &range = _ranges[handle];
+    return glMapNamedBufferRange(_vbo, static_cast<GLintptr>(range.baseVertex) * _stride,
+                                 static_cast<GLsizeiptr>(range.vertexCount) * _stride, MapFlags);
+}
+
+void GeometryArena::UnmapVertices() const
+{
+    glUnmapNamedBuffer(_vbo);
+}
+
+void *GeometryArena::MapIndices(Handle handle) const
+{
+    const GeometryRange &range = _ranges[handle];
+    return glMapNamedBufferRange(_ebo, range.indexOffset, range.indexBytes, MapFlags);
+}
+
+void GeometryArena::UnmapIndices() const
+{
+    glUnmapNamedBuffer(_ebo);
+}
+
+size_t GeometryArena::Compact()
+{
+    // live ranges in buffer order, so every range moves towards the front
+    std::vector<Handle> handles;
+    for (Handle handle = 0; handle < _ranges.size(); ++handle)
+        if (_live[handle])
+            handles.push_back(handle);
+    std::sort(handles.begin(), handles.end(), [this](Handle a, Handle b) { return _ranges[a].baseVertex < _ranges[b].baseVertex; });
+
+    std::vector<uint32_t> vertexCounts, indexBytes;
+    for (const Handle handle : handles)
+    {
+        vertexCounts.push_back(_ranges[handle].vertexCount);
+        indexBytes.push_back(_ranges[handle].indexBytes);
+    }
+    const std::vector<uint32_t> baseVertices = _vertexAllocator.Compact(vertexCounts);
+    const std::vector<uint32_t> indexOffsets = _indexAllocator.Compact(indexBytes, IndexAlignment);
+
+    GLuint vbo = Reallocate(0, static_cast<size_t>(_vertexAllocator.Capacity()) * _stride, 0);
+    GLuint ebo = Reallocate(0, _indexAllocator.Capacity(), 0);
+
+    size_t moved = 0;
+    for (size_t i = 0; i < handles.size(); ++i)
+    {
+        GeometryRange &range = _ranges[handles[i]];
+        if (range.vertexCount)
+        {
+            glCopyNamedBufferSubData(_vbo, vbo, static_cast<GLintptr>(range.baseVertex) * _stride, static_cast<GLintptr>(baseVertices[i]) * _stride,
+                                     static_cast<GLsizeiptr>(range.vertexCount) * _stride);
+            moved += static_cast<size_t>(range.vertexCount) * _stride;
+            range.baseVertex = baseVertices[i];
+        }
+        if (range.indexBytes)
+        {
+            glCopyNamedBufferSubData(_ebo, ebo, range.indexOffset, indexOffsets[i], range.indexBytes);
+            moved += range.indexBytes;
+            range.indexOffset = indexOffsets[i];
+        }
+    }
+
+    glDeleteBuffers(1, &_vbo);
+    glDeleteBuffers(1, &_ebo);
+    _vbo = vbo;
+    _ebo = ebo;
+    glVertexArrayVertexBuffer(_vao, 0, _vbo, 0, static_cast<GLsizei>(_stride));
+    glVertexArrayElementBuffer(_vao, _ebo);
+
+    _compacts++;
+    return moved;
+}
+
+GeometryArenaStats GeometryArena::Stats() const
+{
+    GeometryArenaStats stats;
+    stats.vertices = _vertexAllocator.Stats();
+    stats.indices  = _indexAllocator.Stats();
+    stats.stride   = _stride;
+    stats.grows    = _grows;
+    stats.compacts = _compacts;
+    return stats;
+}
+
+GLuint GeometryArena::Reallocate(GLuint buffer, size_t bytes, size_t copyBytes)
+{
+    GLuint result = 0;
+    glCreateBuffers(1, &result);
+    glNamedBufferStorage(result, static_cast<GLsizeiptr>(bytes), nullptr, StorageFlags);
+    if (buffer && copyBytes)
+        glCopyNamedBufferSubData(buffer, result, 0, 0, static_cast<GLsizeiptr>(copyBytes));
+    return result;
+}
+
+void GeometryArena::Grow(uint32_t vertexCount, uint32_t indexBytes)
+{
+    // double the buffer that lacks a large enough free range
+    if (vertexCount > _vertexAllocator.Stats().largestFree)
+    {
+        const uint32_t capacity = std::max(_vertexAllocator.Capacity() * 2, _vertexAllocator.Capacity() + vertexCount);
+        const GLuint vbo = Reallocate(_vbo, static_cast<size_t>(capacity) * _stride, static_cast<size_t>(_vertexAllocator.Capacity()) * _stride);
+        glDeleteBuffers(1, &_vbo);
+        _vbo = vbo;
+        glVertexArrayVertexBuffer(_vao, 0, _vbo, 0, static_cast<GLsizei>(_stride));
+        _vertexAllocator.Grow(capacity);
+    }
+    if (indexBytes + IndexAlignment > _indexAllocator.Stats().largestFree)
+    {
+        const uint32_t capacity = std::max(_indexAllocator.Capacity() * 2, _indexAllocator.Capacity() + indexBytes + IndexAlignment);
+        const GLuint ebo = Reallocate(_ebo, capacity, _indexAllocator.Capacity());
+        glDeleteBuffers(1, &_ebo);
+        _ebo = ebo;
+        glVertexArrayElementBuffer(_vao, _ebo);
+        _indexAllocator.Grow(capacity);
+    }
+
+    _grows++;
+    LOG("Geometry arena (stride {} B) grown to {} vertices, {:.1f} KB of indices.", _stride, _vertexAllocator.Capacity(),
+        _indexAllocator.Capacity() / 1024.0);
+}
@@ -0,0 +1,119 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       GeometryArena.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Shared vertex and index buffers sub-allocated between meshes.
+ *
+ *  This file declares the GeometryArena class. An arena owns one VAO, one
+ *  immutable vertex buffer of a single vertex layout and one immutable index
+ *  buffer, and hands out (base vertex, index offset) ranges of them through
+ *  RangeAllocator. Meshes of the same layout therefore share a VAO and are
+ *  drawn with the BaseVertex draw calls. Full buffers are replaced by larger
+ *  ones, and Compact() packs the live ranges again after meshes were freed;
+ *  both keep handles valid, only the offsets they resolve to change.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "GL/glew.h"
+#include "RangeAllocator.h"
+
+#include <functional>
+
+/**
+ * @struct GeometryRange
+ * @brief Location of one mesh inside the arena buffers.
+ */
+struct GeometryRange
+{
+    uint32_t baseVertex  = 0; ///< first vertex, added to every index by the draw call
+    uint32_t vertexCount = 0;
+    uint32_t indexOffset = 0; ///< byte offset into the index buffer
+    uint32_t indexBytes  = 0;
+};
+
+/**
+ * @struct GeometryArenaStats
+ * @brief Occupancy of both buffers of an arena.
+ */
+struct GeometryArenaStats
+{
+    RangeAllocatorStats vertices; ///< in vertices
+    RangeAllocatorStats indices;  ///< in bytes
+    uint32_t stride   = 0;
+    uint32_t grows    = 0;
+    uint32_t compacts = 0;
+};
+
+class GeometryArena
+{
+public:
+    using Handle = uint32_t;
+    static constexpr Handle InvalidHandle = UINT32_MAX;
+
+    /// Index ranges start at a multiple of this, enough for 16 and 32-bit indices
+    static constexpr uint32_t IndexAlignment = 4;
+    static constexpr uint32_t InitialVertices   = 1 << 16;
+    static constexpr uint32_t InitialIndexBytes = 1 << 20;
+
+    /**
+     * @brief Create the VAO with vertex buffer binding 0 and an empty index buffer.
+     * @param stride         Bytes per vertex.
+     * @param specifyFormat  Called once with the VAO bound to set glVertexAttribFormat/Binding of binding 0.
+     */
+    GeometryArena(uint32_t stride, const std::function<void()> &specifyFormat);
+    ~GeometryArena();
+
+    GeometryArena(const GeometryArena &) = delete;
+    GeometryArena &operator=(const GeometryArena &) = delete;
+
+    /**
+     * @brief Reserve vertices and index bytes, growing the buffers if they are full.
+     * @return Handle resolving to the range until it is freed.
+     */
+    Handle Allocate(uint32_t vertexCount, uint32_t indexBytes);
+    void   Free(Handle handle);
+
+    [[nodiscard]] const GeometryRange &Range(Handle handle) const { return _ranges[handle]; }
+
+    /// Map the vertices of a range for writing, unmap with UnmapVertices().
+    [[nodiscard]] void *MapVertices(Handle handle) const;
+    void UnmapVertices() const;
+    /// Map the index bytes of a range for writing, unmap with UnmapIndices().
+    [[nodiscard]] void *MapIndices(Handle handle) const;
+    void UnmapIndices() const;
+
+    /**
+     * @brief Move all live ranges to the front of new buffers, removing the holes left by freed ones.
+     * @return Bytes moved on the GPU.
+     */
+    size_t Compact();
+
+    [[nodiscard]] GLuint VAO() const { return _vao; }
+    [[nodiscard]] GLuint VBO() const { return _vbo; }
+    [[nodiscard]] GLuint EBO() const { return _ebo; }
+    [[nodiscard]] uint32_t Stride() const { return _stride; }
+    [[nodiscard]] GeometryArenaStats Stats() const;
+
+private:
+    /// Create a buffer of the given size and copy the first copyBytes of the old one into it.
+    static GLuint Reallocate(GLuint buffer, size_t bytes, size_t copyBytes);
+    void Grow(uint32_t vertexCount, uint32_t indexBytes);
+
+    GLuint   _vao    = 0;
+    GLuint   _vbo    = 0;
+    GLuint   _ebo    = 0;
+    uint32_t _stride = 0;
+
+    RangeAllocator _vertexAllocator;
+    RangeAllocator _indexAllocator;
+
+    std::vector<GeometryRange> _ranges; ///< indexed by handle
+    std::vector<bool>          _live;
+    std::vector<Handle>        _freeHandles;
+
+    uint32_t _grows    = 0;
+    uint32_t _compacts = 0;
+};
@@ -0,0 +1,117 @@
+#include "GltfLazyImages.h"
+#include <stb_image.h>
+#include "GltfLoader.h"
+
+GltfLazyImages::GltfLazyImages(std::filesystem::path file) : _file(std::move(file))
+{}
+
+void GltfLazyImages::Install(tinygltf::TinyGLTF &loader)
+{
+    loader.SetImageLoader(&GltfLazyImages::RecordImage, this);
+}
+
+void GltfLazyImages::Attach(std::shared_ptr<const tinygltf::Model> model)
+{
+    std::lock_guard lock(_mutex);
+    _model = std::move(model);
+}
+
+bool GltfLazyImages::RecordImage(tinygltf::Image *image, int imageIndex, std::string *, std::string *, int, int, const unsigned char *bytes, int size,
+                                 void *userData)
+{
+    auto *self = static_cast<GltfLazyImages *>(userData);
+    if (imageIndex < 0)
+        return false;
+
+    if (static_cast<size_t>(imageIndex) >= self->_records.size())
+        self->_records.resize(imageIndex + 1);
+
+    Record &record = self->_records[imageIndex];
+    record.bufferView = image->bufferView;
+    record.mimeType = image->mimeType;
+
+    // bytes of data URIs and external files are temporary, buffer views stay in the model
+    if (record.bufferView < 0)
+        record.bytes.assign(bytes, bytes + size);
+
+    // header only, no pixels are decoded here
+    stbi_info_from_memory(bytes, size, &record.width, &record.height, &record.components);
+    image->width = record.width;
+    image->height = record.height;
+    image->component = record.components;
+
+    return true;
+}
+
+bool GltfLazyImages::EnsureModel() const
+{
+    if (_model)
+        return true;
+
+    // opened from a cache -> parse the file again, still without decoding any pixels
+    auto model = std::make_shared<tinygltf::Model>();
+    std::string err, warn;
+    _records.clear();
+    if (!GltfLoader::LoadModel(_file, *model, err, warn, const_cast<GltfLazyImages *>(this))) // records are mutable lazy state
+    {
+        LOG_ERROR("Failed to open '{}' for image decoding: {}", _file.string(), err);
+        return false;
+    }
+
+    _model = std::move(model);
+    return true;
+}
+
+size_t GltfLazyImages::ImageCount() const
+{
+    std::lock_guard lock(_mutex);
+    return EnsureModel() ? _records.size() : 0;
+}
+
+std::optional<TextureSource> GltfLazyImages::Decode(int image) const
+{
+    std::shared_ptr<const tinygltf::Model> model;
+    const Record *record;
+    {
+        std::lock_guard lock(_mutex);
+        if (!EnsureModel())
+            return std::nullopt;
+
+        if (image < 0 || static_cast<size_t>(image) >= _records.size())
+        {
+            LOG_ERROR("Image index {} out of range [0, {}).", image, _records.size());
+            return std::nullopt;
+        }
+
+        model = _model;
+        record = &_records[image];
+    }
+
+    // Encoded bytes
+    const unsigned char *bytes = record->bytes.data();
+    size_t size = record->bytes.size();
+    if (record->bufferView >= 0)
+    {
+        const tinygltf::BufferView &view = model->bufferViews[record->bufferView];
+        bytes = model->buffers[view.buffer].data.data() + view.byteOffset;
+        size = view.byteLength;
+    }
+
+    // Decode
+    int width, height, components;
+    stbi_uc *pixels = stbi_load_from_memory(bytes, static_cast<int>(size), &width, &height, &components, STBI_rgb_alpha);
+    if (!pixels)
+    {
+        LOG_ERROR("Failed to decode image {} ({}) of '{}': {}", image, record->mimeType, _file.string(), stbi_failure_reason());
+        return std::nullopt;
+    }
+
+    std::vector<void_ptr> images;
+    images.emplace_back(pixels);
+    return TextureSource(TextureType::Tex2D, TextureFormat::RGBA8, width, height, images);
+}
+
+std::future<std::optional<TextureSource>> GltfLazyImages::DecodeAsync(int image) const
+{
+    return std::async(std::launch::async, [self = shared_from_this(), image] { return self->Decode(image); });
+}
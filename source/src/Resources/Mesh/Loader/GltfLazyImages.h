@@ -0,0 +1,61 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       GltfLazyImages.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Deferred decoding of images embedded in glTF/GLB files.
+ *
+ *  This file declares the GltfLazyImages class. Installed as the image loader
+ *  of a TinyGLTF instance, it only records where each encoded image lives
+ *  (buffer view or copied bytes), its mime type and header dimensions, so
+ *  geometry-only loads don't pay for stb_image decoding. Pixels are decoded
+ *  on request, optionally on a background thread.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include <future>
+#include <mutex>
+#include <optional>
+#include <tiny_gltf.h>
+#include "src/Resources/Texture/TextureSource.h"
+
+
+class GltfLazyImages : public std::enable_shared_from_this<GltfLazyImages>
+{
+public:
+    /// @param file glTF/GLB file the images belong to, reopened on request if no model is attached
+    explicit GltfLazyImages(std::filesystem::path file);
+
+    /// Replace the stb_image decode of the loader by recording the encoded images into this object.
+    void Install(tinygltf::TinyGLTF &loader);
+    /// Attach the loaded model the recorded buffer views point into.
+    void Attach(std::shared_ptr<const tinygltf::Model> model);
+
+    /// Number of images in the file, opens the file if needed.
+    [[nodiscard]] size_t ImageCount() const;
+    /// Decode an image to RGBA8 on the calling thread.
+    [[nodiscard]] std::optional<TextureSource> Decode(int image) const;
+    /// Decode an image to RGBA8 on a background thread, the object stays alive until it is done.
+    [[nodiscard]] std::future<std::optional<TextureSource>> DecodeAsync(int image) const;
+
+private:
+    struct Record
+    {
+        int bufferView = -1;
+        std::string mimeType;
+        std::vector<unsigned char> bytes; ///< copy of data URI or external file images
+        int width = 0, height = 0, components = 0;
+    };
+
+    static bool RecordImage(tinygltf::Image *image, int imageIndex, std::string *err, std::string *warn, int reqWidth, int reqHeight,
+                            const unsigned char *bytes, int size, void *userData);
+    /// Load the model (with images recorded only) if nothing has been attached yet.
+    bool EnsureModel() const;
+
+    std::filesystem::path _file;
+    mutable std::mutex _mutex;
+    mutable std::shared_ptr<const tinygltf::Model> _model;
+    mutable std::vector<Record> _records;
+};
@@ -1,19 +1,41 @@
 #include "GltfLoader.h"
 #include <filesystem>
 #include <tiny_gltf.h>
+#include "GltfLazyImages.h"
+#include "src/Utils/MappedFile.h"
 
-MeshSource GltfLoader::LoadMesh(const std::filesystem::path &path, bool binary)
+bool GltfLoader::LoadModel(const std::filesystem::path &path, tinygltf::Model &model, std::string &err, std::string &warn, GltfLazyImages *images)
 {
-    tinygltf::Model model;
     tinygltf::TinyGLTF loader;
+#ifdef IMPL_GLTF_LAZY_IMAGES
+    if (images)
+        images->Install(loader);
+#endif
+
+    if (path.extension() != ".glb")
+        return loader.LoadASCIIFromFile(&model, &err, &warn, path.string());
+
+    // parse from a mapping, so the file is not read into an intermediate vector first
+    const MappedFile file(path);
+    if (!file.IsOpen())
+    {
+        err = "Failed to open '" + path.string() + "'.";
+        return false;
+    }
+
+    return loader.LoadBinaryFromMemory(&model, &err, &warn, file.Data(), static_cast<unsigned int>(file.Size()), path.parent_path().string());
+}
+
+MeshSource GltfLoader::LoadMesh(const std::filesystem::path &path)
+{
+    tinygltf::Model model;
     std::string err;
     std::string warn;
 
-    bool ret;
-    if (binary)
-        ret = loader.LoadBinaryFromFile(&model, &err, &warn, ABSOLUTE_RESOURCE_PATH(path).string());
-    else
-        ret = loader.LoadASCIIFromFile(&model, &err, &warn, ABSOLUTE_RESOURCE_PATH(path).string());
+    // geometry only -> images are recorded, never decoded
+    GltfLazyImages images(ABSOLUTE_RESOURCE_PATH(path));
+
+    const bool ret = LoadModel(ABSOLUTE_RESOURCE_PATH(path), model, err, warn, &images);
 
     // Check loading
     if (!ret)
@@ -18,11 +18,24 @@
 #include <tiny_gltf.h>
 #include "src/Resources/Mesh/MeshSource.h"
 
+// Features
+#define IMPL_GLTF_LAZY_IMAGES
+
+class GltfLazyImages;
 
 class GltfLoader
 {
 public:
-    static MeshSource LoadMesh(const std::filesystem::path &path, bool binary);
+    /// Load the first primitive of a glTF (.gltf) or binary GLB (.glb) file, images are not decoded.
+    static MeshSource LoadMesh(const std::filesystem::path &path);
+
+    /**
+     * @brief Parse a glTF (.gltf) or binary GLB (.glb) file into a tinygltf model.
+     * @param path   Absolute path of the file, GLB files are parsed from a memory mapping.
+     * @param images If set (and IMPL_GLTF_LAZY_IMAGES is enabled), images are only recorded into it instead of decoded.
+     * @return       False on failure, with the reason in err.
+     */
+    static bool LoadModel(const std::filesystem::path &path, tinygltf::Model &model, std::string &err, std::string &warn, GltfLazyImages *images = nullptr);
 
 private:
     static std::vector<float> LoadFloatAttribute(const std::string &attributeName, unsigned int components, bool optional, const tinygltf::Model &model, const tinygltf::Primitive &primitive);
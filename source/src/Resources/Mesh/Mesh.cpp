@@ -1,7 +1,74 @@
 #include "Mesh.h"
 
+namespace
+{
+    /// Indices fit into 16 bits when every vertex is addressable with them
+    constexpr uint32_t MaxShortIndexVertices = 65536;
+
+    size_t StrideBytes(const InterleavedView& layout, Mesh::VertexFormat format)
+    {
+        return format == Mesh::VertexFormat::Compact ? MeshQuantizer::Stride(layout) : layout.Stride() * sizeof(float);
+    }
+
+    /**
+     * @brief Describe the attributes of vertex buffer binding 0 of the bound VAO.
+     *
+     * Position: float or unorm16 decoded with the mesh quantization, normal and tangent: float or
+     * octahedral snorm16, uv: float or half float.
+     */
+    void SpecifyVertexFormat(const InterleavedView& src, Mesh::VertexFormat format)
+    {
+        const bool compact = format == Mesh::VertexFormat::Compact;
+        GLuint offset = 0;
+
+        const auto attribute = [&offset](GLuint location, GLint size, GLenum type, GLboolean normalized, GLuint bytes)
+        {
+            glEnableVertexAttribArray(location);
+            glVertexAttribFormat(location, size, type, normalized, offset);
+            glVertexAttribBinding(location, 0);
+            offset += bytes;
+        };
+
+        if (compact)
+            attribute(Mesh::PositionLocation, 3, GL_UNSIGNED_SHORT, GL_TRUE, MeshQuantizer::PositionBytes);
+        else
+            attribute(Mesh::PositionLocation, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float));
+
+        if (src.hasNormals)
+        {
+            if (compact)
+                attribute(Mesh::NormalLocation, 2, GL_SHORT, GL_TRUE, MeshQuantizer::DirectionBytes);
+            else
+                attribute(Mesh::NormalLocation, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float));
+        }
+
+        if (src.hasUVs)
+        {
+            if (compact)
+                attribute(Mesh::TexCoordsLocation, 2, GL_HALF_FLOAT, GL_FALSE, MeshQuantizer::UVBytes);
+            else
+                attribute(Mesh::TexCoordsLocation, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float));
+        }
+
+        if (src.hasTangents)
+        {
+            if (compact)
+                attribute(Mesh::TangentLocation, 2, GL_SHORT, GL_TRUE, MeshQuantizer::DirectionBytes);
+            else
+                attribute(Mesh::TangentLocation, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float));
+        }
+    }
+}
+
 void Mesh::DestroyGLBuffers()
 {
+    if (_arena)
+    {
+        _arena->Free(_geometry);
+        _arena    = nullptr;
+        _geometry = GeometryArena::InvalidHandle;
+    }
+
     if (_ebo) glDeleteBuffers(1, &_ebo);
     if (_vbo) glDeleteBuffers(1, &_vbo);
     if (_vao) glDeleteVertexArrays(1, &_vao);
@@ -9,105 +76,157 @@ void Mesh::DestroyGLBuffers()
     _vao = _vbo = _ebo = 0;
 }
 
-void Mesh::CreateGLBuffers(const MeshSource& src)
+void Mesh::CreateGLBuffers(const MeshSource& src, VertexFormat format, QuantizeStats* stats)
 {
-    DestroyGLBuffers();
+    // mapped cache data is already interleaved -> upload in place
+    if (src.HasInterleaved())
+    {
+        CreateGLBuffers(src.Interleaved(), format, stats);
+        return;
+    }
 
-    // save statistics
-    _vertexCount = src.VertexCount();
-    _indexCount  = static_cast<uint32_t>(src._indices.size());
-    _indexed     = !_indexCount ? false : true;
+    // 32-bit indices can be uploaded straight from their view
+    const MeshViews views = src.Views();
+    InterleavedView layout = src.Layout();
+    layout.indices = views.indices.size == sizeof(unsigned int) ? reinterpret_cast<const unsigned int*>(views.indices.data) : nullptr;
 
-    // set bools
-    const bool hasN = !src._normals  .empty();
-    const bool hasT = !src._tangents .empty();
-    const bool hasUV= !src._uvs      .empty();
+    Upload(layout, views, format, &src, stats);
+}
 
-    const size_t stride =
-          3                       /* pos */
-        + (hasN  ? 3 : 0)
-        + (hasUV ? 2 : 0)
-        + (hasT  ? 3 : 0);
+void Mesh::CreateGLBuffers(const InterleavedView& src, VertexFormat format, QuantizeStats* stats)
+{
+    Upload(src, src.Views(), format, nullptr, stats);
+}
 
-    std::vector<float> interleaved;
-    interleaved.reserve(_vertexCount * stride);
+void Mesh::Upload(const InterleavedView& layout, const MeshViews& views, VertexFormat format, const MeshSource* interleaver, QuantizeStats* stats)
+{
+    // levels of detail go right after the full indices
+    std::vector<unsigned int> lodIndices;
+#ifdef IMPL_MESH_LOD
+    LodChain lods = MeshSimplifier::BuildLodChain(views, lodIndices);
+#endif
 
-    for (uint32_t v = 0; v < _vertexCount; ++v)
+    // vertices in the final format
+    std::vector<uint8_t> compact;
+    PositionQuantization quantization;
+    const void* vertexData = interleaver ? nullptr : layout.vertices;
+    if (format == VertexFormat::Compact)
     {
-        // pos
-        interleaved.push_back(src._positions[v*3+0]);
-        interleaved.push_back(src._positions[v*3+1]);
-        interleaved.push_back(src._positions[v*3+2]);
+        compact.resize(static_cast<size_t>(layout.vertexCount) * MeshQuantizer::Stride(layout));
+        quantization = MeshQuantizer::Encode(views, layout, compact.data());
+        vertexData = compact.data();
+    }
 
-        // normal (if exists)
-        if (hasN)
-        {
-            interleaved.push_back(src._normals[v*3+0]);
-            interleaved.push_back(src._normals[v*3+1]);
-            interleaved.push_back(src._normals[v*3+2]);
-        }
+    const bool indicesUploaded = AllocateGLBuffers(layout, format, vertexData, static_cast<size_t>(layout.indexCount) + lodIndices.size());
+    _quantization = quantization;
+    _bounds = views.positions.Empty() ? Bounds{}
+            : Bounds::FromPositions(views.positions[0], views.positions.count, views.positions.stride / sizeof(float));
+#ifdef IMPL_TRIANGLE_BVH
+    _triangles.Build(views);
+#endif
+#ifdef IMPL_MESH_LOD
+    _lods = std::move(lods);
+#endif
 
-        // uv (if exists)
-        if (hasUV)
+    // interleave straight into the vertex buffer
+    const size_t vertexBytes = static_cast<size_t>(_vertexCount) * StrideBytes(layout, format);
+    if (!vertexData && vertexBytes)
+    {
+        void* vertices = MapVertices();
+        if (vertices)
         {
-            interleaved.push_back(src._uvs[v*2+0]);
-            interleaved.push_back(src._uvs[v*2+1]);
+            interleaver->Interleave(static_cast<float*>(vertices));
+            UnmapVertices();
         }
+        else
+            LOG_ERROR("Failed to map vertex buffer.");
+    }
 
-        // tangent (if exists)
-        if (hasT)
+    // narrow or widen the indices straight into the index buffer, levels of detail after the full mesh
+    const size_t indexSize = _indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+    if (_indexed && !indicesUploaded)
+    {
+        void* mapped = MapIndices();
+        if (mapped)
         {
-            interleaved.push_back(src._tangents[v*3+0]);
-            interleaved.push_back(src._tangents[v*3+1]);
-            interleaved.push_back(src._tangents[v*3+2]);
+            const IndexView lodView{reinterpret_cast<const uint8_t*>(lodIndices.data()), static_cast<uint32_t>(lodIndices.size()), sizeof(unsigned int)};
+            if (_indexType == GL_UNSIGNED_SHORT)
+            {
+                views.indices.CopyTo(static_cast<uint16_t*>(mapped));
+                lodView.CopyTo(static_cast<uint16_t*>(mapped) + _indexCount);
+            }
+            else
+            {
+                views.indices.CopyTo(static_cast<unsigned int*>(mapped));
+                lodView.CopyTo(static_cast<unsigned int*>(mapped) + _indexCount);
+            }
+            UnmapIndices();
         }
+        else
+            LOG_ERROR("Failed to map index buffer.");
     }
 
+#ifdef IMPL_MESH_MESHLETS
+    if (_indexed)
+        _meshlets = MeshletBuilder::Build(views);
+#endif
+
+    // memory against 32-bit floats and indices of the full mesh
+    if (stats)
+    {
+        if (format == VertexFormat::Compact)
+            MeshQuantizer::Measure(views, layout, compact.data(), _quantization, *stats);
+
+        stats->vertices     += _vertexCount;
+        stats->floatBytes   += static_cast<size_t>(_vertexCount) * layout.Stride() * sizeof(float) + static_cast<size_t>(_indexCount) * sizeof(unsigned int);
+        stats->compactBytes += static_cast<size_t>(_vertexCount) * StrideBytes(layout, _format) + static_cast<size_t>(_indexCount) * indexSize;
+    }
+
+    // disconnect
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+bool Mesh::AllocateGLBuffers(const InterleavedView& src, VertexFormat format, const void* vertices, size_t indexBufferSize)
+{
+    DestroyGLBuffers();
+
+    // save statistics
+    _vertexCount  = src.vertexCount;
+    _indexCount   = src.indexCount;
+    _indexed      = !_indexCount ? false : true;
+    _indexType    = _vertexCount <= MaxShortIndexVertices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    _format       = format;
+    _quantization = {};
+    _meshlets.clear();
+    _lods = {};
+
+    const size_t strideBytes = StrideBytes(src, format);
+    const size_t indexSize   = _indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+    const bool indicesUploaded = _indexed && _indexType == GL_UNSIGNED_INT && src.indices && indexBufferSize == _indexCount;
+
+#ifdef IMPL_MESH_GEOMETRY_ARENA
+    // ranges of the shared buffers of this layout
+    _arena    = &Arena(src, format);
+    _geometry = _arena->Allocate(_vertexCount, _indexed ? static_cast<uint32_t>(indexBufferSize * indexSize) : 0);
+    const GeometryRange& range = _arena->Range(_geometry);
+
+    if (vertices)
+        glNamedBufferSubData(_arena->VBO(), static_cast<GLintptr>(range.baseVertex) * strideBytes, range.vertexCount * strideBytes, vertices);
+    if (indicesUploaded)
+        glNamedBufferSubData(_arena->EBO(), range.indexOffset, range.indexBytes, src.indices);
+#else
     glGenVertexArrays(1, &_vao);
     glBindVertexArray(_vao);
 
     glGenBuffers(1, &_vbo);
     glBindBuffer(GL_ARRAY_BUFFER, _vbo);
     glBufferData(GL_ARRAY_BUFFER,
-                 interleaved.size() * sizeof(float),
-                 interleaved.data(),
+                 static_cast<size_t>(_vertexCount) * strideBytes,
+                 vertices,
                  GL_STATIC_DRAW);
-
-    GLuint offset = 0;
-    const GLuint strideBytes = stride * sizeof(float);
-
-    // location 0 ─ position
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-                          strideBytes, (void*)(offset));
-    offset += 3 * sizeof(float);
-
-    // location 1 ─ normal
-    if (hasN)
-    {
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE,
-                              strideBytes, (void*)(offset));
-        offset += 3 * sizeof(float);
-    }
-
-    // location 2 ─ uv
-    if (hasUV)
-    {
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE,
-                              strideBytes, (void*)(offset));
-        offset += 2 * sizeof(float);
-    }
-
-    // location 3 ─ tangent
-    if (hasT)
-    {
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE,
-                              strideBytes, (void*)(offset));
-        offset += 3 * sizeof(float);
-    }
+    glBindVertexBuffer(0, _vbo, 0, static_cast<GLsizei>(strideBytes));
+    SpecifyVertexFormat(src, format);
 
     // create EBO
     if (_indexed)
@@ -115,12 +234,87 @@ void Mesh::CreateGLBuffers(const MeshSource& src)
         glGenBuffers(1, &_ebo);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                     src._indices.size() * sizeof(unsigned int),
-                     src._indices.data(),
+                     indexBufferSize * indexSize,
+                     indicesUploaded ? src.indices : nullptr,
                      GL_STATIC_DRAW);
     }
+#endif
+    return indicesUploaded;
+}
 
-    // disconnect
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+GeometryArena& Mesh::Arena(const InterleavedView& layout, VertexFormat format)
+{
+    const uint32_t key = (layout.hasNormals ? 1u : 0u) | (layout.hasUVs ? 2u : 0u) | (layout.hasTangents ? 4u : 0u) |
+                         (format == VertexFormat::Compact ? 8u : 0u);
+
+    std::unique_ptr<GeometryArena>& arena = _arenas[key];
+    if (!arena)
+        arena = std::make_unique<GeometryArena>(static_cast<uint32_t>(StrideBytes(layout, format)),
+                                                [&layout, format]() { SpecifyVertexFormat(layout, format); });
+    return *arena;
+}
+
+size_t Mesh::CompactArenas()
+{
+    size_t moved = 0;
+    for (auto& [key, arena] : _arenas)
+        moved += arena->Compact();
+    return moved;
+}
+
+void Mesh::DestroyArenas()
+{
+    _arenas.clear();
+}
+
+void* Mesh::MapVertices() const
+{
+    return _arena ? _arena->MapVertices(_geometry) : glMapNamedBuffer(_vbo, GL_WRITE_ONLY);
+}
+
+void Mesh::UnmapVertices() const
+{
+    if (_arena)
+        _arena->UnmapVertices();
+    else
+        glUnmapNamedBuffer(_vbo);
+}
+
+void* Mesh::MapIndices() const
+{
+    return _arena ? _arena->MapIndices(_geometry) : glMapNamedBuffer(_ebo, GL_WRITE_ONLY);
+}
+
+void Mesh::UnmapIndices() const
+{
+    if (_arena)
+        _arena->UnmapIndices();
+    else
+        glUnmapNamedBuffer(_ebo);
+}
+
+void Mesh::CullMeshlets(const Frustum& frustum, const glm::vec3& eye, DrawRanges& ranges, MeshletCullStats* stats) const
+{
+    ranges.Clear();
+    const size_t indexSize  = _indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+    const size_t firstByte  = IndexByteOffset();
+    const GLint  baseVertex = BaseVertex();
+
+    uint32_t end = UINT32_MAX;
+    for (const Meshlet& meshlet : _meshlets)
+    {
+        if (!MeshletBuilder::IsVisible(meshlet, frustum, eye, stats))
+            continue;
+
+        // extend the previous range if the meshlets are adjacent
+        if (meshlet.indexOffset == end)
+            ranges.counts.back() += static_cast<GLsizei>(meshlet.triangleCount * 3);
+        else
+        {
+            ranges.counts.push_back(static_cast<GLsizei>(meshlet.triangleCount * 3));
+            ranges.offsets.push_back(reinterpret_cast<const void*>(firstByte + meshlet.indexOffset * indexSize));
+            ranges.baseVertices.push_back(baseVertex);
+        }
+        end = meshlet.indexOffset + meshlet.triangleCount * 3;
+    }
 }
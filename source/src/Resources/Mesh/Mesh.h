@@ -7,19 +7,53 @@
  *
  *  This file defines the Mesh class, which encapsulates creation, initialization,
  *  and destruction of OpenGL VAO, VBO, and optional EBO for rendering mesh data
- *  supplied by a MeshSource. It supports both indexed and non-indexed drawing
- *  and provides accessors for buffer handles and counts.
+ *  supplied by a MeshSource. It supports both indexed and non-indexed drawing,
+ *  full float or compact quantized vertex formats, 16 or 32-bit indices,
+ *  keeps the meshlets of the index buffer for sub-object culling and a
+ *  chain of simplified levels of detail stored after the full indices, keeps
+ *  a triangle BVH of the positions for ray casts on the CPU, and provides
+ *  accessors for buffer handles and counts. Under
+ *  IMPL_MESH_GEOMETRY_ARENA the buffers are ranges of a GeometryArena shared
+ *  by all meshes of the same vertex layout instead of buffers of their own.
  *
  */
 //----------------------------------------------------------------------------------------
 
 #pragma once
 #include "GL/glew.h"
-#include "MeshSource.h"
+#include "GeometryArena.h"
+#include "MeshQuantizer.h"
+#include "MeshletBuilder.h"
+#include "MeshSimplifier.h"
+#include "TriangleBvh.h"
+#include "src/Utils/Bounds.h"
 
 // Features
 // #define IMPL_MESH
 // #define IMPL_MESH_ENABLE_TANGENT4
+#define IMPL_MESH_COMPACT_VERTICES
+#define IMPL_MESH_MESHLETS
+#define IMPL_MESH_LOD
+#define IMPL_MESH_GEOMETRY_ARENA
+
+/**
+ * @struct DrawRanges
+ * @brief Index ranges of one multi-draw, reused between draws to avoid allocations.
+ */
+struct DrawRanges
+{
+    std::vector<GLsizei>     counts;
+    std::vector<const void*> offsets;     ///< byte offsets into the index buffer
+    std::vector<GLint>       baseVertices;
+
+    void Clear()
+    {
+        counts.clear();
+        offsets.clear();
+        baseVertices.clear();
+    }
+    [[nodiscard]] GLsizei Size() const { return static_cast<GLsizei>(counts.size()); }
+};
 
 /**
  * @class Mesh
@@ -32,36 +66,136 @@
 class Mesh
 {
 public:
+    /// Layout of the vertex buffer (position | normal | uv | tangent)
+    enum class VertexFormat
+    {
+        Float,   ///< 32-bit floats: position 12 B, normal 12 B, uv 8 B, tangent 12 B
+        Compact, ///< unorm16 position 8 B decoded with PositionQuantization, octahedral snorm16 normal/tangent 4 B, half uv 4 B
+    };
+#ifdef IMPL_MESH_COMPACT_VERTICES
+    static constexpr VertexFormat DefaultFormat = VertexFormat::Compact;
+#else
+    static constexpr VertexFormat DefaultFormat = VertexFormat::Float;
+#endif
+
+    /// Attribute locations, matching Shader_V.glsl
+    static constexpr GLuint PositionLocation  = 0;
+    static constexpr GLuint NormalLocation    = 2;
+    static constexpr GLuint TexCoordsLocation = 3;
+    static constexpr GLuint TangentLocation   = 4;
+
     Mesh()  = default;
     ~Mesh() { DestroyGLBuffers(); }
 
     /**
      * @brief Allocate and initialize OpenGL buffers from source data.
-     * @param src The MeshSource containing vertex attributes and optional indices.
+     * @param src    The MeshSource containing vertex attributes and optional indices.
+     * @param format Vertex layout of the uploaded buffer.
+     * @param stats  Optional memory and quantization error report, accumulated.
      *
      * Creates a VAO, VBO (and EBO if indexed), uploads the data to the GPU,
-     * and configures vertex attribute pointers.
+     * and configures vertex attribute pointers. Indices are stored with 16 bits
+     * whenever every vertex can be addressed with them.
+     */
+    void CreateGLBuffers(const MeshSource& src, VertexFormat format = DefaultFormat, QuantizeStats* stats = nullptr);
+    /**
+     * @brief Allocate and initialize OpenGL buffers straight from an interleaved stream.
+     * @param src Interleaved vertices and optional indices, e.g. from a mapped MeshCache.
      */
-    void CreateGLBuffers(const MeshSource& src);
+    void CreateGLBuffers(const InterleavedView& src, VertexFormat format = DefaultFormat, QuantizeStats* stats = nullptr);
     /**
      * @brief Release all OpenGL buffers owned by this mesh.
      *
-     * Deletes the VAO, VBO, and EBO if they have been created, and resets
-     * internal state to reflect that no buffers are allocated.
+     * Deletes the VAO, VBO, and EBO if they have been created, or returns the
+     * ranges to the geometry arena, and resets internal state to reflect that
+     * no buffers are allocated.
      */
     void DestroyGLBuffers();
 
-    [[nodiscard]] GLuint   VAO()        const { return _vao; }
+    /// Arenas by vertex layout, shared by all meshes under IMPL_MESH_GEOMETRY_ARENA
+    [[nodiscard]] static const std::map<uint32_t, std::unique_ptr<GeometryArena>>& Arenas() { return _arenas; }
+    /// Pack the live ranges of every arena, e.g. after unloading meshes; returns the bytes moved.
+    static size_t CompactArenas();
+    /// Delete the arenas, all meshes must have released their buffers before.
+    static void DestroyArenas();
+
+    [[nodiscard]] GLuint   VAO()        const { return _arena ? _arena->VAO() : _vao; }
+    /// Added to every index by the draw call, non-zero for meshes in a shared arena
+    [[nodiscard]] GLint    BaseVertex() const { return _arena ? static_cast<GLint>(_arena->Range(_geometry).baseVertex) : 0; }
+    /// Byte offset of the first index in the bound index buffer
+    [[nodiscard]] size_t   IndexByteOffset() const { return _arena ? _arena->Range(_geometry).indexOffset : 0; }
     [[nodiscard]] bool     IsIndexed()  const { return _indexed; }
     [[nodiscard]] uint32_t VertexCount()const { return _vertexCount; }
     [[nodiscard]] uint32_t IndexCount() const { return _indexCount; }
+    /// GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, the type to pass to glDrawElements
+    [[nodiscard]] GLenum   IndexType()  const { return _indexType; }
+
+    [[nodiscard]] VertexFormat Format() const { return _format; }
+    [[nodiscard]] bool IsQuantized() const { return _format == VertexFormat::Compact; }
+    /// Position decode for the vertex shader, identity for float meshes
+    [[nodiscard]] const PositionQuantization& Quantization() const { return _quantization; }
+
+    /// Meshlets of the index buffer, built on upload under IMPL_MESH_MESHLETS
+    [[nodiscard]] const std::vector<Meshlet>& Meshlets() const { return _meshlets; }
+    /**
+     * @brief Collect the index ranges of the meshlets that survive culling, merging adjacent ones.
+     * @param frustum Frustum in the object space of the mesh.
+     * @param eye     Camera position in the object space of the mesh.
+     * @param[out] ranges Ranges to draw with glMultiDrawElements, cleared first.
+     * @param stats   Optional culling statistics, accumulated.
+     */
+    void CullMeshlets(const Frustum& frustum, const glm::vec3& eye, DrawRanges& ranges, MeshletCullStats* stats = nullptr) const;
+
+    /// Levels of detail in the index buffer, built on upload under IMPL_MESH_LOD; empty or level 0 only without simplification
+    [[nodiscard]] const LodChain& Lods() const { return _lods; }
+    /// Object space box and sphere of the vertices, computed on upload
+    [[nodiscard]] const Bounds& LocalBounds() const { return _bounds; }
+    /// Object space triangles of the full mesh for picking, built on upload under IMPL_TRIANGLE_BVH
+    [[nodiscard]] const TriangleBvh& Triangles() const { return _triangles; }
 
 private:
+    /**
+     * @brief Build the CPU side data (LODs, compact vertices, meshlets) and upload everything.
+     * @param layout      Attributes present and counts, 32-bit layout.indices are uploaded as is when possible.
+     * @param views       The same attributes as float views.
+     * @param interleaver Source to interleave float vertices straight into the mapped buffer, else layout.vertices is used.
+     */
+    void Upload(const InterleavedView& layout, const MeshViews& views, VertexFormat format, const MeshSource* interleaver, QuantizeStats* stats);
+    /**
+     * @brief Create the VAO, VBO and EBO for the layout, or allocate their ranges in the arena of the layout.
+     * @param vertices        Data in the given format to upload, or null to fill the buffer later.
+     * @param indexBufferSize Indices of the EBO, the full mesh plus its levels of detail.
+     * @return True if the 32-bit src.indices were uploaded as well, which happens if they fill the whole EBO
+     *         and the mesh uses 32-bit indices.
+     */
+    bool AllocateGLBuffers(const InterleavedView& src, VertexFormat format, const void* vertices, size_t indexBufferSize);
+    /// Arena of the vertex layout, created on first use
+    static GeometryArena& Arena(const InterleavedView& layout, VertexFormat format);
+
+    // Write access to the vertices and indices of this mesh, wherever they are stored
+    [[nodiscard]] void* MapVertices() const;
+    void UnmapVertices() const;
+    [[nodiscard]] void* MapIndices() const;
+    void UnmapIndices() const;
+
     GLuint   _vao   = 0;
     GLuint   _vbo   = 0;
     GLuint   _ebo   = 0;
 
+    GeometryArena*        _arena    = nullptr;
+    GeometryArena::Handle _geometry = GeometryArena::InvalidHandle;
+    inline static std::map<uint32_t, std::unique_ptr<GeometryArena>> _arenas;
+
     bool     _indexed      = false;
     uint32_t _vertexCount  = 0;
     uint32_t _indexCount   = 0;
+    GLenum   _indexType    = GL_UNSIGNED_INT;
+
+    VertexFormat         _format = VertexFormat::Float;
+    PositionQuantization _quantization;
+
+    std::vector<Meshlet> _meshlets;
+    LodChain             _lods;
+    Bounds               _bounds;
+    TriangleBvh          _triangles;
 };
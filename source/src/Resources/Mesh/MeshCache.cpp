@@ -0,0 +1,311 @@
+#include "MeshCache.h"
+#include "src/Utils/Hash.h"
+#include "src/Utils/MappedFile.h"
+
+namespace fs = std::filesystem;
+
+static uint64_t AlignUp(uint64_t value)
+{
+    return (value + 15) & ~uint64_t(15);
+}
+
+uint64_t MeshCache::HashFile(const fs::path &source)
+{
+    const MappedFile file(source);
+    if (!file.IsOpen())
+        return 0;
+
+    return Fnv1a(file.Data(), file.Size());
+}
+
+uint32_t MeshCache::Settings()
+{
+    uint32_t settings = 0;
+#ifdef IMPL_MESH_OPTIMIZE
+    settings |= Optimized;
+#endif
+#ifdef IMPL_MESH_ENABLE_TANGENT4
+    settings |= Tangent4;
+#endif
+    return settings;
+}
+
+fs::path MeshCache::CachePath(const fs::path &source, uint32_t variant)
+{
+    // Stem keeps the file recognizable, the path hash keeps equally named assets and variants apart
+    const std::string absolute = fs::absolute(source).lexically_normal().generic_string();
+    const uint64_t pathHash = Fnv1a(std::format("{}#{}", absolute, variant));
+
+    return ABSOLUTE_RESOURCE_PATH(MESH_CACHE_DIRECTORY) / std::format("{}_{:016x}.meshcache", source.stem().string(), pathHash);
+}
+
+std::optional<std::vector<SceneMesh>> MeshCache::ReadScene(const fs::path &source, uint64_t sourceHash, const Shader &shader)
+{
+    return Read(source, sourceHash, &shader, 0);
+}
+
+bool MeshCache::WriteScene(const fs::path &source, uint64_t sourceHash, const std::vector<SceneMesh> &scene)
+{
+    std::vector<EntrySource> entries;
+    entries.reserve(scene.size());
+    for (const SceneMesh &sceneMesh : scene)
+        entries.push_back({&sceneMesh.meshSource, sceneMesh.nodeMatrix, &sceneMesh.material, sceneMesh.diffuseImage});
+
+    return Write(source, sourceHash, entries, 0);
+}
+
+std::optional<MeshSource> MeshCache::ReadMesh(const fs::path &source, uint64_t sourceHash, uint32_t variant)
+{
+    auto scene = Read(source, sourceHash, nullptr, variant);
+    if (!scene || scene->size() != 1)
+        return std::nullopt;
+
+    return std::move(scene->front().meshSource);
+}
+
+bool MeshCache::WriteMesh(const fs::path &source, uint64_t sourceHash, const MeshSource &mesh, uint32_t variant)
+{
+    return Write(source, sourceHash, {{&mesh, glm::mat4(1.0f), nullptr, -1}}, variant);
+}
+
+std::optional<std::vector<SceneMesh>> MeshCache::Read(const fs::path &source, uint64_t sourceHash, const Shader *shader, uint32_t variant)
+{
+    if (sourceHash == 0)
+        return std::nullopt;
+
+    const fs::path cachePath = CachePath(source, variant);
+    auto file = std::make_shared<MappedFile>(cachePath);
+    if (!file->IsOpen())
+        return std::nullopt;
+
+    const uint8_t *base = file->Data();
+    const size_t size = file->Size();
+
+    // Header
+    if (size < sizeof(FileHeader))
+        return std::nullopt;
+
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version)
+    {
+        LOG("Mesh cache '{}' has an old format, rebuilding.", cachePath.string());
+        return std::nullopt;
+    }
+    if (header.sourceHash != sourceHash)
+    {
+        LOG("Mesh cache '{}' is out of date, rebuilding.", cachePath.string());
+        return std::nullopt;
+    }
+    if (header.settings != Settings())
+    {
+        LOG("Mesh cache '{}' was built with other import settings, rebuilding.", cachePath.string());
+        return std::nullopt;
+    }
+    if (sizeof(FileHeader) + static_cast<uint64_t>(header.entryCount) * sizeof(EntryHeader) > size)
+    {
+        LOG_WARNING("Mesh cache '{}' is truncated.", cachePath.string());
+        return std::nullopt;
+    }
+
+    // Entries
+    const auto *entries = reinterpret_cast<const EntryHeader *>(base + sizeof(FileHeader));
+    const std::shared_ptr<const void> storage = file;
+
+    std::vector<SceneMesh> result(header.entryCount);
+    std::shared_ptr<GltfLazyImages> images; // reopens the source only if an image is requested
+    for (uint32_t e = 0; e < header.entryCount; ++e)
+    {
+        const EntryHeader &entry = entries[e];
+
+        InterleavedView view;
+        view.hasNormals  = entry.flags & HasNormals;
+        view.hasUVs      = entry.flags & HasUVs;
+        view.hasTangents = entry.flags & HasTangents;
+        view.vertexCount = entry.vertexCount;
+        view.indexCount  = entry.indexCount;
+
+        const uint64_t vertexBytes   = static_cast<uint64_t>(entry.vertexCount) * view.Stride() * sizeof(float);
+        const uint64_t indexBytes    = static_cast<uint64_t>(entry.indexCount) * sizeof(unsigned int);
+        const uint64_t materialBytes = static_cast<uint64_t>(entry.materialCount) * sizeof(MaterialRecord);
+        // Blocks inside the file and aligned for the types they are read as, material names terminated
+        const auto valid = [size](uint64_t offset, uint64_t bytes, size_t alignment)
+        {
+            return offset <= size && bytes <= size - offset && offset % alignment == 0;
+        };
+        const auto *records = reinterpret_cast<const MaterialRecord *>(base + entry.materialOffset);
+        bool intact = valid(entry.vertexOffset, vertexBytes, alignof(float)) && valid(entry.indexOffset, indexBytes, alignof(unsigned int)) &&
+                      valid(entry.materialOffset, materialBytes, alignof(MaterialRecord));
+        for (uint32_t m = 0; intact && m < entry.materialCount; ++m)
+        {
+            intact = std::memchr(records[m].name, '\0', sizeof(records[m].name)) != nullptr &&
+                     records[m].type <= MaterialPGR::MaterialValue::MAT4;
+        }
+        if (!intact)
+        {
+            LOG_WARNING("Mesh cache '{}' is corrupted.", cachePath.string());
+            return std::nullopt;
+        }
+
+        view.vertices = reinterpret_cast<const float *>(base + entry.vertexOffset);
+        view.indices  = entry.indexCount ? reinterpret_cast<const unsigned int *>(base + entry.indexOffset) : nullptr;
+
+        SceneMesh &sceneMesh = result[e];
+        sceneMesh.meshSource.SetInterleaved(view, storage);
+        sceneMesh.nodeMatrix = glm::make_mat4(entry.nodeMatrix);
+        if (entry.diffuseImage >= 0)
+        {
+            if (!images)
+                images = std::make_shared<GltfLazyImages>(source);
+
+            sceneMesh.images       = images;
+            sceneMesh.diffuseImage = entry.diffuseImage;
+        }
+
+        if (shader)
+        {
+            sceneMesh.material = MaterialPGR(*shader);
+
+            for (uint32_t m = 0; m < entry.materialCount; ++m)
+            {
+                MaterialPGR::MaterialValue value{};
+                value.type = static_cast<decltype(value.type)>(records[m].type);
+                std::memcpy(&value.m4, records[m].value, sizeof(records[m].value));
+
+                sceneMesh.material._values[UniformNames::Intern(records[m].name)] = value;
+            }
+        }
+    }
+
+    return result;
+}
+
+bool MeshCache::Write(const fs::path &source, uint64_t sourceHash, const std::vector<EntrySource> &entries, uint32_t variant)
+{
+    if (sourceHash == 0)
+        return false;
+
+    // Interleave every mesh and lay out the data blocks
+    std::vector<EntryHeader> headers(entries.size());
+    std::vector<std::vector<float>> vertices(entries.size());
+    std::vector<std::vector<unsigned int>> indices(entries.size());
+    std::vector<std::vector<MaterialRecord>> materials(entries.size());
+
+    uint64_t offset = AlignUp(sizeof(FileHeader) + entries.size() * sizeof(EntryHeader));
+    for (size_t e = 0; e < entries.size(); ++e)
+    {
+        const EntrySource &src = entries[e];
+        EntryHeader &entry = headers[e];
+
+        InterleavedView layout;
+        if (src.mesh->HasInterleaved())
+        {
+            layout = src.mesh->Interleaved();
+            vertices[e].assign(layout.vertices, layout.vertices + static_cast<size_t>(layout.vertexCount) * layout.Stride());
+            indices[e].assign(layout.indices, layout.indices + layout.indexCount);
+        }
+        else
+        {
+            src.mesh->Interleave(vertices[e], layout);
+
+            const IndexView indexView = src.mesh->Views().indices;
+            indices[e].resize(indexView.count);
+            indexView.CopyTo(indices[e].data());
+        }
+
+        if (src.material)
+        {
+            for (const auto &[id, value] : src.material->_values)
+            {
+                const std::string &name = UniformNames::Name(id);
+                MaterialRecord record{};
+                if (name.size() >= sizeof(record.name))
+                {
+                    LOG_WARNING("Material value '{}' has too long name for mesh cache.", name);
+                    return false;
+                }
+                name.copy(record.name, name.size());
+                record.type = value.type;
+                std::memcpy(record.value, &value.m4, sizeof(record.value));
+                materials[e].push_back(record);
+            }
+        }
+
+        std::memcpy(entry.nodeMatrix, glm::value_ptr(src.nodeMatrix), sizeof(entry.nodeMatrix));
+        entry.flags = 0;
+        if (layout.hasNormals)  entry.flags |= HasNormals;
+        if (layout.hasUVs)      entry.flags |= HasUVs;
+        if (layout.hasTangents) entry.flags |= HasTangents;
+        entry.vertexCount   = layout.vertexCount;
+        entry.indexCount    = layout.indexCount;
+        entry.materialCount = static_cast<uint32_t>(materials[e].size());
+        entry.diffuseImage  = src.diffuseImage;
+        entry.reserved      = 0;
+
+        entry.vertexOffset = offset;
+        offset = AlignUp(offset + vertices[e].size() * sizeof(float));
+        entry.indexOffset = offset;
+        offset = AlignUp(offset + static_cast<uint64_t>(entry.indexCount) * sizeof(unsigned int));
+        entry.materialOffset = offset;
+        offset = AlignUp(offset + materials[e].size() * sizeof(MaterialRecord));
+    }
+
+    // Write to a temporary file first, so an interrupted write never leaves a valid-looking cache
+    const fs::path cachePath = CachePath(source, variant);
+    fs::path tmpPath = cachePath;
+    tmpPath += ".tmp";
+
+    std::error_code ec;
+    fs::create_directories(cachePath.parent_path(), ec);
+
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            LOG_WARNING("Failed to create mesh cache '{}'.", tmpPath.string());
+            return false;
+        }
+
+        const auto writeAt = [&out](uint64_t position, const void *data, size_t bytes)
+        {
+            // pad up to the aligned block start
+            static constexpr char zeros[16] = {};
+            const auto current = static_cast<uint64_t>(out.tellp());
+            out.write(zeros, static_cast<std::streamsize>(position - current));
+            out.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+        };
+
+        FileHeader header{};
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version    = Version;
+        header.sourceHash = sourceHash;
+        header.entryCount = static_cast<uint32_t>(entries.size());
+        header.settings   = Settings();
+
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(headers.data()), static_cast<std::streamsize>(headers.size() * sizeof(EntryHeader)));
+
+        for (size_t e = 0; e < entries.size(); ++e)
+        {
+            writeAt(headers[e].vertexOffset, vertices[e].data(), vertices[e].size() * sizeof(float));
+            writeAt(headers[e].indexOffset, indices[e].data(), indices[e].size() * sizeof(unsigned int));
+            writeAt(headers[e].materialOffset, materials[e].data(), materials[e].size() * sizeof(MaterialRecord));
+        }
+
+        if (!out)
+        {
+            LOG_WARNING("Failed to write mesh cache '{}'.", tmpPath.string());
+            return false;
+        }
+    }
+
+    fs::rename(tmpPath, cachePath, ec);
+    if (ec)
+    {
+        LOG_WARNING("Failed to replace mesh cache '{}': {}", cachePath.string(), ec.message());
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       MeshCache.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Binary on-disk cache of imported meshes and scenes.
+ *
+ *  This file declares the MeshCache class, which stores the result of a glTF
+ *  import (interleaved vertices, indices, node matrices, derived MaterialPGR
+ *  values and image references) in one versioned binary file per source asset.
+ *  Cache files are keyed by a content hash of the source file and the import
+ *  settings baked into the data, so they rebuild themselves when either
+ *  changes, and are read through a memory mapping so vertex data can be
+ *  uploaded to the GPU straight from the mapped file.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include <optional>
+#include "MeshLoader.h"
+
+#define MESH_CACHE_DIRECTORY "cache/meshes" ///< relative to the resources, see ABSOLUTE_RESOURCE_PATH
+
+/**
+ * @class MeshCache
+ * @brief Reads and writes imported meshes in a memory-mappable binary format.
+ *
+ * File layout (all offsets in bytes from the start of the file, data blocks 16-byte aligned):
+ * 1. FileHeader
+ * 2. EntryHeader[entryCount]
+ * 3. per entry: interleaved vertices, indices and MaterialRecord[materialCount]
+ */
+class MeshCache
+{
+public:
+    /// Bump whenever the file layout or the data produced by the import pipeline changes.
+    static constexpr uint32_t Version = 5;
+
+    /**
+     * @enum ImportSettings
+     * @brief Compile time import options that change the cached data, stored in the file header.
+     */
+    enum ImportSettings : uint32_t
+    {
+        Optimized = 1 << 0, ///< indexed meshes reordered by MeshOptimizer::Optimize (IMPL_MESH_OPTIMIZE)
+        Tangent4  = 1 << 1, ///< four component tangents (IMPL_MESH_ENABLE_TANGENT4)
+    };
+    /// Import settings of this build, a cache written with other settings is rebuilt.
+    static uint32_t Settings();
+
+    /// FNV-1a 64-bit hash of the file contents, 0 if the file can't be read.
+    static uint64_t HashFile(const std::filesystem::path &source);
+    /// Location of the cache file belonging to a source asset, the variant keeps differently processed imports of one asset apart.
+    static std::filesystem::path CachePath(const std::filesystem::path &source, uint32_t variant = 0);
+
+    /**
+     * @brief Load a cached scene if it exists and matches the source hash.
+     * @return Scene meshes whose MeshSources reference the mapped file, or nullopt on a miss.
+     */
+    static std::optional<std::vector<SceneMesh>> ReadScene(const std::filesystem::path &source, uint64_t sourceHash, const Shader &shader);
+    static bool WriteScene(const std::filesystem::path &source, uint64_t sourceHash, const std::vector<SceneMesh> &scene);
+
+    /**
+     * @brief Load a cached single mesh if it exists and matches the source hash.
+     * @param variant Processing the mesh went through after the import, e.g. the MeshLoader::Indexing, each has its own file.
+     * @return MeshSource referencing the mapped file, or nullopt on a miss.
+     */
+    static std::optional<MeshSource> ReadMesh(const std::filesystem::path &source, uint64_t sourceHash, uint32_t variant);
+    static bool WriteMesh(const std::filesystem::path &source, uint64_t sourceHash, const MeshSource &mesh, uint32_t variant);
+
+private:
+    struct FileHeader
+    {
+        char     magic[4];
+        uint32_t version;
+        uint64_t sourceHash;
+        uint32_t entryCount;
+        uint32_t settings; ///< ImportSettings the data was produced with
+    };
+
+    struct EntryHeader
+    {
+        float    nodeMatrix[16];
+        uint32_t flags;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t materialCount;
+        int32_t  diffuseImage;
+        uint32_t reserved;
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        uint64_t materialOffset;
+    };
+
+    struct MaterialRecord
+    {
+        char     name[48];
+        uint32_t type;
+        uint32_t reserved;
+        uint8_t  value[sizeof(glm::mat4)];
+    };
+
+    enum EntryFlags : uint32_t
+    {
+        HasNormals  = 1 << 0,
+        HasUVs      = 1 << 1,
+        HasTangents = 1 << 2,
+    };
+
+    struct EntrySource
+    {
+        const MeshSource  *mesh;
+        glm::mat4          nodeMatrix;
+        const MaterialPGR *material;
+        int                diffuseImage;
+    };
+
+    static constexpr char Magic[4] = {'P', 'G', 'R', 'M'};
+
+    static std::optional<std::vector<SceneMesh>> Read(const std::filesystem::path &source, uint64_t sourceHash, const Shader *shader, uint32_t variant);
+    static bool Write(const std::filesystem::path &source, uint64_t sourceHash, const std::vector<EntrySource> &entries, uint32_t variant);
+};
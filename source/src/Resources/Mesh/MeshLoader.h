@@ -16,8 +16,15 @@
 #pragma once
 #include <tiny_gltf.h>
 #include "MeshSource.h"
+#include "Loader/GltfLazyImages.h"
 #include "src/Resources/Material/MaterialPGR.h"
 
+// Features
+#define IMPL_MESH_CACHE
+#define IMPL_PARALLEL_SCENE_IMPORT
+#define IMPL_MESH_OPTIMIZE
+// #define IMPL_SCENE_IMPORT_BENCHMARK
+
 /**
  * @struct SceneMesh
  * @brief Represents a single mesh instance in a loaded scene, including its geometry, transform, and material.
@@ -27,6 +34,10 @@ struct SceneMesh
     MeshSource   meshSource;
     glm::mat4    nodeMatrix;
     MaterialPGR     material;
+
+    /// Images of the source file, decoded only when requested (e.g. images->DecodeAsync(diffuseImage))
+    std::shared_ptr<GltfLazyImages> images;
+    int          diffuseImage = -1; ///< base color image index, -1 if untextured
 };
 
 /**
@@ -39,6 +50,17 @@ struct SceneMesh
 class MeshLoader
 {
 public:
+    /**
+     * @enum Indexing
+     * @brief Index layout of a mesh returned by LoadMesh.
+     */
+    enum class Indexing
+    {
+        Expanded, ///< non-indexed, every triangle corner is its own vertex
+        Original, ///< indices as stored in the file
+        Welded    ///< vertices equal within an epsilon merged, always indexed
+    };
+
     /**
      * @brief Load a single mesh from a file into a MeshSource.
      *
@@ -46,11 +68,12 @@ public:
      * and populates a MeshSource object with its vertex attributes and (optionally) index data.
      *
      * @param path        Filesystem path to the mesh file (e.g., .obj, .gltf, .glb) containing exactly one mesh.
-     * @param useIndices  If true, the returned MeshSource will include the original index buffer;
-     *                    if false, indices will be expanded into unique vertices.
-     * @return            A MeshSource containing the loaded mesh data.
+     * @param indexing    Index layout of the result, welding also logs the vertex and memory reduction.
+     *                    Indexed results are reordered by MeshOptimizer::Optimize (IMPL_MESH_OPTIMIZE).
+     * @return            A MeshSource containing the loaded mesh data. With IMPL_MESH_CACHE a warm start returns the
+     *                    processed mesh as one interleaved stream in the mapped cache file, see MeshSource::Interleaved.
      */
-    static MeshSource LoadMesh(const std::filesystem::path &path, bool useIndices);
+    static MeshSource LoadMesh(const std::filesystem::path &path, Indexing indexing);
     /**
      * @brief Load a full scene from a glTF or binary GLB file.
      *
@@ -62,4 +85,21 @@ public:
      * @return            A std::vector of SceneMesh entries, one per mesh primitive in the scene.
      */
     static std::vector<SceneMesh> LoadScene(const std::filesystem::path& gltfOrGlb, const Shader& shader);
+
+    /**
+     * @brief Import a scene from the glTF file, bypassing the mesh cache.
+     *
+     * The node tree is flattened into a list of primitives first, which are then decoded
+     * (and optimized, see MeshOptimizer::Optimize) on a thread pool. Each primitive writes its own slot, so the order of the result
+     * is the depth-first node order independent of the thread count.
+     *
+     * @param threadCount Number of decoding threads, 0 uses the hardware concurrency, 1 decodes serially.
+     */
+    static std::vector<SceneMesh> ImportScene(const std::filesystem::path& gltfOrGlb, const Shader& shader, unsigned int threadCount);
+    /// Log the import time of a scene for 1, 2, 4, ... threads up to the hardware concurrency, and the cold against the warm mesh cache start.
+    static void BenchmarkSceneImport(const std::filesystem::path& gltfOrGlb, const Shader& shader);
+
+private:
+    /// Import, weld, optimize or expand a single mesh, bypassing the mesh cache.
+    static MeshSource ImportMesh(const std::filesystem::path &path, Indexing indexing);
 };
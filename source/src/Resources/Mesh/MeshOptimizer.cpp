@@ -0,0 +1,375 @@
+#include "MeshOptimizer.h"
+
+namespace
+{
+    /// Attributes of one vertex snapped to the epsilon grid (position, normal, uv)
+    struct WeldKey
+    {
+        std::array<int64_t, 8> cells{};
+
+        bool operator==(const WeldKey &other) const = default;
+    };
+
+    struct WeldKeyHash
+    {
+        size_t operator()(const WeldKey &key) const
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (int64_t cell : key.cells)
+            {
+                hash ^= static_cast<uint64_t>(cell);
+                hash *= 1099511628211ull;
+            }
+            return static_cast<size_t>(hash ^ (hash >> 32));
+        }
+    };
+}
+
+MeshSource MeshOptimizer::Weld(const MeshSource &source, float epsilon, WeldStats *stats)
+{
+    const MeshViews views = source.Views();
+    const InterleavedView layout = source.Layout();
+    const uint32_t corners = views.indices.count ? views.indices.count : views.positions.count;
+    const double scale = 1.0 / epsilon;
+
+    const auto key = [&](uint32_t v)
+    {
+        WeldKey result;
+        for (uint32_t c = 0; c < 3; ++c)
+            result.cells[c] = std::llround(views.positions[v][c] * scale);
+        if (layout.hasNormals)
+            for (uint32_t c = 0; c < 3; ++c)
+                result.cells[3 + c] = std::llround(views.normals[v][c] * scale);
+        if (layout.hasUVs)
+            for (uint32_t c = 0; c < 2; ++c)
+                result.cells[6 + c] = std::llround(views.uvs[v][c] * scale);
+        return result;
+    };
+
+    MeshSource welded;
+    std::unordered_map<WeldKey, uint32_t, WeldKeyHash> cells;
+    cells.reserve(views.positions.count);
+    std::vector<uint32_t> remap(views.positions.count, UINT32_MAX); // source vertex -> welded vertex
+
+    welded._indices.resize(corners);
+    for (uint32_t i = 0; i < corners; ++i)
+    {
+        const uint32_t v = views.indices.count ? views.indices[i] : i;
+        if (remap[v] == UINT32_MAX)
+        {
+            const auto [it, inserted] = cells.try_emplace(key(v), static_cast<uint32_t>(cells.size()));
+            if (inserted)
+            {
+                welded._positions.insert(welded._positions.end(), views.positions[v], views.positions[v] + 3);
+                if (layout.hasNormals)
+                    welded._normals.insert(welded._normals.end(), views.normals[v], views.normals[v] + 3);
+                if (layout.hasUVs)
+                    welded._uvs.insert(welded._uvs.end(), views.uvs[v], views.uvs[v] + 2);
+                if (!views.tangents.Empty())
+                    welded._tangents.insert(welded._tangents.end(), views.tangents[v], views.tangents[v] + views.tangents.components);
+            }
+            remap[v] = it->second;
+        }
+        welded._indices[i] = remap[v];
+    }
+    welded.UpdateCounts();
+
+    if (stats)
+    {
+        stats->corners     = corners;
+        stats->vertexCount = welded.VertexCount();
+        stats->soupBytes   = static_cast<size_t>(corners) * layout.Stride() * sizeof(float);
+        stats->weldedBytes = static_cast<size_t>(welded.VertexCount()) * welded.Layout().Stride() * sizeof(float) + welded._indices.size() * sizeof(unsigned int);
+    }
+
+    return welded;
+}
+
+void MeshOptimizer::Optimize(MeshSource &mesh, OptimizeStats *stats)
+{
+    if (!mesh.IsIndexed())
+        return;
+
+    mesh.Detach();
+    const uint32_t vertexCount = mesh.VertexCount();
+    if (std::any_of(mesh._indices.begin(), mesh._indices.end(), [vertexCount](unsigned int index) { return index >= vertexCount; }))
+    {
+        LOG_WARNING("Skipped optimization of a mesh with out of range indices.");
+        return;
+    }
+
+    if (stats)
+        stats->before = AnalyzeVertexCache(mesh._indices.data(), mesh._indices.size(), vertexCount);
+
+    const std::vector<uint32_t> clusters = OptimizeVertexCache(mesh._indices, vertexCount);
+    OptimizeOverdraw(mesh._indices, mesh._positions.data(), vertexCount, clusters);
+    OptimizeVertexFetch(mesh);
+
+    if (stats)
+        stats->after = AnalyzeVertexCache(mesh._indices.data(), mesh._indices.size(), mesh.VertexCount());
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const unsigned int *indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+{
+    VertexCacheStats stats;
+    stats.triangles = indexCount / 3;
+    stats.vertices  = vertexCount;
+
+    // a vertex is cached while fewer than cacheSize vertices were inserted after it
+    std::vector<uint32_t> insertedAt(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        if (time - insertedAt[indices[i]] > cacheSize)
+        {
+            insertedAt[indices[i]] = time++;
+            ++stats.misses;
+        }
+    }
+
+    return stats;
+}
+
+std::vector<uint32_t> MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int> &indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+    const size_t triangleCount = indices.size() / 3;
+    std::vector<uint32_t> clusters;
+    if (triangleCount == 0 || vertexCount == 0)
+        return clusters;
+
+    // Vertex -> triangle adjacency
+    std::vector<uint32_t> live(vertexCount, 0);
+    for (unsigned int index : indices)
+        ++live[index];
+
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; ++v)
+        offsets[v + 1] = offsets[v] + live[v];
+
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t)
+        for (size_t k = 0; k < 3; ++k)
+            adjacency[fill[indices[3 * t + k]]++] = static_cast<uint32_t>(t);
+
+    // Tipsify
+    std::vector<uint32_t> insertedAt(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    uint32_t time = cacheSize + 1;
+    uint32_t cursor = 0;
+
+    // restart from a recently used vertex, or from the next unprocessed one in input order
+    const auto restart = [&]() -> int64_t
+    {
+        while (!deadEnd.empty())
+        {
+            const uint32_t v = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[v] > 0)
+                return v;
+        }
+        for (; cursor < vertexCount; ++cursor)
+            if (live[cursor] > 0)
+                return cursor;
+        return -1;
+    };
+
+    int64_t fanning = restart();
+    clusters.push_back(0);
+    while (fanning >= 0)
+    {
+        // emit all remaining triangles around the fanning vertex
+        candidates.clear();
+        for (uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; ++a)
+        {
+            const uint32_t t = adjacency[a];
+            if (emitted[t])
+                continue;
+
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const uint32_t v = indices[3 * t + k];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+
+                if (time - insertedAt[v] > cacheSize)
+                    insertedAt[v] = time++;
+            }
+            emitted[t] = true;
+        }
+
+        // next fanning vertex: the oldest candidate that stays cached while its triangles are emitted
+        int64_t next = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t v : candidates)
+        {
+            if (live[v] == 0)
+                continue;
+
+            int64_t priority = 0;
+            if (time - insertedAt[v] + 2 * live[v] <= cacheSize)
+                priority = time - insertedAt[v];
+
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+
+        if (next < 0)
+        {
+            next = restart();
+            if (next >= 0 && clusters.back() != output.size() / 3)
+                clusters.push_back(static_cast<uint32_t>(output.size() / 3));
+        }
+        fanning = next;
+    }
+
+    indices.swap(output);
+    return clusters;
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<unsigned int> &indices, const float *positions, uint32_t vertexCount, const std::vector<uint32_t> &clusters,
+                                     float threshold, uint32_t cacheSize)
+{
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0 || clusters.empty())
+        return;
+
+    // Soft boundaries: split a cluster as soon as its own ACMR is close to the ACMR of the whole mesh
+    const double limit = AnalyzeVertexCache(indices.data(), indices.size(), vertexCount, cacheSize).ACMR() * threshold;
+    std::vector<uint32_t> starts;
+    std::vector<uint32_t> insertedAt(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+
+    for (size_t c = 0; c < clusters.size(); ++c)
+    {
+        const uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+        uint32_t start = clusters[c];
+        uint32_t misses = 0;
+
+        starts.push_back(start);
+        time += cacheSize + 1; // flush the cache
+        for (uint32_t t = start; t < end; ++t)
+        {
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                const unsigned int v = indices[3 * t + k];
+                if (time - insertedAt[v] > cacheSize)
+                {
+                    insertedAt[v] = time++;
+                    ++misses;
+                }
+            }
+
+            if (t + 1 < end && misses <= (t + 1 - start) * limit)
+            {
+                start = t + 1;
+                misses = 0;
+                starts.push_back(start);
+                time += cacheSize + 1;
+            }
+        }
+    }
+
+    // Sort key: clusters facing away from the mesh center are likely occluders, draw them first
+    const auto vertex = [positions](unsigned int v) { return glm::make_vec3(positions + 3 * static_cast<size_t>(v)); };
+
+    glm::dvec3 meshCentroid(0.0);
+    double meshArea = 0.0;
+    for (uint32_t t = 0; t < triangleCount; ++t)
+    {
+        const glm::vec3 a = vertex(indices[3 * t]), b = vertex(indices[3 * t + 1]), c = vertex(indices[3 * t + 2]);
+        const double area = glm::length(glm::cross(b - a, c - a));
+        meshCentroid += glm::dvec3(a + b + c) * (area / 3.0);
+        meshArea += area;
+    }
+    if (meshArea > 0.0)
+        meshCentroid /= meshArea;
+
+    struct Cluster
+    {
+        uint32_t start, end;
+        double   sortKey;
+    };
+    std::vector<Cluster> sorted(starts.size());
+    for (size_t c = 0; c < starts.size(); ++c)
+    {
+        const uint32_t end = c + 1 < starts.size() ? starts[c + 1] : triangleCount;
+
+        glm::dvec3 centroid(0.0), normal(0.0);
+        double area = 0.0;
+        for (uint32_t t = starts[c]; t < end; ++t)
+        {
+            const glm::vec3 a = vertex(indices[3 * t]), b = vertex(indices[3 * t + 1]), c3 = vertex(indices[3 * t + 2]);
+            const glm::dvec3 cross = glm::cross(b - a, c3 - a); // length is twice the area
+            const double triangleArea = glm::length(cross);
+
+            centroid += glm::dvec3(a + b + c3) * (triangleArea / 3.0);
+            normal += cross;
+            area += triangleArea;
+        }
+
+        double sortKey = 0.0;
+        if (area > 0.0 && glm::length(normal) > 0.0)
+            sortKey = glm::dot(centroid / area - meshCentroid, glm::normalize(normal));
+
+        sorted[c] = {starts[c], end, sortKey};
+    }
+
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster &a, const Cluster &b) { return a.sortKey > b.sortKey; });
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    for (const Cluster &cluster : sorted)
+        output.insert(output.end(), indices.begin() + 3 * static_cast<size_t>(cluster.start), indices.begin() + 3 * static_cast<size_t>(cluster.end));
+
+    indices.swap(output);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(MeshSource &mesh)
+{
+    const uint32_t vertexCount = mesh.VertexCount();
+    if (!mesh.IsIndexed() || vertexCount == 0)
+        return;
+
+    // first use order
+    std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+    uint32_t next = 0;
+    for (unsigned int &index : mesh._indices)
+    {
+        if (remap[index] == UINT32_MAX)
+            remap[index] = next++;
+        index = remap[index];
+    }
+
+    const auto reorder = [&](std::vector<float> &attribute)
+    {
+        if (attribute.empty())
+            return;
+
+        const size_t components = attribute.size() / vertexCount;
+        std::vector<float> reordered(next * components);
+        for (uint32_t v = 0; v < vertexCount; ++v)
+            if (remap[v] != UINT32_MAX)
+                std::copy_n(&attribute[v * components], components, &reordered[remap[v] * components]);
+
+        attribute.swap(reordered);
+    };
+
+    reorder(mesh._positions);
+    reorder(mesh._normals);
+    reorder(mesh._uvs);
+    reorder(mesh._tangents);
+    for (std::vector<float> &channel : mesh._texCoordChannels)
+        reorder(channel);
+
+    mesh.UpdateCounts();
+}
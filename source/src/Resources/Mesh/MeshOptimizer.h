@@ -0,0 +1,125 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       MeshOptimizer.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      CPU passes that reshape MeshSource geometry for faster rendering.
+ *
+ *  This file declares the MeshOptimizer class, a collection of static passes
+ *  run on loaded meshes before they are uploaded. Welding merges vertices that
+ *  are equal within an epsilon, so triangle soups and duplicated seams become
+ *  compact indexed geometry. The index reordering passes improve post-transform
+ *  vertex cache hits (Tipsify), reduce overdraw by sorting triangle clusters
+ *  and renumber vertices in first-use order for linear vertex fetch. All passes
+ *  are CPU only, so their statistics can be checked without a GPU.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "MeshSource.h"
+
+/**
+ * @struct WeldStats
+ * @brief Result of MeshOptimizer::Weld for reporting.
+ */
+struct WeldStats
+{
+    uint32_t corners     = 0; ///< triangle corners, i.e. vertices of the expanded triangle soup
+    uint32_t vertexCount = 0; ///< unique vertices after welding
+    size_t   soupBytes   = 0; ///< memory of the expanded, non-indexed vertex stream
+    size_t   weldedBytes = 0; ///< memory of the welded interleaved vertices and indices
+};
+
+/**
+ * @struct VertexCacheStats
+ * @brief Post-transform cache efficiency of an index buffer, simulated with a FIFO cache.
+ *
+ * Counts are absolute so the statistics of several meshes can be summed.
+ */
+struct VertexCacheStats
+{
+    uint64_t triangles = 0;
+    uint64_t vertices  = 0;
+    uint64_t misses    = 0; ///< vertex shader invocations
+
+    /// Average cache miss ratio, transformed vertices per triangle (0.5 is optimal for large meshes)
+    [[nodiscard]] double ACMR() const { return triangles ? static_cast<double>(misses) / triangles : 0.0; }
+    /// Average transformed to vertex ratio (1.0 is optimal)
+    [[nodiscard]] double ATVR() const { return vertices ? static_cast<double>(misses) / vertices : 0.0; }
+
+    VertexCacheStats &operator+=(const VertexCacheStats &other)
+    {
+        triangles += other.triangles;
+        vertices  += other.vertices;
+        misses    += other.misses;
+        return *this;
+    }
+};
+
+/**
+ * @struct OptimizeStats
+ * @brief Vertex cache statistics of a mesh before and after MeshOptimizer::Optimize.
+ */
+struct OptimizeStats
+{
+    VertexCacheStats before;
+    VertexCacheStats after;
+
+    OptimizeStats &operator+=(const OptimizeStats &other)
+    {
+        before += other.before;
+        after  += other.after;
+        return *this;
+    }
+};
+
+class MeshOptimizer
+{
+public:
+    /// Size of the simulated FIFO post-transform cache
+    static constexpr uint32_t CacheSize = 16;
+
+    /**
+     * @brief Merge vertices whose position, normal and UV are equal within epsilon.
+     *
+     * Attributes are snapped to an epsilon grid and hashed, the first vertex of every cell is kept
+     * unmodified. Vertices not referenced by any triangle are dropped.
+     *
+     * @param source  Indexed or non-indexed mesh.
+     * @param epsilon Grid size used to compare attributes.
+     * @param stats   Optional vertex and memory statistics.
+     * @return        Indexed mesh with owned attribute vectors (uvs in the glTF scene slot).
+     */
+    static MeshSource Weld(const MeshSource &source, float epsilon = 1e-5f, WeldStats *stats = nullptr);
+
+    /**
+     * @brief Run the vertex cache, overdraw and vertex fetch passes on an indexed mesh.
+     *
+     * External data (views, interleaved cache streams) is detached into owned vectors first.
+     * Non-indexed meshes are left untouched.
+     */
+    static void Optimize(MeshSource &mesh, OptimizeStats *stats = nullptr);
+
+    /// Simulate a FIFO post-transform cache over a triangle list.
+    static VertexCacheStats AnalyzeVertexCache(const unsigned int *indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize = CacheSize);
+
+    /**
+     * @brief Reorder triangles for vertex cache locality (Tipsify, Sander et al. 2007).
+     * @return Start triangle of every cluster, i.e. every point where the walk had to restart.
+     */
+    static std::vector<uint32_t> OptimizeVertexCache(std::vector<unsigned int> &indices, uint32_t vertexCount, uint32_t cacheSize = CacheSize);
+    /**
+     * @brief Reorder triangle clusters so outward facing ones are drawn first, reducing overdraw.
+     *
+     * Clusters are additionally split wherever their ACMR stays within threshold of the whole mesh,
+     * so the sort has more freedom while keeping the cache efficiency of OptimizeVertexCache.
+     *
+     * @param positions Tightly packed vec3 positions.
+     * @param clusters  Cluster starts from OptimizeVertexCache.
+     */
+    static void OptimizeOverdraw(std::vector<unsigned int> &indices, const float *positions, uint32_t vertexCount, const std::vector<uint32_t> &clusters,
+                                 float threshold = 1.05f, uint32_t cacheSize = CacheSize);
+    /// Renumber vertices in order of first use by the index buffer, dropping unused ones.
+    static void OptimizeVertexFetch(MeshSource &mesh);
+};
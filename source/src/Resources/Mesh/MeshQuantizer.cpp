@@ -0,0 +1,143 @@
+#include "MeshQuantizer.h"
+#include <glm/gtc/packing.hpp>
+
+namespace
+{
+    constexpr float UNormMax = 65535.0f;
+
+    float AngleDegrees(const glm::vec3 &reference, const glm::vec3 &decoded)
+    {
+        const float length = glm::length(reference);
+        if (length <= 0.0f)
+            return 0.0f;
+
+        return glm::degrees(std::acos(glm::clamp(glm::dot(reference / length, decoded), -1.0f, 1.0f)));
+    }
+}
+
+uint32_t MeshQuantizer::Stride(const InterleavedView &layout)
+{
+    return PositionBytes + (layout.hasNormals ? DirectionBytes : 0) + (layout.hasUVs ? UVBytes : 0) + (layout.hasTangents ? DirectionBytes : 0);
+}
+
+uint32_t MeshQuantizer::OctEncode(const glm::vec3 &direction)
+{
+    const float sum = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+    if (sum <= 0.0f)
+        return glm::packSnorm2x16(glm::vec2(0.0f));
+
+    // project onto the octahedron, fold the lower hemisphere over the diagonals
+    glm::vec2 p = glm::vec2(direction) / sum;
+    if (direction.z < 0.0f)
+    {
+        const glm::vec2 sign(p.x >= 0.0f ? 1.0f : -1.0f, p.y >= 0.0f ? 1.0f : -1.0f);
+        p = (1.0f - glm::abs(glm::vec2(p.y, p.x))) * sign;
+    }
+
+    return glm::packSnorm2x16(p);
+}
+
+glm::vec3 MeshQuantizer::OctDecode(uint32_t encoded)
+{
+    const glm::vec2 e = glm::unpackSnorm2x16(encoded);
+
+    glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+    const float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+
+    return glm::normalize(n);
+}
+
+PositionQuantization MeshQuantizer::Encode(const MeshViews &views, const InterleavedView &layout, uint8_t *dst)
+{
+    const uint32_t stride = Stride(layout);
+
+    // bounds -> decode
+    PositionQuantization quantization;
+    if (layout.vertexCount == 0)
+        return quantization;
+
+    glm::vec3 min(std::numeric_limits<float>::max());
+    glm::vec3 max(std::numeric_limits<float>::lowest());
+    for (uint32_t v = 0; v < layout.vertexCount; ++v)
+    {
+        const glm::vec3 position = glm::make_vec3(views.positions[v]);
+        min = glm::min(min, position);
+        max = glm::max(max, position);
+    }
+    quantization.offset = min;
+    quantization.scale  = max - min;
+
+    const glm::vec3 toUNorm(quantization.scale.x > 0.0f ? UNormMax / quantization.scale.x : 0.0f,
+                            quantization.scale.y > 0.0f ? UNormMax / quantization.scale.y : 0.0f,
+                            quantization.scale.z > 0.0f ? UNormMax / quantization.scale.z : 0.0f);
+
+    // encode
+    for (uint32_t v = 0; v < layout.vertexCount; ++v)
+    {
+        uint8_t *vertex = dst + static_cast<size_t>(v) * stride;
+
+        const glm::vec3 unorm = glm::round((glm::make_vec3(views.positions[v]) - min) * toUNorm);
+        const uint16_t position[4] = {static_cast<uint16_t>(unorm.x), static_cast<uint16_t>(unorm.y), static_cast<uint16_t>(unorm.z), 0};
+        std::memcpy(vertex, position, PositionBytes);
+        vertex += PositionBytes;
+
+        if (layout.hasNormals)
+        {
+            const uint32_t normal = OctEncode(glm::make_vec3(views.normals[v]));
+            std::memcpy(vertex, &normal, DirectionBytes);
+            vertex += DirectionBytes;
+        }
+        if (layout.hasUVs)
+        {
+            const uint32_t uv = glm::packHalf2x16(glm::make_vec2(views.uvs[v]));
+            std::memcpy(vertex, &uv, UVBytes);
+            vertex += UVBytes;
+        }
+        if (layout.hasTangents)
+        {
+            const uint32_t tangent = OctEncode(glm::make_vec3(views.tangents[v]));
+            std::memcpy(vertex, &tangent, DirectionBytes);
+        }
+    }
+
+    return quantization;
+}
+
+void MeshQuantizer::Measure(const MeshViews &views, const InterleavedView &layout, const uint8_t *encoded, const PositionQuantization &quantization,
+                            QuantizeStats &stats)
+{
+    const uint32_t stride = Stride(layout);
+
+    for (uint32_t v = 0; v < layout.vertexCount; ++v)
+    {
+        const uint8_t *vertex = encoded + static_cast<size_t>(v) * stride;
+
+        uint16_t position[4];
+        std::memcpy(position, vertex, PositionBytes);
+        vertex += PositionBytes;
+        const glm::vec3 decoded = quantization.offset + quantization.scale * (glm::vec3(position[0], position[1], position[2]) / UNormMax);
+        stats.maxPositionError = std::max(stats.maxPositionError, glm::distance(decoded, glm::make_vec3(views.positions[v])));
+
+        uint32_t packed;
+        if (layout.hasNormals)
+        {
+            std::memcpy(&packed, vertex, DirectionBytes);
+            vertex += DirectionBytes;
+            stats.maxNormalError = std::max(stats.maxNormalError, AngleDegrees(glm::make_vec3(views.normals[v]), OctDecode(packed)));
+        }
+        if (layout.hasUVs)
+        {
+            std::memcpy(&packed, vertex, UVBytes);
+            vertex += UVBytes;
+            const glm::vec2 error = glm::abs(glm::unpackHalf2x16(packed) - glm::make_vec2(views.uvs[v]));
+            stats.maxUVError = std::max({stats.maxUVError, error.x, error.y});
+        }
+        if (layout.hasTangents)
+        {
+            std::memcpy(&packed, vertex, DirectionBytes);
+            stats.maxTangentError = std::max(stats.maxTangentError, AngleDegrees(glm::make_vec3(views.tangents[v]), OctDecode(packed)));
+        }
+    }
+}
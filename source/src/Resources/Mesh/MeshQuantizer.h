@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       MeshQuantizer.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Compact quantized vertex encoding for GPU upload.
+ *
+ *  This file declares the MeshQuantizer class, which packs mesh attributes
+ *  into a compact vertex layout: 16-bit positions normalized to the mesh
+ *  bounds (decoded in the vertex shader with a per-mesh scale and offset),
+ *  octahedral 16-bit normals and tangents, and half-float texture coordinates.
+ *  The encoded stream can be measured against the float reference.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "MeshSource.h"
+
+/**
+ * @struct QuantizeStats
+ * @brief Memory and worst-case error of compact vertex buffers against the float reference.
+ *
+ * Sizes are absolute and errors are maxima, so the statistics of several meshes can be summed.
+ */
+struct QuantizeStats
+{
+    uint64_t vertices     = 0;
+    size_t   floatBytes   = 0; ///< vertex and index memory with 32-bit floats and 32-bit indices
+    size_t   compactBytes = 0; ///< vertex and index memory actually uploaded
+
+    float maxPositionError = 0.0f; ///< object space distance
+    float maxNormalError   = 0.0f; ///< degrees
+    float maxTangentError  = 0.0f; ///< degrees
+    float maxUVError       = 0.0f; ///< texture coordinate units
+
+    /// Float reference size divided by the uploaded size.
+    [[nodiscard]] double Ratio() const { return compactBytes ? static_cast<double>(floatBytes) / compactBytes : 0.0; }
+
+    QuantizeStats &operator+=(const QuantizeStats &other)
+    {
+        vertices     += other.vertices;
+        floatBytes   += other.floatBytes;
+        compactBytes += other.compactBytes;
+        maxPositionError = std::max(maxPositionError, other.maxPositionError);
+        maxNormalError   = std::max(maxNormalError, other.maxNormalError);
+        maxTangentError  = std::max(maxTangentError, other.maxTangentError);
+        maxUVError       = std::max(maxUVError, other.maxUVError);
+        return *this;
+    }
+};
+
+/**
+ * @struct PositionQuantization
+ * @brief Decode of normalized 16-bit positions: position = offset + scale * unorm.
+ */
+struct PositionQuantization
+{
+    glm::vec3 scale  = glm::vec3(1.0f);
+    glm::vec3 offset = glm::vec3(0.0f);
+};
+
+class MeshQuantizer
+{
+public:
+    static constexpr uint32_t PositionBytes = 4 * sizeof(uint16_t); ///< unorm16 xyz, padded to 4-byte alignment
+    static constexpr uint32_t DirectionBytes = 2 * sizeof(int16_t); ///< octahedral snorm16 normal or tangent
+    static constexpr uint32_t UVBytes = 2 * sizeof(uint16_t);       ///< half float uv
+
+    /// Bytes per compact vertex (position | normal | uv | tangent) for the attributes present in layout.
+    static uint32_t Stride(const InterleavedView &layout);
+
+    /**
+     * @brief Encode the attributes into the compact interleaved layout.
+     * @param views  Float attributes, see MeshSource::Views().
+     * @param layout Attributes present and vertex count, see MeshSource::Layout().
+     * @param[out] dst Destination of layout.vertexCount * Stride(layout) bytes.
+     * @return Scale and offset that decode the positions.
+     */
+    static PositionQuantization Encode(const MeshViews &views, const InterleavedView &layout, uint8_t *dst);
+    /// Decode an encoded stream and record its memory and largest errors against the float attributes.
+    static void Measure(const MeshViews &views, const InterleavedView &layout, const uint8_t *encoded, const PositionQuantization &quantization,
+                        QuantizeStats &stats);
+
+    /// Octahedral encoding of a direction into two snorm16 values (x in the low half).
+    static uint32_t OctEncode(const glm::vec3 &direction);
+    /// Inverse of OctEncode, same math as OctDecode() in Shader_V.glsl.
+    static glm::vec3 OctDecode(uint32_t encoded);
+};
@@ -0,0 +1,418 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include <numeric>
+
+namespace
+{
+    /// Symmetric plane quadric, error of a point is its weighted squared distance to the planes
+    struct Quadric
+    {
+        double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+        double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+        double c = 0.0;
+        double weight = 0.0; ///< summed triangle area
+
+        static Quadric FromPlane(const glm::dvec3 &n, double d, double area)
+        {
+            Quadric q;
+            q.a00 = n.x * n.x * area;
+            q.a01 = n.x * n.y * area;
+            q.a02 = n.x * n.z * area;
+            q.a11 = n.y * n.y * area;
+            q.a12 = n.y * n.z * area;
+            q.a22 = n.z * n.z * area;
+            q.b0 = n.x * d * area;
+            q.b1 = n.y * d * area;
+            q.b2 = n.z * d * area;
+            q.c = d * d * area;
+            q.weight = area;
+            return q;
+        }
+
+        Quadric &operator+=(const Quadric &other)
+        {
+            a00 += other.a00; a01 += other.a01; a02 += other.a02;
+            a11 += other.a11; a12 += other.a12; a22 += other.a22;
+            b0 += other.b0; b1 += other.b1; b2 += other.b2;
+            c += other.c;
+            weight += other.weight;
+            return *this;
+        }
+
+        /// Area weighted mean squared distance of p to the planes
+        [[nodiscard]] double Error(const glm::dvec3 &p) const
+        {
+            const double rx = a00 * p.x + a01 * p.y + a02 * p.z;
+            const double ry = a01 * p.x + a11 * p.y + a12 * p.z;
+            const double rz = a02 * p.x + a12 * p.y + a22 * p.z;
+            const double r = p.x * rx + p.y * ry + p.z * rz + 2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+            return weight > 0.0 ? std::abs(r) / weight : 0.0;
+        }
+    };
+
+    /// Exact bits of position, normal and uv
+    struct VertexKey
+    {
+        std::array<uint32_t, 8> bits{};
+
+        bool operator==(const VertexKey &other) const = default;
+    };
+
+    struct VertexKeyHash
+    {
+        size_t operator()(const VertexKey &key) const
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (uint32_t bits : key.bits)
+            {
+                hash ^= bits;
+                hash *= 1099511628211ull;
+            }
+            return static_cast<size_t>(hash ^ (hash >> 32));
+        }
+    };
+
+    struct Collapse
+    {
+        uint32_t from;
+        uint32_t to;
+        double   cost;
+    };
+
+    /// Smallest cosine between a triangle normal before and after a collapse (about 75 degrees)
+    constexpr double MinNormalCos = 0.25;
+
+    uint64_t EdgeKey(uint32_t a, uint32_t b)
+    {
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    /**
+     * @brief Collapse edges down to every target in turn, snapshotting the triangles at each one.
+     *
+     * Quadrics keep accumulating across the targets, so every level is measured against the input mesh.
+     */
+    void SimplifyLevels(const MeshViews &views, const std::vector<unsigned int> &indices, const std::vector<size_t> &targets, float targetError,
+                        std::vector<std::vector<unsigned int>> &levels, std::vector<float> &errors)
+    {
+        levels.clear();
+        errors.clear();
+
+        const uint32_t vertexCount = views.positions.count;
+        if (vertexCount == 0)
+            return;
+
+        const auto position = [&](uint32_t v) { return glm::dvec3(glm::make_vec3(views.positions[v])); };
+
+        // identical vertices share one id, vertices at the same position share one position id
+        std::vector<uint32_t> vertexId(vertexCount);
+        std::vector<uint32_t> positionId(vertexCount);
+        {
+            std::unordered_map<VertexKey, uint32_t, VertexKeyHash> vertices, positions;
+            vertices.reserve(vertexCount);
+            positions.reserve(vertexCount);
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                VertexKey key;
+                std::memcpy(&key.bits[0], views.positions[v], 3 * sizeof(float));
+                positionId[v] = positions.try_emplace(key, v).first->second;
+
+                if (!views.normals.Empty())
+                    std::memcpy(&key.bits[3], views.normals[v], 3 * sizeof(float));
+                if (!views.uvs.Empty())
+                    std::memcpy(&key.bits[6], views.uvs[v], 2 * sizeof(float));
+                vertexId[v] = vertices.try_emplace(key, v).first->second;
+            }
+        }
+
+        // working triangles over vertex ids, degenerate ones dropped
+        std::vector<unsigned int> current;
+        current.reserve(indices.size());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            const uint32_t a = vertexId[indices[i]], b = vertexId[indices[i + 1]], c = vertexId[indices[i + 2]];
+            if (a != b && a != c && b != c)
+                current.insert(current.end(), {a, b, c});
+        }
+
+        // seams: one position with several different vertices
+        std::vector<uint8_t> locked(vertexCount, 0);
+        {
+            std::vector<uint32_t> owner(vertexCount, UINT32_MAX);
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                uint32_t &first = owner[positionId[v]];
+                if (first == UINT32_MAX)
+                    first = vertexId[v];
+                else if (first != vertexId[v])
+                    locked[positionId[v]] = 1;
+            }
+        }
+
+        // borders: edges of the position topology used once or without opposite edge
+        {
+            std::vector<uint64_t> edges;
+            edges.reserve(current.size());
+            for (size_t i = 0; i < current.size(); i += 3)
+                for (int e = 0; e < 3; ++e)
+                    edges.push_back(EdgeKey(positionId[current[i + e]], positionId[current[i + (e + 1) % 3]]));
+            std::sort(edges.begin(), edges.end());
+
+            const auto count = [&](uint64_t key)
+            {
+                const auto range = std::equal_range(edges.begin(), edges.end(), key);
+                return range.second - range.first;
+            };
+
+            for (size_t i = 0; i < edges.size(); ++i)
+            {
+                if (i > 0 && edges[i] == edges[i - 1])
+                    continue;
+
+                const auto a = static_cast<uint32_t>(edges[i] >> 32), b = static_cast<uint32_t>(edges[i]);
+                if (count(edges[i]) != 1 || count(EdgeKey(b, a)) != 1)
+                    locked[a] = locked[b] = 1;
+            }
+        }
+        const auto isLocked = [&](uint32_t v) { return locked[positionId[v]] != 0; };
+
+        // plane quadrics of the adjacent triangles
+        std::vector<Quadric> quadrics(vertexCount);
+        for (size_t i = 0; i < current.size(); i += 3)
+        {
+            const glm::dvec3 p0 = position(current[i]), p1 = position(current[i + 1]), p2 = position(current[i + 2]);
+            const glm::dvec3 cross = glm::cross(p1 - p0, p2 - p0);
+            const double length = glm::length(cross);
+            if (length <= 0.0)
+                continue;
+
+            const glm::dvec3 n = cross / length;
+            const Quadric q = Quadric::FromPlane(n, -glm::dot(n, p0), length * 0.5);
+            for (int k = 0; k < 3; ++k)
+                quadrics[current[i + k]] += q;
+        }
+
+        const double errorLimit = static_cast<double>(targetError) * targetError;
+        double maxError = 0.0;
+
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+        std::vector<uint32_t> adjacency;
+        std::vector<uint32_t> remap(vertexCount);
+        std::vector<uint8_t> touched(vertexCount);
+        std::vector<Collapse> collapses;
+
+        // the normal of no triangle around from may flip or turn too far when from moves onto to
+        const auto isValid = [&](uint32_t from, uint32_t to)
+        {
+            const glm::dvec3 target = position(to);
+            for (uint32_t k = adjacencyOffsets[from]; k < adjacencyOffsets[from + 1]; ++k)
+            {
+                const size_t t = static_cast<size_t>(adjacency[k]) * 3;
+                const uint32_t v[3] = {remap[current[t]], remap[current[t + 1]], remap[current[t + 2]]};
+                if (v[0] == to || v[1] == to || v[2] == to || v[0] == v[1] || v[0] == v[2] || v[1] == v[2])
+                    continue; // collapses away
+
+                const glm::dvec3 p[3] = {position(v[0]), position(v[1]), position(v[2])};
+                const glm::dvec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+
+                glm::dvec3 q[3] = {p[0], p[1], p[2]};
+                for (int c = 0; c < 3; ++c)
+                    if (v[c] == from)
+                        q[c] = target;
+                const glm::dvec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+
+                const double lengths = glm::length(before) * glm::length(after);
+                if (lengths <= 0.0 || glm::dot(before, after) < MinNormalCos * lengths)
+                    return false;
+            }
+            return true;
+        };
+
+        bool stuck = false;
+        for (const size_t targetIndexCount : targets)
+        {
+            while (!stuck && current.size() > targetIndexCount)
+            {
+                const auto triangleCount = static_cast<uint32_t>(current.size() / 3);
+
+                // vertex -> triangle adjacency
+                std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+                for (unsigned int v : current)
+                    adjacencyOffsets[v + 1]++;
+                for (uint32_t v = 0; v < vertexCount; ++v)
+                    adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+                adjacency.resize(current.size());
+                {
+                    std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+                    for (size_t i = 0; i < current.size(); ++i)
+                        adjacency[cursor[current[i]]++] = static_cast<uint32_t>(i / 3);
+                }
+
+                // cheaper direction of every edge, cheapest first
+                collapses.clear();
+                for (size_t i = 0; i < current.size(); i += 3)
+                {
+                    for (int e = 0; e < 3; ++e)
+                    {
+                        const uint32_t a = current[i + e], b = current[i + (e + 1) % 3];
+                        if (a > b || (isLocked(a) && isLocked(b)))
+                            continue; // interior edges are visited twice, as (a, b) and (b, a)
+
+                        Quadric q = quadrics[a];
+                        q += quadrics[b];
+                        const double costAB = isLocked(a) ? std::numeric_limits<double>::max() : q.Error(position(b));
+                        const double costBA = isLocked(b) ? std::numeric_limits<double>::max() : q.Error(position(a));
+
+                        const Collapse collapse = costAB <= costBA ? Collapse{a, b, costAB} : Collapse{b, a, costBA};
+                        if (collapse.cost <= errorLimit)
+                            collapses.push_back(collapse);
+                    }
+                }
+                if (collapses.empty())
+                {
+                    stuck = true;
+                    break;
+                }
+
+                std::sort(collapses.begin(), collapses.end(), [](const Collapse &l, const Collapse &r)
+                {
+                    return std::tie(l.cost, l.from, l.to) < std::tie(r.cost, r.from, r.to);
+                });
+
+                // collapse independent edges, every vertex at most once per pass
+                std::iota(remap.begin(), remap.end(), 0u);
+                std::fill(touched.begin(), touched.end(), 0);
+                const uint32_t removeLimit = triangleCount - static_cast<uint32_t>(targetIndexCount / 3);
+                uint32_t removed = 0;
+
+                for (const Collapse &collapse : collapses)
+                {
+                    if (removed >= removeLimit)
+                        break;
+                    if (touched[collapse.from] || touched[collapse.to] || !isValid(collapse.from, collapse.to))
+                        continue;
+
+                    for (uint32_t k = adjacencyOffsets[collapse.from]; k < adjacencyOffsets[collapse.from + 1]; ++k)
+                    {
+                        const size_t t = static_cast<size_t>(adjacency[k]) * 3;
+                        if (remap[current[t]] == collapse.to || remap[current[t + 1]] == collapse.to || remap[current[t + 2]] == collapse.to)
+                            removed++;
+                    }
+
+                    remap[collapse.from] = collapse.to;
+                    touched[collapse.from] = touched[collapse.to] = 1;
+                    quadrics[collapse.to] += quadrics[collapse.from];
+                    maxError = std::max(maxError, collapse.cost);
+                }
+                if (removed == 0)
+                {
+                    stuck = true;
+                    break;
+                }
+
+                // rewrite, dropping collapsed triangles
+                size_t write = 0;
+                for (size_t i = 0; i < current.size(); i += 3)
+                {
+                    const uint32_t a = remap[current[i]], b = remap[current[i + 1]], c = remap[current[i + 2]];
+                    if (a == b || a == c || b == c)
+                        continue;
+
+                    current[write++] = a;
+                    current[write++] = b;
+                    current[write++] = c;
+                }
+                current.resize(write);
+            }
+
+            levels.push_back(current);
+            errors.push_back(static_cast<float>(std::sqrt(maxError)));
+        }
+    }
+}
+
+std::vector<unsigned int> MeshSimplifier::Simplify(const MeshViews &views, const std::vector<unsigned int> &indices, size_t targetIndexCount,
+                                                   float targetError, float *resultError)
+{
+    std::vector<std::vector<unsigned int>> levels;
+    std::vector<float> errors;
+    SimplifyLevels(views, indices, {targetIndexCount}, targetError, levels, errors);
+
+    if (resultError)
+        *resultError = errors.empty() ? 0.0f : errors[0];
+    return levels.empty() ? indices : std::move(levels[0]);
+}
+
+LodChain MeshSimplifier::BuildLodChain(const MeshViews &views, std::vector<unsigned int> &lodIndices, const LodSettings &settings)
+{
+    lodIndices.clear();
+    LodChain chain;
+    std::vector<MeshLod> &lods = chain.levels;
+    if (views.indices.count == 0 || views.positions.Empty())
+        return chain;
+
+    lods.push_back({0, views.indices.count, 0.0f});
+
+    std::vector<unsigned int> full(views.indices.count);
+    views.indices.CopyTo(full.data());
+
+    // error limit relative to the mesh extent
+    glm::vec3 min(std::numeric_limits<float>::max());
+    glm::vec3 max(std::numeric_limits<float>::lowest());
+    for (uint32_t v = 0; v < views.positions.count; ++v)
+    {
+        min = glm::min(min, glm::make_vec3(views.positions[v]));
+        max = glm::max(max, glm::make_vec3(views.positions[v]));
+    }
+    const glm::vec3 extent = max - min;
+    chain.center = (min + max) * 0.5f;
+    chain.radius = glm::length(extent) * 0.5f;
+    const float errorLimit = settings.maxError * std::max({extent.x, extent.y, extent.z});
+
+    // triangle targets of the levels
+    std::vector<size_t> targets;
+    float triangles = static_cast<float>(full.size() / 3);
+    while (targets.size() < settings.maxLevels && triangles > settings.minTriangles)
+    {
+        triangles = std::max(triangles * settings.reduction, static_cast<float>(settings.minTriangles));
+        targets.push_back(static_cast<size_t>(triangles) * 3);
+    }
+    if (targets.empty())
+        return chain;
+
+    // one simplification run, snapshotted at every target
+    std::vector<std::vector<unsigned int>> levels;
+    std::vector<float> errors;
+    SimplifyLevels(views, full, targets, errorLimit, levels, errors);
+
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        // seams, borders or the error limit end the chain once a level barely reduces anything
+        std::vector<unsigned int> &lod = levels[i];
+        if (lod.size() > static_cast<size_t>(lods.back().indexCount) * 9 / 10)
+            break;
+
+        MeshOptimizer::OptimizeVertexCache(lod, views.positions.count);
+        lods.push_back({static_cast<uint32_t>(full.size() + lodIndices.size()), static_cast<uint32_t>(lod.size()), errors[i]});
+        lodIndices.insert(lodIndices.end(), lod.begin(), lod.end());
+    }
+
+    return chain;
+}
+
+uint32_t LodChain::Select(const glm::vec3 &eye, float pixelScale, float maxPixelError) const
+{
+    // projected error = error / distance * pixelScale, inside the bounds only the full mesh is used
+    const float distance = glm::distance(eye, center) - radius;
+    if (distance <= 0.0f)
+        return 0;
+
+    uint32_t selected = 0;
+    for (uint32_t i = 1; i < levels.size(); ++i)
+    {
+        if (levels[i].error * pixelScale > maxPixelError * distance)
+            break;
+        selected = i;
+    }
+    return selected;
+}
@@ -0,0 +1,90 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       MeshSimplifier.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Quadric error metric simplification and level of detail chains.
+ *
+ *  This file declares the MeshSimplifier class. Simplification collapses
+ *  edges onto existing vertices in order of their quadric error (Garland and
+ *  Heckbert 1997), so every level of detail is just another index buffer over
+ *  the original vertices. Vertices on attribute seams (same position,
+ *  different normal or UV) and on open borders are never moved, which keeps
+ *  hard edges, UV islands and silhouettes of open meshes intact. A runtime
+ *  selector picks the coarsest level whose projected error stays below a
+ *  pixel threshold.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "MeshSource.h"
+
+/**
+ * @struct MeshLod
+ * @brief One level of detail, an index range of the shared index buffer.
+ */
+struct MeshLod
+{
+    uint32_t indexOffset = 0; ///< first index in the index buffer
+    uint32_t indexCount  = 0;
+    float    error       = 0.0f; ///< object space deviation from the full mesh
+};
+
+/**
+ * @struct LodSettings
+ * @brief Shape of a generated level of detail chain.
+ */
+struct LodSettings
+{
+    uint32_t maxLevels    = 4;     ///< levels besides the full mesh
+    float    reduction    = 0.5f;  ///< triangle ratio between two consecutive levels
+    float    maxError     = 0.05f; ///< largest error relative to the mesh extent, the chain stops beyond it
+    uint32_t minTriangles = 256;   ///< meshes or levels below this are not simplified further
+};
+
+/**
+ * @struct LodChain
+ * @brief Levels of detail of one mesh with the bounding sphere used to select them.
+ */
+struct LodChain
+{
+    std::vector<MeshLod> levels; ///< level 0 is the full mesh
+    glm::vec3 center = glm::vec3(0.0f);
+    float     radius = 0.0f;
+
+    /**
+     * @brief Pick the coarsest level whose error projects to at most maxPixelError.
+     * @param eye           Camera position in the object space of the mesh.
+     * @param pixelScale    Pixels covered by one unit at distance one, see MeshSimplifier::PixelScale().
+     * @param maxPixelError Allowed screen-space error in pixels.
+     */
+    [[nodiscard]] uint32_t Select(const glm::vec3 &eye, float pixelScale, float maxPixelError = 1.0f) const;
+};
+
+class MeshSimplifier
+{
+public:
+    /**
+     * @brief Collapse edges until the target index count or the error limit is reached.
+     * @param views            Positions (and normals/uvs for seam detection) of the mesh.
+     * @param indices          Triangle list to simplify.
+     * @param targetIndexCount Index count to reach, the result may stay above it.
+     * @param targetError      Largest allowed object space deviation.
+     * @param[out] resultError Optional deviation of the result.
+     * @return Triangle list over the same vertices.
+     */
+    static std::vector<unsigned int> Simplify(const MeshViews &views, const std::vector<unsigned int> &indices, size_t targetIndexCount,
+                                              float targetError, float *resultError = nullptr);
+
+    /**
+     * @brief Generate simplified levels of the mesh, each vertex cache optimized.
+     * @param views            Full mesh, indexed.
+     * @param[out] lodIndices  Indices of levels 1.., meant to be stored right after the full index buffer.
+     * @return Levels including the full mesh as level 0, offsets relative to the full index buffer.
+     */
+    static LodChain BuildLodChain(const MeshViews &views, std::vector<unsigned int> &lodIndices, const LodSettings &settings = {});
+
+    /// Pixels per unit at distance one for a perspective projection matrix and viewport height.
+    static float PixelScale(const glm::mat4 &projection, float viewportHeight) { return projection[1][1] * viewportHeight * 0.5f; }
+};
@@ -1,5 +1,93 @@
 #include "MeshSource.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#else
+#undef IMPL_MESH_SIMD_INTERLEAVE
+#endif
+
+uint32_t IndexView::operator[](size_t i) const
+{
+    switch (size)
+    {
+        case 1: return data[i];
+        case 2: return reinterpret_cast<const uint16_t *>(data)[i];
+        default: return reinterpret_cast<const uint32_t *>(data)[i];
+    }
+}
+
+void IndexView::CopyTo(unsigned int *dst) const
+{
+    if (count == 0)
+        return;
+
+    switch (size)
+    {
+        case 1:
+            std::copy(data, data + count, dst);
+            break;
+        case 2:
+            std::copy(reinterpret_cast<const uint16_t *>(data), reinterpret_cast<const uint16_t *>(data) + count, dst);
+            break;
+        default:
+            std::memcpy(dst, data, static_cast<size_t>(count) * sizeof(unsigned int));
+            break;
+    }
+}
+
+void IndexView::CopyTo(uint16_t *dst) const
+{
+    if (count == 0)
+        return;
+
+    switch (size)
+    {
+        case 1:
+            std::copy(data, data + count, dst);
+            break;
+        case 2:
+            std::memcpy(dst, data, static_cast<size_t>(count) * sizeof(uint16_t));
+            break;
+        default:
+        {
+            const auto *src = reinterpret_cast<const uint32_t *>(data);
+            for (uint32_t i = 0; i < count; ++i)
+                dst[i] = static_cast<uint16_t>(src[i]);
+            break;
+        }
+    }
+}
+
+MeshViews InterleavedView::Views() const
+{
+    MeshViews views;
+    if (!vertices || vertexCount == 0)
+        return views;
+
+    const auto *data = reinterpret_cast<const uint8_t *>(vertices);
+    const uint32_t strideBytes = Stride() * sizeof(float);
+    uint32_t offset = 0;
+
+    const auto view = [&](bool present, uint32_t components) -> AttributeView
+    {
+        if (!present)
+            return {};
+
+        const AttributeView attribute{data + offset, vertexCount, strideBytes, components};
+        offset += components * sizeof(float);
+        return attribute;
+    };
+
+    views.positions = view(true, 3);
+    views.normals   = view(hasNormals, 3);
+    views.uvs       = view(hasUVs, 2);
+    views.tangents  = view(hasTangents, 3);
+    if (indices && indexCount)
+        views.indices = {reinterpret_cast<const uint8_t *>(indices), indexCount, sizeof(unsigned int)};
+
+    return views;
+}
+
 MeshSource::MeshSource(uint32_t vertexCount, uint32_t faceCount) :
     _vertexCount(vertexCount), _faceCount(faceCount), _texCoordChannelCount(0)
 {}
@@ -74,6 +162,10 @@ const float *MeshSource::TexCoords(int channel) const
 
 bool MeshSource::IsIndexed() const
 {
+    if (HasInterleaved())
+        return _interleaved.indexCount > 0;
+    if (HasViews())
+        return _views.indices.count > 0;
     return !_indices.empty();
 }
 
@@ -86,3 +178,189 @@ const unsigned int *MeshSource::Indices() const
 {
     return _indices.data();
 }
+
+void MeshSource::SetInterleaved(const InterleavedView &view, std::shared_ptr<const void> storage)
+{
+    _interleaved = view;
+    _storage = std::move(storage);
+    UpdateCounts();
+}
+
+bool MeshSource::HasInterleaved() const
+{
+    return _interleaved.vertices != nullptr;
+}
+
+const InterleavedView &MeshSource::Interleaved() const
+{
+    return _interleaved;
+}
+
+void MeshSource::SetViews(const MeshViews &views, std::shared_ptr<const void> storage)
+{
+    _views = views;
+    _storage = std::move(storage);
+    UpdateCounts();
+}
+
+bool MeshSource::HasViews() const
+{
+    return _views.positions.data != nullptr;
+}
+
+MeshViews MeshSource::Views() const
+{
+    if (HasViews())
+        return _views;
+    if (HasInterleaved())
+        return _interleaved.Views();
+
+    const auto view = [this](const std::vector<float> &attribute) -> AttributeView
+    {
+        if (attribute.empty() || _vertexCount == 0)
+            return {};
+
+        const auto components = static_cast<uint32_t>(attribute.size() / _vertexCount);
+        return {reinterpret_cast<const uint8_t *>(attribute.data()), _vertexCount, components * static_cast<uint32_t>(sizeof(float)), components};
+    };
+
+    MeshViews views;
+    views.positions = view(_positions);
+    views.normals   = view(_normals);
+    // glTF scenes fill _uvs, single-mesh loads fill the first texture coordinate channel
+    views.uvs       = view(!_uvs.empty() ? _uvs : _texCoordChannels[0]);
+    views.tangents  = view(_tangents);
+    if (!_indices.empty())
+        views.indices = {reinterpret_cast<const uint8_t *>(_indices.data()), static_cast<uint32_t>(_indices.size()), sizeof(unsigned int)};
+
+    return views;
+}
+
+InterleavedView MeshSource::Layout() const
+{
+    const MeshViews views = Views();
+
+    InterleavedView layout;
+    layout.vertexCount = views.positions.count;
+    layout.indexCount  = views.indices.count;
+    layout.hasNormals  = !views.normals.Empty();
+    layout.hasUVs      = !views.uvs.Empty();
+    layout.hasTangents = !views.tangents.Empty() && views.tangents.components >= 3;
+    return layout;
+}
+
+void MeshSource::Interleave(float *dst) const
+{
+    const MeshViews views = Views();
+    const InterleavedView layout = Layout();
+    const uint32_t stride = layout.Stride();
+
+    uint32_t v = 0;
+#ifdef IMPL_MESH_SIMD_INTERLEAVE
+    // Gather every attribute with one unaligned 4-wide load and store. Loads and stores may touch one float
+    // past an element; that float belongs to the next element or field and is overwritten in order, and the
+    // last vertex is left to the scalar loop so nothing is read or written outside of the buffers.
+    for (; v + 1 < layout.vertexCount; ++v)
+    {
+        float *out = dst + static_cast<size_t>(v) * stride;
+
+        _mm_storeu_ps(out, _mm_loadu_ps(views.positions[v]));
+        out += 3;
+        if (layout.hasNormals)
+        {
+            _mm_storeu_ps(out, _mm_loadu_ps(views.normals[v]));
+            out += 3;
+        }
+        if (layout.hasUVs)
+        {
+            // 64-bit integer moves, uv pairs are only 4-byte aligned
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_loadl_epi64(reinterpret_cast<const __m128i *>(views.uvs[v])));
+            out += 2;
+        }
+        if (layout.hasTangents)
+            _mm_storeu_ps(out, _mm_loadu_ps(views.tangents[v]));
+    }
+#endif
+
+    for (; v < layout.vertexCount; ++v)
+    {
+        float *out = dst + static_cast<size_t>(v) * stride;
+
+        out = std::copy_n(views.positions[v], 3, out);
+        if (layout.hasNormals)
+            out = std::copy_n(views.normals[v], 3, out);
+        if (layout.hasUVs)
+            out = std::copy_n(views.uvs[v], 2, out);
+        if (layout.hasTangents)
+            std::copy_n(views.tangents[v], 3, out);
+    }
+}
+
+void MeshSource::Interleave(std::vector<float> &out, InterleavedView &layout) const
+{
+    layout = Layout();
+    out.resize(static_cast<size_t>(layout.vertexCount) * layout.Stride());
+    Interleave(out.data());
+}
+
+void MeshSource::Detach()
+{
+    if (HasViews())
+    {
+        const MeshViews views = _views;
+        const auto copy = [](const AttributeView &view, std::vector<float> &attribute)
+        {
+            attribute.resize(static_cast<size_t>(view.count) * view.components);
+            for (uint32_t i = 0; i < view.count; ++i)
+                std::copy_n(view[i], view.components, &attribute[static_cast<size_t>(i) * view.components]);
+        };
+
+        copy(views.positions, _positions);
+        copy(views.normals, _normals);
+        copy(views.uvs, _uvs);
+        copy(views.tangents, _tangents);
+        _indices.resize(views.indices.count);
+        views.indices.CopyTo(_indices.data());
+
+        _views = {};
+        _storage.reset();
+        UpdateCounts();
+        return;
+    }
+
+    if (!HasInterleaved())
+        return;
+
+    const InterleavedView view = _interleaved;
+    const uint32_t stride = view.Stride();
+
+    _positions.resize(view.vertexCount * 3);
+    _normals.resize(view.hasNormals ? view.vertexCount * 3 : 0);
+    _uvs.resize(view.hasUVs ? view.vertexCount * 2 : 0);
+    _tangents.resize(view.hasTangents ? view.vertexCount * 3 : 0);
+
+    for (uint32_t v = 0; v < view.vertexCount; ++v)
+    {
+        const float *src = view.vertices + static_cast<size_t>(v) * stride;
+
+        std::copy(src, src + 3, &_positions[v * 3]);
+        src += 3;
+        if (view.hasNormals)
+        {
+            std::copy(src, src + 3, &_normals[v * 3]);
+            src += 3;
+        }
+        if (view.hasUVs)
+        {
+            std::copy(src, src + 2, &_uvs[v * 2]);
+            src += 2;
+        }
+        if (view.hasTangents)
+            std::copy(src, src + 3, &_tangents[v * 3]);
+    }
+    _indices.assign(view.indices, view.indices + view.indexCount);
+
+    _interleaved = {};
+    _storage.reset();
+    UpdateCounts();
+}
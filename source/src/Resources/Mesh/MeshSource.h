@@ -16,6 +16,80 @@
 #pragma once
 #include <cstdint>
 
+// Features
+#define IMPL_MESH_SIMD_INTERLEAVE
+
+/**
+ * @struct AttributeView
+ * @brief Strided float attribute stored outside of MeshSource, e.g. inside a glTF buffer.
+ */
+struct AttributeView
+{
+    const uint8_t *data = nullptr;
+    uint32_t count      = 0; ///< number of elements
+    uint32_t stride     = 0; ///< bytes between two elements
+    uint32_t components = 0; ///< floats per element
+
+    [[nodiscard]] bool Empty() const { return data == nullptr || count == 0; }
+    [[nodiscard]] const float *operator[](size_t i) const { return reinterpret_cast<const float *>(data + i * stride); }
+};
+
+/**
+ * @struct IndexView
+ * @brief Tightly packed 8, 16 or 32-bit indices stored outside of MeshSource.
+ */
+struct IndexView
+{
+    const uint8_t *data = nullptr;
+    uint32_t count = 0;
+    uint32_t size  = 0; ///< bytes per index
+
+    [[nodiscard]] uint32_t operator[](size_t i) const;
+    /// Widen all indices to 32 bits into dst, which must hold count elements.
+    void CopyTo(unsigned int *dst) const;
+    /// Convert all indices to 16 bits into dst, which must hold count elements; every index must be below 65536.
+    void CopyTo(uint16_t *dst) const;
+};
+
+/**
+ * @struct MeshViews
+ * @brief Set of attribute and index views describing one mesh.
+ */
+struct MeshViews
+{
+    AttributeView positions;
+    AttributeView normals;
+    AttributeView uvs;
+    AttributeView tangents;
+    IndexView     indices;
+};
+
+/**
+ * @struct InterleavedView
+ * @brief Interleaved vertex stream (position | normal | uv | tangent) and indices owned by external storage.
+ *
+ * Used when mesh data is consumed in place, e.g. straight from a memory-mapped MeshCache file.
+ */
+struct InterleavedView
+{
+    const float        *vertices = nullptr;
+    const unsigned int *indices  = nullptr;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount  = 0;
+
+    bool hasNormals  = false;
+    bool hasUVs      = false;
+    bool hasTangents = false;
+
+    /// Number of floats per vertex.
+    [[nodiscard]] uint32_t Stride() const
+    {
+        return 3 + (hasNormals ? 3 : 0) + (hasUVs ? 2 : 0) + (hasTangents ? 3 : 0);
+    }
+    /// Attribute and index views into the stream, empty for attributes that are not present.
+    [[nodiscard]] MeshViews Views() const;
+};
+
 /// Class containing all necessary data to construct a mesh, possibly with indexing.
 class MeshSource
 {
@@ -34,6 +108,7 @@ public:
 
     [[nodiscard]] uint32_t VertexCount() const;
     [[nodiscard]] uint32_t FaceCount() const;
+    // Attribute vectors only, null while the data lives in external storage (see Views())
     [[nodiscard]] const float *Positions() const;
     [[nodiscard]] const float *Normals() const;
     [[nodiscard]] const float *Tangents() const;
@@ -44,8 +119,56 @@ public:
     void SetIndices(const unsigned int *indices);
     [[nodiscard]] const unsigned int *Indices() const;
 
+    /**
+     * @brief Use an interleaved stream from external storage instead of the attribute vectors.
+     * @param view    Interleaved vertices and indices.
+     * @param storage Owner of the memory the view points into, kept alive by this MeshSource.
+     */
+    void SetInterleaved(const InterleavedView &view, std::shared_ptr<const void> storage);
+    [[nodiscard]] bool HasInterleaved() const;
+    [[nodiscard]] const InterleavedView &Interleaved() const;
+
+    /**
+     * @brief Use attribute views into external storage instead of copying into the attribute vectors.
+     * @param views   Strided attributes and indices, positions are required.
+     * @param storage Owner of the memory the views point into, kept alive by this MeshSource.
+     */
+    void SetViews(const MeshViews &views, std::shared_ptr<const void> storage);
+    [[nodiscard]] bool HasViews() const;
+    /// Views of the current attributes: the external ones, views into the interleaved stream or views over the attribute vectors.
+    [[nodiscard]] MeshViews Views() const;
+
+    /// Interleaved layout (attributes present, counts) that Interleave() produces, without data pointers.
+    [[nodiscard]] InterleavedView Layout() const;
+    /**
+     * @brief Pack the attributes into one interleaved stream (position | normal | uv | tangent).
+     * @param[out] dst Destination of Layout().vertexCount * Layout().Stride() floats, e.g. a mapped GL buffer.
+     */
+    void Interleave(float *dst) const;
+    /**
+     * @brief Pack the attributes into one interleaved stream.
+     * @param[out] out    Interleaved vertices (position | normal | uv | tangent).
+     * @param[out] layout Receives which optional attributes are present.
+     */
+    void Interleave(std::vector<float> &out, InterleavedView &layout) const;
+    /// Copy external data (interleaved stream or attribute views) into the attribute vectors and release the storage.
+    void Detach();
+
     void UpdateCounts()
     {
+        if (HasInterleaved())
+        {
+            _vertexCount = _interleaved.vertexCount;
+            _faceCount   = (_interleaved.indexCount ? _interleaved.indexCount : _vertexCount) / 3;
+            return;
+        }
+        if (HasViews())
+        {
+            _vertexCount = _views.positions.count;
+            _faceCount   = (_views.indices.count ? _views.indices.count : _vertexCount) / 3;
+            return;
+        }
+
         _vertexCount = static_cast<uint32_t>(_positions.size() / 3);
         _faceCount   = IsIndexed() ? static_cast<uint32_t>(_indices.size() / 3)
                                    : _vertexCount / 3;
@@ -65,4 +188,9 @@ public:
 
     std::string diffusePath;
     std::string specularPath;
+
+private:
+    InterleavedView _interleaved;
+    MeshViews _views;
+    std::shared_ptr<const void> _storage;
 };
@@ -0,0 +1,143 @@
+#include "MeshletBuilder.h"
+
+namespace
+{
+    /// Below this spread of normals (about 84 deg from the axis) the cone cannot reject anything useful
+    constexpr float MinConeDot = 0.1f;
+
+    void ComputeBounds(Meshlet &meshlet, const MeshViews &views)
+    {
+        const uint32_t first = meshlet.indexOffset;
+        const uint32_t last  = meshlet.indexOffset + meshlet.triangleCount * 3;
+
+        // AABB and sphere around its center
+        glm::vec3 min(std::numeric_limits<float>::max());
+        glm::vec3 max(std::numeric_limits<float>::lowest());
+        for (uint32_t i = first; i < last; ++i)
+        {
+            const glm::vec3 p = glm::make_vec3(views.positions[views.indices[i]]);
+            min = glm::min(min, p);
+            max = glm::max(max, p);
+        }
+        meshlet.boundsMin = min;
+        meshlet.boundsMax = max;
+        meshlet.center = (min + max) * 0.5f;
+
+        float radius2 = 0.0f;
+        for (uint32_t i = first; i < last; ++i)
+            radius2 = std::max(radius2, glm::distance2(meshlet.center, glm::make_vec3(views.positions[views.indices[i]])));
+        meshlet.radius = std::sqrt(radius2);
+
+        // normal cone: average direction and the widest deviation from it
+        std::vector<glm::vec3> normals;
+        normals.reserve(meshlet.triangleCount);
+        glm::vec3 axis(0.0f);
+        for (uint32_t i = first; i < last; i += 3)
+        {
+            const glm::vec3 a = glm::make_vec3(views.positions[views.indices[i]]);
+            const glm::vec3 b = glm::make_vec3(views.positions[views.indices[i + 1]]);
+            const glm::vec3 c = glm::make_vec3(views.positions[views.indices[i + 2]]);
+            const glm::vec3 n = glm::cross(b - a, c - a);
+            const float length = glm::length(n);
+            if (length <= 0.0f)
+                continue; // degenerate triangles are never rasterized
+
+            normals.push_back(n / length);
+            axis += normals.back();
+        }
+
+        const float axisLength = glm::length(axis);
+        if (normals.empty() || axisLength <= 0.0f)
+            return;
+        meshlet.coneAxis = axis / axisLength;
+
+        float minDot = 1.0f;
+        for (const glm::vec3 &n : normals)
+            minDot = std::min(minDot, glm::dot(meshlet.coneAxis, n));
+
+        meshlet.coneCutoff = minDot <= MinConeDot ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+std::vector<Meshlet> MeshletBuilder::Build(const MeshViews &views, uint32_t maxVertices, uint32_t maxTriangles)
+{
+    std::vector<Meshlet> meshlets;
+    const uint32_t triangleCount = views.indices.count / 3;
+    if (triangleCount == 0 || views.positions.Empty() || maxVertices < 3 || maxTriangles == 0)
+        return meshlets;
+
+    // last meshlet (+1) that referenced each vertex
+    std::vector<uint32_t> owner(views.positions.count, 0);
+
+    Meshlet current;
+    for (uint32_t t = 0; t < triangleCount; ++t)
+    {
+        const uint32_t a = views.indices[t * 3 + 0];
+        const uint32_t b = views.indices[t * 3 + 1];
+        const uint32_t c = views.indices[t * 3 + 2];
+        if (a >= owner.size() || b >= owner.size() || c >= owner.size())
+        {
+            LOG_ERROR("Triangle {} references a vertex out of range [0, {}).", t, owner.size());
+            return {};
+        }
+
+        // distinct vertices of the triangle not yet in the meshlet
+        const auto newVertices = [&](uint32_t id)
+        {
+            return static_cast<uint32_t>(owner[a] != id) + (owner[b] != id && b != a) + (owner[c] != id && c != a && c != b);
+        };
+
+        auto id = static_cast<uint32_t>(meshlets.size() + 1);
+        uint32_t added = newVertices(id);
+
+        // close the meshlet if the triangle does not fit
+        if (current.triangleCount == maxTriangles || current.vertexCount + added > maxVertices)
+        {
+            ComputeBounds(current, views);
+            meshlets.push_back(current);
+
+            current = {};
+            current.indexOffset = t * 3;
+            id = static_cast<uint32_t>(meshlets.size() + 1);
+            added = newVertices(id);
+        }
+
+        owner[a] = owner[b] = owner[c] = id;
+        current.vertexCount += added;
+        current.triangleCount++;
+    }
+
+    ComputeBounds(current, views);
+    meshlets.push_back(current);
+    return meshlets;
+}
+
+bool MeshletBuilder::IsVisible(const Meshlet &meshlet, const Frustum &frustum, const glm::vec3 &eye, MeshletCullStats *stats)
+{
+    bool visible = true;
+    if (!frustum.Intersects(meshlet.center, meshlet.radius))
+    {
+        visible = false;
+        if (stats)
+            stats->frustumCulled++;
+    }
+    else
+    {
+        const glm::vec3 toCenter = meshlet.center - eye;
+        if (glm::dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius)
+        {
+            visible = false;
+            if (stats)
+                stats->coneCulled++;
+        }
+    }
+
+    if (stats)
+    {
+        stats->meshlets++;
+        stats->triangles += meshlet.triangleCount;
+        if (!visible)
+            stats->trianglesCulled += meshlet.triangleCount;
+    }
+    return visible;
+}
@@ -0,0 +1,96 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       MeshletBuilder.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Splitting of indexed meshes into culled clusters (meshlets).
+ *
+ *  This file declares the Meshlet struct and the MeshletBuilder class. The
+ *  builder cuts the index buffer of a mesh into consecutive clusters of a
+ *  bounded number of vertices and triangles, so every meshlet is a plain
+ *  index range of the uploaded buffer. Each meshlet carries a bounding
+ *  sphere, an AABB and a normal cone, which allow rejecting clusters outside
+ *  the view frustum or facing away from the camera before drawing.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "MeshSource.h"
+#include "src/Utils/Frustum.h"
+
+/**
+ * @struct Meshlet
+ * @brief Consecutive index range of a mesh with its culling bounds, all in object space.
+ */
+struct Meshlet
+{
+    uint32_t indexOffset   = 0; ///< first index of the range
+    uint32_t triangleCount = 0;
+    uint32_t vertexCount   = 0; ///< unique vertices referenced by the range
+
+    // Bounds
+    glm::vec3 center    = glm::vec3(0.0f);
+    float     radius    = 0.0f;
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+
+    // Normal cone, the meshlet is back-facing if dot(center - eye, coneAxis) >= coneCutoff * |center - eye| + radius
+    glm::vec3 coneAxis   = glm::vec3(0.0f, 0.0f, 1.0f);
+    float     coneCutoff = 1.0f; ///< sine of the widest normal deviation, 1 disables the test
+};
+
+/**
+ * @struct MeshletCullStats
+ * @brief Result of culling meshlets, summable over meshes and frames.
+ */
+struct MeshletCullStats
+{
+    uint64_t meshlets        = 0;
+    uint64_t triangles       = 0;
+    uint64_t frustumCulled   = 0; ///< meshlets outside the frustum
+    uint64_t coneCulled      = 0; ///< meshlets inside the frustum but back-facing
+    uint64_t trianglesCulled = 0;
+
+    [[nodiscard]] double CulledRatio() const { return triangles ? static_cast<double>(trianglesCulled) / triangles : 0.0; }
+
+    MeshletCullStats &operator+=(const MeshletCullStats &other)
+    {
+        meshlets        += other.meshlets;
+        triangles       += other.triangles;
+        frustumCulled   += other.frustumCulled;
+        coneCulled      += other.coneCulled;
+        trianglesCulled += other.trianglesCulled;
+        return *this;
+    }
+};
+
+class MeshletBuilder
+{
+public:
+    /// Limits that fit the usual 64 vertex / 126 primitive mesh shader budgets
+    static constexpr uint32_t MaxVertices  = 64;
+    static constexpr uint32_t MaxTriangles = 124;
+
+    /**
+     * @brief Split the index buffer into consecutive meshlets.
+     *
+     * Triangles are taken in index buffer order, which after MeshOptimizer::Optimize is already
+     * clustered for vertex cache locality, and a new meshlet is started whenever a limit would be exceeded.
+     *
+     * @param views        Positions and indices of the mesh, see MeshSource::Views().
+     * @param maxVertices  Unique vertices per meshlet.
+     * @param maxTriangles Triangles per meshlet.
+     * @return Meshlets covering every triangle exactly once, empty for non-indexed meshes.
+     */
+    static std::vector<Meshlet> Build(const MeshViews &views, uint32_t maxVertices = MaxVertices, uint32_t maxTriangles = MaxTriangles);
+
+    /**
+     * @brief Test a meshlet against the frustum and its normal cone.
+     * @param frustum Frustum in the object space of the mesh.
+     * @param eye     Camera position in the object space of the mesh.
+     * @param stats   Optional statistics, accumulated.
+     * @return True if some triangle of the meshlet may be visible.
+     */
+    static bool IsVisible(const Meshlet &meshlet, const Frustum &frustum, const glm::vec3 &eye, MeshletCullStats *stats = nullptr);
+};
@@ -0,0 +1,129 @@
+#include "RangeAllocator.h"
+
+uint32_t RangeAllocator::Allocate(uint32_t size, uint32_t alignment)
+{
+    if (size == 0 || alignment == 0)
+        return Invalid;
+
+    // best fit, the padding in front of an aligned offset counts towards the size
+    auto best = _free.end();
+    uint32_t bestWaste = UINT32_MAX;
+    for (auto it = _free.begin(); it != _free.end(); ++it)
+    {
+        const uint32_t padding = (alignment - it->first % alignment) % alignment;
+        if (it->second < size || it->second - size < padding)
+            continue;
+
+        const uint32_t waste = it->second - size - padding;
+        if (waste < bestWaste)
+        {
+            best = it;
+            bestWaste = waste;
+            if (waste == 0)
+                break;
+        }
+    }
+    if (best == _free.end())
+        return Invalid;
+
+    // split the range into padding | allocation | rest
+    const uint32_t start   = best->first;
+    const uint32_t length  = best->second;
+    const uint32_t padding = (alignment - start % alignment) % alignment;
+    const uint32_t offset  = start + padding;
+    _free.erase(best);
+    if (padding)
+        _free.emplace(start, padding);
+    if (length - padding - size)
+        _free.emplace(offset + size, length - padding - size);
+
+    _used += size;
+    _allocations++;
+    return offset;
+}
+
+void RangeAllocator::Free(uint32_t offset, uint32_t size)
+{
+    if (size == 0 || offset == Invalid)
+        return;
+
+    // the range must not overlap a free one
+    auto next = _free.lower_bound(offset);
+    auto prev = next != _free.begin() ? std::prev(next) : _free.end();
+    if ((next != _free.end() && next->first < offset + size) || (prev != _free.end() && prev->first + prev->second > offset))
+    {
+        LOG_ERROR("Range {} + {} is already free.", offset, size);
+        return;
+    }
+
+    // merge with the free neighbours
+    uint32_t start = offset;
+    uint32_t end   = offset + size;
+    if (next != _free.end() && next->first == end)
+    {
+        end += next->second;
+        _free.erase(next);
+    }
+    if (prev != _free.end() && prev->first + prev->second == offset)
+    {
+        start = prev->first;
+        _free.erase(prev);
+    }
+    _free.emplace(start, end - start);
+
+    _used -= size;
+    _allocations--;
+}
+
+void RangeAllocator::Grow(uint32_t capacity)
+{
+    if (capacity <= _capacity)
+        return;
+
+    // extend the last free range if it touches the end
+    uint32_t start = _capacity;
+    if (!_free.empty())
+    {
+        auto last = std::prev(_free.end());
+        if (last->first + last->second == _capacity)
+        {
+            start = last->first;
+            _free.erase(last);
+        }
+    }
+    _free.emplace(start, capacity - start);
+    _capacity = capacity;
+}
+
+void RangeAllocator::Reset(uint32_t capacity)
+{
+    _free.clear();
+    if (capacity)
+        _free.emplace(0, capacity);
+    _capacity    = capacity;
+    _used        = 0;
+    _allocations = 0;
+}
+
+std::vector<uint32_t> RangeAllocator::Compact(const std::vector<uint32_t> &sizes, uint32_t alignment)
+{
+    // allocating in order from an empty allocator packs the ranges
+    Reset(_capacity);
+
+    std::vector<uint32_t> offsets(sizes.size());
+    for (size_t i = 0; i < sizes.size(); ++i)
+        offsets[i] = Allocate(sizes[i], alignment);
+    return offsets;
+}
+
+RangeAllocatorStats RangeAllocator::Stats() const
+{
+    RangeAllocatorStats stats;
+    stats.capacity    = _capacity;
+    stats.used        = _used;
+    stats.allocations = _allocations;
+    stats.freeRanges  = static_cast<uint32_t>(_free.size());
+    for (const auto &[offset, size] : _free)
+        stats.largestFree = std::max(stats.largestFree, size);
+    return stats;
+}
@@ -0,0 +1,72 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       RangeAllocator.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Free-list sub-allocation of ranges inside one large buffer.
+ *
+ *  This file declares the RangeAllocator class, a CPU only bookkeeping of
+ *  free and used ranges of a fixed capacity, measured in arbitrary units
+ *  (vertices or bytes). Free ranges are kept sorted by offset, allocation
+ *  takes the best fitting one and freeing merges a range with its free
+ *  neighbours, so holes only remain where live ranges separate them.
+ *  Compact() plans the packed offsets of the live ranges, the owner moves
+ *  the data itself, see GeometryArena.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+
+/**
+ * @struct RangeAllocatorStats
+ * @brief Occupancy and fragmentation of a RangeAllocator.
+ */
+struct RangeAllocatorStats
+{
+    uint32_t capacity    = 0;
+    uint32_t used        = 0;
+    uint32_t allocations = 0;
+    uint32_t freeRanges  = 0;
+    uint32_t largestFree = 0;
+
+    [[nodiscard]] uint32_t Free() const { return capacity - used; }
+    /// 0 when all free space is one range, towards 1 when it is scattered in small holes
+    [[nodiscard]] double Fragmentation() const { return Free() ? 1.0 - static_cast<double>(largestFree) / Free() : 0.0; }
+};
+
+class RangeAllocator
+{
+public:
+    static constexpr uint32_t Invalid = UINT32_MAX;
+
+    explicit RangeAllocator(uint32_t capacity = 0) { Reset(capacity); }
+
+    /**
+     * @brief Take the smallest free range that fits size units at the given alignment.
+     * @return Offset of the range, or Invalid if no free range is large enough.
+     */
+    [[nodiscard]] uint32_t Allocate(uint32_t size, uint32_t alignment = 1);
+    /// Return a range from Allocate(), merging it with adjacent free ranges.
+    void Free(uint32_t offset, uint32_t size);
+
+    /// Extend the capacity, the new space joins the free range at the end.
+    void Grow(uint32_t capacity);
+    /// Forget all allocations, the whole capacity becomes one free range.
+    void Reset(uint32_t capacity);
+    /**
+     * @brief Forget all allocations and allocate the given sizes again from the front, in order, leaving no holes.
+     * @return Offset of every size, Invalid for sizes of 0 or beyond the capacity.
+     */
+    [[nodiscard]] std::vector<uint32_t> Compact(const std::vector<uint32_t> &sizes, uint32_t alignment = 1);
+
+    [[nodiscard]] uint32_t Capacity() const { return _capacity; }
+    [[nodiscard]] uint32_t Used() const { return _used; }
+    [[nodiscard]] RangeAllocatorStats Stats() const;
+
+private:
+    std::map<uint32_t, uint32_t> _free; ///< offset -> size of every free range, never adjacent
+    uint32_t _capacity    = 0;
+    uint32_t _used        = 0;
+    uint32_t _allocations = 0;
+};
@@ -0,0 +1,207 @@
+#include "TriangleBvh.h"
+#include <cfloat>
+
+namespace
+{
+    /// Nodes a traversal keeps pending, median splits stay far below it for any mesh that fits in memory
+    constexpr uint32_t StackSize = 64;
+
+    /// Distance at which the ray enters the box, clamped to 0 inside it; FLT_MAX on a miss
+    float BoxEntry(const glm::vec3 &min, const glm::vec3 &max, const glm::vec3 &origin, const glm::vec3 &inverse)
+    {
+        const glm::vec3 t1 = (min - origin) * inverse;
+        const glm::vec3 t2 = (max - origin) * inverse;
+        const glm::vec3 near = glm::min(t1, t2);
+        const glm::vec3 far = glm::max(t1, t2);
+        const float entry = glm::max(glm::max(near.x, near.y), glm::max(near.z, 0.0f));
+        const float exit = glm::min(glm::min(far.x, far.y), far.z);
+        return entry <= exit ? entry : FLT_MAX;
+    }
+}
+
+void TriangleBvh::Build(const MeshViews &views)
+{
+    const AttributeView &positions = views.positions;
+    const IndexView &indices = views.indices;
+    const uint32_t cornerCount = indices.count ? indices.count : positions.count;
+
+    std::vector<glm::vec3> corners;
+    corners.reserve(cornerCount);
+    for (uint32_t i = 0; i + 2 < cornerCount; i += 3)
+    {
+        for (uint32_t k = 0; k < 3; k++)
+            corners.push_back(glm::make_vec3(positions[indices.count ? indices[i + k] : i + k]));
+    }
+    BuildCorners(corners);
+}
+
+void TriangleBvh::Build(const float *positions, uint32_t vertexCount, size_t stride, const unsigned int *indices, uint32_t indexCount)
+{
+    const uint32_t cornerCount = indices ? indexCount : vertexCount;
+
+    std::vector<glm::vec3> corners;
+    corners.reserve(cornerCount);
+    for (uint32_t i = 0; i + 2 < cornerCount; i += 3)
+    {
+        for (uint32_t k = 0; k < 3; k++)
+            corners.push_back(glm::make_vec3(positions + (indices ? indices[i + k] : i + k) * stride));
+    }
+    BuildCorners(corners);
+}
+
+void TriangleBvh::Clear()
+{
+    _nodes.clear();
+    _triangles.clear();
+}
+
+void TriangleBvh::BuildCorners(const std::vector<glm::vec3> &corners)
+{
+    Clear();
+    const auto count = static_cast<uint32_t>(corners.size() / 3);
+    if (count == 0)
+        return;
+
+    std::vector<glm::vec3> centroids(count);
+    std::vector<uint32_t> order(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        centroids[i] = (corners[i * 3] + corners[i * 3 + 1] + corners[i * 3 + 2]) / 3.0f;
+        order[i] = i;
+    }
+
+    // Halving every node gives at most 2 * count / MaxLeafTriangles nodes
+    _nodes.reserve(2 * (count / MaxLeafTriangles + 1));
+    Split(corners, centroids, order, 0, count);
+
+    _triangles.reserve(count);
+    for (const uint32_t triangle : order)
+    {
+        const glm::vec3 &a = corners[triangle * 3];
+        _triangles.push_back({a, corners[triangle * 3 + 1] - a, corners[triangle * 3 + 2] - a});
+    }
+}
+
+uint32_t TriangleBvh::Split(const std::vector<glm::vec3> &corners, const std::vector<glm::vec3> &centroids,
+                            std::vector<uint32_t> &order, uint32_t first, uint32_t count)
+{
+    const auto index = static_cast<uint32_t>(_nodes.size());
+    _nodes.emplace_back();
+
+    glm::vec3 min(FLT_MAX), max(-FLT_MAX);
+    glm::vec3 centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+    for (uint32_t i = first; i < first + count; i++)
+    {
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            min = glm::min(min, corners[order[i] * 3 + k]);
+            max = glm::max(max, corners[order[i] * 3 + k]);
+        }
+        centroidMin = glm::min(centroidMin, centroids[order[i]]);
+        centroidMax = glm::max(centroidMax, centroids[order[i]]);
+    }
+    _nodes[index].min = min;
+    _nodes[index].max = max;
+
+    // Small nodes and triangles sharing one centroid stay together
+    const glm::vec3 spread = centroidMax - centroidMin;
+    const int axis = spread.x >= spread.y && spread.x >= spread.z ? 0 : spread.y >= spread.z ? 1 : 2;
+    if (count <= MaxLeafTriangles || spread[axis] <= 0.0f)
+    {
+        _nodes[index].first = first;
+        _nodes[index].count = count;
+        return index;
+    }
+
+    // Median of the centroids along the longest axis, both halves get the same number of triangles
+    const uint32_t middle = first + count / 2;
+    std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + first + count,
+                     [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+
+    Split(corners, centroids, order, first, middle - first);
+    const uint32_t second = Split(corners, centroids, order, middle, first + count - middle);
+    _nodes[index].first = second;
+    return index;
+}
+
+bool TriangleBvh::Raycast(const glm::vec3 &origin, const glm::vec3 &direction, float &distance, Faces faces) const
+{
+    if (_nodes.empty())
+        return false;
+
+    const glm::vec3 inverse = 1.0f / direction;
+    if (BoxEntry(_nodes[0].min, _nodes[0].max, origin, inverse) >= distance)
+        return false;
+
+    bool hit = false;
+    uint32_t stack[StackSize];
+    uint32_t size = 0;
+    stack[size++] = 0;
+    while (size > 0)
+    {
+        const uint32_t index = stack[--size];
+        const Node &node = _nodes[index];
+        if (node.IsLeaf())
+        {
+            for (uint32_t i = node.first; i < node.first + node.count; i++)
+                hit |= TriangleHit(_triangles[i], origin, direction, distance, faces);
+            continue;
+        }
+
+        // Nearer child on top, so its hits cut off the farther one
+        uint32_t near = index + 1, far = node.first;
+        float nearEntry = BoxEntry(_nodes[near].min, _nodes[near].max, origin, inverse);
+        float farEntry = BoxEntry(_nodes[far].min, _nodes[far].max, origin, inverse);
+        if (farEntry < nearEntry)
+        {
+            std::swap(near, far);
+            std::swap(nearEntry, farEntry);
+        }
+        if (farEntry < distance)
+            stack[size++] = far;
+        if (nearEntry < distance)
+            stack[size++] = near;
+    }
+    return hit;
+}
+
+bool TriangleBvh::IntersectTriangle(const glm::vec3 &origin, const glm::vec3 &direction, const glm::vec3 &a, const glm::vec3 &b,
+                                    const glm::vec3 &c, float &distance, Faces faces)
+{
+    return TriangleHit({a, b - a, c - a}, origin, direction, distance, faces);
+}
+
+TriangleBvh::Faces TriangleBvh::ToObjectSpace(const glm::mat4 &model, glm::vec3 &origin, glm::vec3 &direction)
+{
+    const glm::mat4 inverse = glm::inverse(model);
+    origin = glm::vec3(inverse * glm::vec4(origin, 1.0f));
+    direction = glm::mat3(inverse) * direction;
+    return glm::determinant(glm::mat3(model)) < 0.0f ? Faces::Back : Faces::Front;
+}
+
+bool TriangleBvh::TriangleHit(const Triangle &triangle, const glm::vec3 &origin, const glm::vec3 &direction, float &distance, Faces faces)
+{
+    // det = -dot(direction, normal), positive where the triangle winds counter-clockwise towards the ray
+    const glm::vec3 p = glm::cross(direction, triangle.edge2);
+    const float det = glm::dot(triangle.edge1, p);
+    if ((faces == Faces::Front && !(det > 0.0f)) || (faces == Faces::Back && !(det < 0.0f)) || det == 0.0f)
+        return false;
+
+    const float inverseDet = 1.0f / det;
+    const glm::vec3 s = origin - triangle.a;
+    const float u = glm::dot(s, p) * inverseDet;
+    if (u < 0.0f || u > 1.0f)
+        return false;
+
+    const glm::vec3 q = glm::cross(s, triangle.edge1);
+    const float v = glm::dot(direction, q) * inverseDet;
+    if (v < 0.0f || u + v > 1.0f)
+        return false;
+
+    const float t = glm::dot(triangle.edge2, q) * inverseDet;
+    if (t < 0.0f || t >= distance)
+        return false;
+
+    distance = t;
+    return true;
+}
@@ -0,0 +1,116 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       TriangleBvh.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Static bounding volume hierarchy over the triangles of a mesh.
+ *
+ *  This file declares the TriangleBvh class, built once from the positions
+ *  and indices of a mesh when it is loaded. Triangles are split at the
+ *  median of their centroids along the longest axis until at most four are
+ *  left in a leaf, and stored in leaf order as one corner plus two edges.
+ *  Raycast() walks the nearer child first and skips every box beyond the
+ *  closest hit so far, so picking a mesh costs a few dozen box and triangle
+ *  tests instead of one per triangle.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "MeshSource.h"
+
+// Features
+#define IMPL_TRIANGLE_BVH
+
+class TriangleBvh
+{
+public:
+    /**
+     * @enum Faces
+     * @brief Sides of a triangle a ray can hit, front faces wind counter-clockwise towards the ray as in OpenGL.
+     */
+    enum class Faces
+    {
+        Front,
+        Back,
+        Both,
+    };
+
+    /// Build over the triangles of indexed or non-indexed views, see MeshSource::Views().
+    void Build(const MeshViews &views);
+    /**
+     * @brief Build over strided positions.
+     * @param positions   First position, three floats.
+     * @param vertexCount Number of positions.
+     * @param stride      Floats from one position to the next.
+     * @param indices     Three per triangle, or null for consecutive vertices.
+     * @param indexCount  Number of indices.
+     */
+    void Build(const float *positions, uint32_t vertexCount, size_t stride = 3,
+               const unsigned int *indices = nullptr, uint32_t indexCount = 0);
+    void Clear();
+
+    [[nodiscard]] bool Empty() const { return _nodes.empty(); }
+    [[nodiscard]] uint32_t TriangleCount() const { return static_cast<uint32_t>(_triangles.size()); }
+    [[nodiscard]] uint32_t NodeCount() const { return static_cast<uint32_t>(_nodes.size()); }
+
+    /**
+     * @brief Find the nearest triangle hit by a ray.
+     * @param origin    Start of the ray.
+     * @param direction Direction of the ray, distances are multiples of its length.
+     * @param[in,out] distance Hits at or beyond it are ignored, set to the nearest hit found.
+     * @param faces     Sides that count as a hit.
+     * @return True if a triangle was hit before distance.
+     */
+    bool Raycast(const glm::vec3 &origin, const glm::vec3 &direction, float &distance, Faces faces = Faces::Front) const;
+
+    /**
+     * @brief Intersect a ray with one triangle (Moeller-Trumbore).
+     * @param[in,out] distance Hits at or beyond it are ignored, set to the hit.
+     * @return True if the triangle was hit before distance.
+     */
+    static bool IntersectTriangle(const glm::vec3 &origin, const glm::vec3 &direction, const glm::vec3 &a, const glm::vec3 &b,
+                                  const glm::vec3 &c, float &distance, Faces faces = Faces::Front);
+
+    /**
+     * @brief Bring a world space ray into the object space of a model matrix.
+     * @param[in,out] origin    Start of the ray.
+     * @param[in,out] direction Direction of the ray, object space distances stay those of the world space ray.
+     * @return Faces the front faces of the object become, Back under a mirroring transform, which flips the winding.
+     */
+    static Faces ToObjectSpace(const glm::mat4 &model, glm::vec3 &origin, glm::vec3 &direction);
+
+private:
+    /// Triangles per leaf, below it the box tests cost more than the triangles they skip
+    static constexpr uint32_t MaxLeafTriangles = 4;
+
+    struct Triangle
+    {
+        glm::vec3 a;
+        glm::vec3 edge1; ///< b - a
+        glm::vec3 edge2; ///< c - a
+    };
+    struct Node
+    {
+        glm::vec3 min;
+        uint32_t  first = 0; ///< first triangle of a leaf, second child of an inner node (the first one follows the node)
+        glm::vec3 max;
+        uint32_t  count = 0; ///< triangles of a leaf, 0 for inner nodes
+
+        [[nodiscard]] bool IsLeaf() const { return count != 0; }
+    };
+
+    /// Build from three corners per triangle
+    void BuildCorners(const std::vector<glm::vec3> &corners);
+    /**
+     * @brief Append the node of triangles [first, first + count) of order and split it recursively.
+     * @param order Triangle of every leaf slot, reordered so the triangles of each node are consecutive.
+     * @return Index of the node.
+     */
+    uint32_t Split(const std::vector<glm::vec3> &corners, const std::vector<glm::vec3> &centroids,
+                   std::vector<uint32_t> &order, uint32_t first, uint32_t count);
+    static bool TriangleHit(const Triangle &triangle, const glm::vec3 &origin, const glm::vec3 &direction, float &distance, Faces faces);
+
+    std::vector<Node>     _nodes;     ///< depth first, the root first
+    std::vector<Triangle> _triangles; ///< in leaf order
+};
@@ -0,0 +1,27 @@
+#include "FrameUniforms.h"
+
+void FrameUniforms::Create()
+{
+    Destroy();
+
+    glCreateBuffers(1, &_ubo);
+    glNamedBufferStorage(_ubo, sizeof(FrameConstants), &_constants, GL_DYNAMIC_STORAGE_BIT);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Binding, _ubo);
+}
+
+void FrameUniforms::Destroy()
+{
+    if (_ubo) glDeleteBuffers(1, &_ubo);
+    _ubo = 0;
+}
+
+size_t FrameUniforms::Update(const FrameConstants &constants)
+{
+    if (!_ubo || std::memcmp(&_constants, &constants, sizeof(FrameConstants)) == 0)
+        return 0;
+
+    _constants = constants;
+    glNamedBufferSubData(_ubo, 0, sizeof(FrameConstants), &_constants);
+    _uploads++;
+    return sizeof(FrameConstants);
+}
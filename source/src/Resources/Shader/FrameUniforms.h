@@ -0,0 +1,74 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       FrameUniforms.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Uniform buffer with the per frame constants of all programs.
+ *
+ *  This file declares FrameConstants, the CPU mirror of FrameBlock in
+ *  res/Shaders/FrameBlock.glsl, and the FrameUniforms class owning its
+ *  buffer. The block is bound once to a fixed binding point shared by every
+ *  program, so camera matrices, time, fog and light flags are written once per
+ *  frame instead of being set as loose uniforms on each program and draw.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "GL/glew.h"
+
+/**
+ * @struct FrameConstants
+ * @brief CPU mirror of FrameBlock, member order and padding follow std140.
+ */
+struct FrameConstants
+{
+    glm::mat4 view           = glm::mat4(1.0f);
+    glm::mat4 projection     = glm::mat4(1.0f);
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+    glm::mat4 skyboxView     = glm::mat4(1.0f); ///< view without translation
+
+    glm::vec3 viewPosition = glm::vec3(0.0f);
+    float     time         = 0.0f;
+
+    glm::vec3 fogColor = glm::vec3(0.0f);
+    float     fogStart = 0.0f;
+    float     fogEnd   = 0.0f;
+    int       useFog   = 0;
+
+    int       useFlashLight = 0;
+    int       useFireLight  = 0;
+};
+static_assert(sizeof(FrameConstants) == 4 * sizeof(glm::mat4) + 48, "FrameConstants must match the std140 layout of FrameBlock");
+
+class FrameUniforms
+{
+public:
+    /// layout(binding) of FrameBlock
+    static constexpr GLuint Binding = 1;
+
+    FrameUniforms() = default;
+    ~FrameUniforms() { Destroy(); }
+
+    FrameUniforms(const FrameUniforms &) = delete;
+    FrameUniforms &operator=(const FrameUniforms &) = delete;
+
+    /// Create the buffer and bind it to Binding.
+    void Create();
+    void Destroy();
+
+    /**
+     * @brief Upload the constants of this frame, skipped if nothing changed since the last one.
+     * @return Bytes uploaded.
+     */
+    size_t Update(const FrameConstants &constants);
+
+    [[nodiscard]] const FrameConstants &Get() const { return _constants; }
+    [[nodiscard]] uint64_t Uploads() const { return _uploads; }
+
+private:
+    GLuint _ubo = 0;
+    FrameConstants _constants;
+
+    uint64_t _uploads = 0;
+};
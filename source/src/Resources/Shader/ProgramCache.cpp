@@ -0,0 +1,151 @@
+#include "ProgramCache.h"
+#include "src/Utils/Hash.h"
+#include "src/Utils/MappedFile.h"
+
+namespace fs = std::filesystem;
+
+uint64_t ProgramCache::Key(const ShaderSource &source)
+{
+    const std::string &driver = Driver();
+    if (driver.empty())
+        return 0;
+
+    // separators keep moving text between the parts from producing the same key
+    uint64_t hash = Fnv1a(driver);
+    hash = Fnv1a(std::string_view("\0", 1), hash);
+    hash = Fnv1a(source.GetVertexSource(), hash);
+    hash = Fnv1a(std::string_view("\0", 1), hash);
+    hash = Fnv1a(source.GetFragmentSource(), hash);
+    return hash;
+}
+
+unsigned int ProgramCache::Load(uint64_t key)
+{
+    if (key == 0)
+        return 0;
+
+    const fs::path cachePath = CachePath(key);
+    const MappedFile file(cachePath);
+    if (!file.IsOpen())
+    {
+        _stats.misses++;
+        return 0;
+    }
+
+    FileHeader header{};
+    if (file.Size() >= sizeof(FileHeader))
+        std::memcpy(&header, file.Data(), sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version || header.key != key ||
+        sizeof(FileHeader) + static_cast<size_t>(header.size) > file.Size())
+    {
+        LOG_WARNING("Program cache '{}' is invalid, recompiling.", cachePath.string());
+        _stats.misses++;
+        return 0;
+    }
+
+    const GLuint program = glCreateProgram();
+    glProgramBinary(program, header.format, file.Data() + sizeof(FileHeader), static_cast<GLsizei>(header.size));
+
+    // drivers may refuse binaries of their own after an update that kept the version string
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE)
+    {
+        LOG("Program cache '{}' was rejected by the driver, recompiling.", cachePath.string());
+        glDeleteProgram(program);
+        _stats.rejected++;
+        _stats.misses++;
+        return 0;
+    }
+
+    _stats.hits++;
+    return program;
+}
+
+bool ProgramCache::Store(uint64_t key, unsigned int program)
+{
+    if (key == 0 || program == 0)
+        return false;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return false;
+
+    std::vector<uint8_t> binary(static_cast<size_t>(length));
+    GLsizei written = 0;
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0)
+        return false;
+
+    // Write to a temporary file first, so an interrupted write never leaves a valid-looking cache
+    const fs::path cachePath = CachePath(key);
+    fs::path tmpPath = cachePath;
+    tmpPath += ".tmp";
+
+    std::error_code ec;
+    fs::create_directories(cachePath.parent_path(), ec);
+
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            LOG_WARNING("Failed to create program cache '{}'.", tmpPath.string());
+            return false;
+        }
+
+        FileHeader header{};
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = Version;
+        header.key     = key;
+        header.format  = format;
+        header.size    = static_cast<uint32_t>(written);
+
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(binary.data()), written);
+        if (!out)
+        {
+            LOG_WARNING("Failed to write program cache '{}'.", tmpPath.string());
+            return false;
+        }
+    }
+
+    fs::rename(tmpPath, cachePath, ec);
+    if (ec)
+    {
+        LOG_WARNING("Failed to replace program cache '{}': {}", cachePath.string(), ec.message());
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+
+    _stats.stores++;
+    return true;
+}
+
+fs::path ProgramCache::CachePath(uint64_t key)
+{
+    return fs::path(PROGRAM_CACHE_DIRECTORY) / std::format("{:016x}.program", key);
+}
+
+const std::string &ProgramCache::Driver()
+{
+    static const std::string driver = []
+    {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        if (formats <= 0)
+        {
+            LOG_WARNING("Driver offers no program binary formats, program cache disabled.");
+            return std::string();
+        }
+
+        const auto text = [](GLenum name)
+        {
+            const auto *value = reinterpret_cast<const char *>(glGetString(name));
+            return value ? std::string(value) : std::string();
+        };
+        return std::format("{}\n{}\n{}", text(GL_VENDOR), text(GL_RENDERER), text(GL_VERSION));
+    }();
+    return driver;
+}
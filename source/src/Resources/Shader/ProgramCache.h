@@ -0,0 +1,76 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       ProgramCache.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      On-disk cache of linked program binaries.
+ *
+ *  This file declares the ProgramCache class, which stores programs fetched
+ *  with glGetProgramBinary in one file per program and restores them with
+ *  glProgramBinary, skipping GLSL compilation and linking. Files are keyed by
+ *  a hash of the preprocessed sources, which already contain the permutation
+ *  defines, and of the GL vendor, renderer and version strings, so an edited
+ *  shader or a driver update simply misses. A binary the driver rejects is
+ *  reported as a miss and the caller compiles from source.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "GL/glew.h"
+#include "ShaderSource.h"
+
+// Features
+#define IMPL_PROGRAM_CACHE
+
+#define PROGRAM_CACHE_DIRECTORY "cache/programs"
+
+/**
+ * @struct ProgramCacheStats
+ * @brief Outcome of all program lookups since start.
+ */
+struct ProgramCacheStats
+{
+    uint32_t hits     = 0;
+    uint32_t misses   = 0;
+    uint32_t rejected = 0; ///< cached binaries the driver refused, counted in misses as well
+    uint32_t stores   = 0;
+};
+
+class ProgramCache
+{
+public:
+    /// Bump whenever the file layout changes.
+    static constexpr uint32_t Version = 1;
+
+    /// Hash of both preprocessed sources and the driver identification, 0 if binaries are unsupported.
+    static uint64_t Key(const ShaderSource &source);
+
+    /**
+     * @brief Create a program from the cached binary of the key.
+     * @return Linked program, or 0 on a miss or when the driver rejects the binary.
+     */
+    static unsigned int Load(uint64_t key);
+    /// Write the binary of a linked program, created with GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+    static bool Store(uint64_t key, unsigned int program);
+
+    [[nodiscard]] static const ProgramCacheStats &Stats() { return _stats; }
+
+private:
+    struct FileHeader
+    {
+        char     magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t format; ///< binary format returned by glGetProgramBinary
+        uint32_t size;
+    };
+
+    static constexpr char Magic[4] = {'P', 'G', 'R', 'P'};
+
+    static std::filesystem::path CachePath(uint64_t key);
+    /// Vendor, renderer and version strings, empty if the driver offers no binary format.
+    static const std::string &Driver();
+
+    inline static ProgramCacheStats _stats;
+};
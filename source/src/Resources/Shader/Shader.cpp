@@ -1,9 +1,21 @@
 #include "Shader.h"
 #include <GL/glew.h>
 #include "ShaderUtils.h"
+#include "ProgramCache.h"
+#include "src/Renderer/GLState.h"
 
 Shader::Shader(const ShaderSource &shaderSource)
 {
+#ifdef IMPL_PROGRAM_CACHE
+    const uint64_t cacheKey = ProgramCache::Key(shaderSource);
+    _id = ProgramCache::Load(cacheKey);
+    if (_id != 0)
+    {
+        _uniforms.Build(_id);
+        return;
+    }
+#endif
+
     unsigned int vertexShader = ShaderUtils::CompileShaderCode(Vertex, shaderSource.GetVertexSource());
     if (vertexShader == 0)
     {
@@ -32,7 +44,17 @@ Shader::Shader(const ShaderSource &shaderSource)
 
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
+
+#ifdef IMPL_PROGRAM_CACHE
+    ProgramCache::Store(cacheKey, _id);
+#endif
+    _uniforms.Build(_id);
 }
+Shader::Shader(unsigned int program) : _id(program)
+{
+    _uniforms.Build(_id);
+}
+
 bool Shader::operator==(const Shader &shader) const
 {
     return _id == shader._id;
@@ -40,79 +62,72 @@ bool Shader::operator==(const Shader &shader) const
 
 Shader::~Shader()
 {
+    GLState::ForgetProgram(_id);
     glDeleteProgram(_id);
 }
 
 Shader &Shader::operator=(Shader &&other) noexcept
 {
     if (this != &other)
+    {
         std::swap(_id, other._id);
+        std::swap(_uniforms, other._uniforms);
+    }
 
     return *this;
 }
 
 void Shader::Bind(const Shader &shader)
 {
-    glUseProgram(shader._id);
+    GLState::UseProgram(shader._id);
 }
 void Shader::Delete(const Shader &shader)
 {
+    GLState::ForgetProgram(shader._id);
     glDeleteProgram(shader._id);
 }
 
 void Shader::SetInt(int location, int value)
 {
-    glUniform1i(location, value);
+    _uniformCalls++;
+    if (GLState::UniformChanged(location, &value, sizeof(value)))
+        glUniform1i(location, value);
 }
 void Shader::SetFloat(int location, float value)
 {
-    glUniform1f(location, value);
+    _uniformCalls++;
+    if (GLState::UniformChanged(location, &value, sizeof(value)))
+        glUniform1f(location, value);
 }
 void Shader::SetVec2(int location, const glm::vec2 &value)
 {
-    glUniform2fv(location, 1, value_ptr(value));
+    _uniformCalls++;
+    if (GLState::UniformChanged(location, value_ptr(value), sizeof(value)))
+        glUniform2fv(location, 1, value_ptr(value));
 }
 void Shader::SetVec3(int location, const glm::vec3 &value)
 {
-    glUniform3fv(location, 1, value_ptr(value));
+    _uniformCalls++;
+    if (GLState::UniformChanged(location, value_ptr(value), sizeof(value)))
+        glUniform3fv(location, 1, value_ptr(value));
 }
 void Shader::SetVec4(int location, const glm::vec4 &value)
 {
-    glUniform4fv(location, 1, value_ptr(value));
+    _uniformCalls++;
+    if (GLState::UniformChanged(location, value_ptr(value), sizeof(value)))
+        glUniform4fv(location, 1, value_ptr(value));
 }
 void Shader::SetMat3(int location, const glm::mat3 &value)
 {
-    glUniformMatrix3fv(location, 1, GL_FALSE, value_ptr(value));
+    _uniformCalls++;
+    if (GLState::UniformChanged(location, value_ptr(value), sizeof(value)))
+        glUniformMatrix3fv(location, 1, GL_FALSE, value_ptr(value));
 }
 void Shader::SetMat4(int location, const glm::mat4 &value)
 {
-    glUniformMatrix4fv(location, 1, GL_FALSE, value_ptr(value));
-}
-
-int Shader::GetAttribLocationSafe(const unsigned int &shaderID, const std::string &name)
-{
-    const int ret = glGetAttribLocation(shaderID, name.c_str());
-    if (ret == -1) { LOG_ERROR("Attribute \"{}\" was not assigned in shader", name); }
-    return ret;
-}
-int Shader::GetAttribLocationSafe(const std::string &name) const
-{
-    const int ret = glGetAttribLocation(_id, name.c_str());
-    if (ret == -1) { LOG_ERROR("Attribute \"{}\" was not assigned in shader", name); }
-    return ret;
-}
-
-int Shader::GetUniformLocationSafe(const unsigned int &shaderID, const std::string &name)
-{
-    const int ret = glGetUniformLocation(shaderID, name.c_str());
-    if (ret == -1) { LOG_ERROR("Uniform \"{}\" was not assigned in shader", name); }
-    return ret;
-}
-int Shader::GetUniformLocationSafe(const std::string &name) const
-{
-    const int ret = glGetUniformLocation(_id, name.c_str());
-    if (ret == -1) { LOG_ERROR("Uniform \"{}\" was not assigned in shader", name); }
-    return ret;
+    _uniformCalls++;
+    if (GLState::UniformChanged(location, value_ptr(value), sizeof(value)))
+        glUniformMatrix4fv(location, 1, GL_FALSE, value_ptr(value));
 }
 
 int Shader::GetUniformLocation(const std::string &name) const
@@ -6,9 +6,11 @@
  * \brief      Encapsulates an OpenGL shader program and uniform setup.
  *
  *  This file declares the Shader class, which wraps creation of a GLSL
- *  program from a ShaderSource, caches attribute and uniform locations
- *  in Utils and UtilsWater structs, and provides static methods to bind
- *  the program and set uniform values of various types.
+ *  program from a ShaderSource, fills the Utils and UtilsWater structs from
+ *  the explicit locations generated into ShaderInterface.h at build time,
+ *  keeps all active uniforms in a UniformTable by interned name, and provides
+ *  static methods to bind the program and set uniform values of various types,
+ *  skipping the GL calls GLState finds redundant.
  *
  */
 //----------------------------------------------------------------------------------------
@@ -16,6 +18,8 @@
 #pragma once
 #include "GL/glew.h"
 #include "ShaderSource.h"
+#include "UniformTable.h"
+#include "ShaderInterface.h"
 
 // Features
 #define IMPL_SHADER
@@ -28,47 +32,23 @@ struct Utils
 {
     // Position
     int aPosition = -1;
-    int ViewPosition = -1;
     int aNormal = -1;
 
-    // Matrices
-    int ModelM = -1;
-    int ViewM = -1;
-    int ProjectionM = -1;
-
     // Textures
     int useCubeMap = -1;
-    int useTexture = -1;
     int diffMap = -1;
     int specMap = -1;
     int aTexCoords = -1;
     int cubeMap = -1;
 
-    // Lights
-    int lightCount = -1;
-
-    // Fog
-    int useFog = -1;
-    int fogColor = -1;
-    int fogStart = -1;
-    int fogEnd = -1;
-
     // Fire
     int useFire = -1;
     int fireMap = -1;
     int frame = -1;
 
     // Alpha
-    int useAlpha = -1;
     int alpha = -1;
 
-    // Light flags
-    int useFlashLight = -1;
-    int useFireLight = -1;
-
-    // Sphere flags
-    int useToSphere = -1;
-    int alphaToSphere = -1;
 };
 
 /**
@@ -78,7 +58,6 @@ struct Utils
 struct UtilsWater
 {
     int WaterTexture = -1;
-    int Time = -1;
     int ScrollSpeed = -1;
 };
 
@@ -87,8 +66,9 @@ struct UtilsWater
  * @brief Encapsulates an OpenGL shader program, including compilation, binding, and uniform management.
  *
  * Shader wraps creation of a GLSL program from vertex and fragment sources,
- * provides safe lookup of attribute and uniform locations, and static helpers
- * to set uniform values. Common locations are cached in the Utils and UtilsWater structs.
+ * resolves the generated explicit locations against the uniforms the program uses,
+ * and provides static helpers to set uniform values. Common locations are cached in the Utils
+ * and UtilsWater structs.
  */
 class Shader
 {
@@ -97,11 +77,16 @@ public:
     UtilsWater _water;
 
 private:
-    unsigned int _id;
+    unsigned int _id = 0;
+    UniformTable _uniforms;
+
+    inline static uint64_t _uniformCalls = 0;
 
 public:
     Shader() = default;
     explicit Shader(const ShaderSource &shaderSource);
+    /// Take ownership of an already linked program, e.g. one ShaderReloader built in the background.
+    explicit Shader(unsigned int program);
     ~Shader();
 
     // Disable moving and copying for simplicity
@@ -125,104 +110,66 @@ public:
     static void SetMat4(int location, const glm::mat4 &value);
 
     // Getters
-    static int GetAttribLocationSafe(const unsigned int &shaderID, const std::string &name);
-    [[nodiscard]] int GetAttribLocationSafe(const std::string &name) const;
-
-    static int GetUniformLocationSafe(const unsigned int &shaderID, const std::string &name);
-    [[nodiscard]] int GetUniformLocationSafe(const std::string &name) const;
-
     [[nodiscard]] int GetUniformLocation(const std::string &name) const;
+    /// Explicit location if the linked program uses the uniform, -1 if it was optimized out, e.g. in a variant
+    [[nodiscard]] int GetActiveLocation(int location) const { return _uniforms.IsActive(location) ? location : -1; }
+    /// Location of an interned uniform from the table built after linking, -1 if unused
+    [[nodiscard]] int GetUniform(UniformId id) const { return _uniforms.Location(id); }
+    [[nodiscard]] const UniformTable &GetUniforms() const { return _uniforms; }
 
     [[nodiscard]] unsigned int &GetID();
+    /// Number of Set* calls since start, camera, time and fog go through FrameUniforms instead
+    [[nodiscard]] static uint64_t UniformCalls() { return _uniformCalls; }
 
     /**
-     * @brief Query and cache standard uniform/attribute locations for a general-purpose shader.
+     * @brief Cache standard uniform/attribute locations for a general-purpose shader.
+     *
+     * Attribute locations are VAO state and always valid, uniforms are -1 when the program does not use them.
      */
     void Load()
     {
-        // Positions
-        _utils.aPosition = GetAttribLocationSafe("aPosition");
-        _utils.ViewPosition = GetUniformLocationSafe("viewPos");
-        _utils.aNormal = GetAttribLocationSafe("aNormal");
+        using Interface = ShaderInterface::Shader;
 
-        // Matrices
-        _utils.ModelM = GetUniformLocationSafe("ModelM");
-        _utils.ViewM = GetUniformLocationSafe("ViewM");
-        _utils.ProjectionM = GetUniformLocationSafe("ProjectionM");
+        // Positions
+        _utils.aPosition = Interface::aPosition;
+        _utils.aNormal = Interface::aNormal;
 
         // Textures
-        _utils.useTexture = GetUniformLocationSafe("material.useTexture");
-        _utils.diffMap = GetUniformLocationSafe("material.diffuseMap");
-        _utils.specMap = GetUniformLocationSafe("material.specularMap");
-        _utils.aTexCoords = GetAttribLocationSafe("aTexCoords");
-
-        _utils.useCubeMap = GetUniformLocationSafe("useCubeMap");
-        _utils.cubeMap = GetUniformLocationSafe("cubeMap");
+        _utils.diffMap = GetActiveLocation(Interface::material::diffuseMap);
+        _utils.specMap = GetActiveLocation(Interface::material::specularMap);
+        _utils.aTexCoords = Interface::aTexCoords;
 
-        // Lights
-        _utils.lightCount = GetUniformLocationSafe("lightCount");
-
-        // Fog
-        _utils.useFog = GetUniformLocationSafe("useFog");
-        _utils.fogColor = GetUniformLocationSafe("fogColor");
-        _utils.fogStart = GetUniformLocationSafe("fogStart");
-        _utils.fogEnd = GetUniformLocationSafe("fogEnd");
+        _utils.useCubeMap = GetActiveLocation(Interface::useCubeMap);
+        _utils.cubeMap = GetActiveLocation(Interface::cubeMap);
 
         // Fire
-        _utils.useFire = GetUniformLocationSafe("useFire");
-        _utils.fireMap = GetUniformLocationSafe("fireMap");
-        _utils.frame = GetUniformLocationSafe("frame");
-
-        // Alpha
-        _utils.useAlpha = GetUniformLocationSafe("useAlpha");
-        _utils.alpha = GetUniformLocationSafe("alpha");
-
-        // FlashLight
-        _utils.useFlashLight = GetUniformLocationSafe("useFlashLight");
-        _utils.useFireLight = GetUniformLocationSafe("useFireLight");
-
-        // Sphere
-        _utils.useToSphere = GetUniformLocationSafe("useToSphere");
-        _utils.alphaToSphere = GetUniformLocationSafe("alphaToSphere");
+        _utils.useFire = GetActiveLocation(Interface::useFire);
+        _utils.fireMap = GetActiveLocation(Interface::fireMap);
+        _utils.frame = GetActiveLocation(Interface::frame);
     }
     /**
-     * @brief Query and cache uniform/attribute locations for the water shader variant.
+     * @brief Cache uniform/attribute locations for the water shader.
      */
     void LoadWater()
     {
-        // Positions
-        _utils.aPosition = GetAttribLocationSafe("aPosition");
-        _utils.ViewPosition = GetUniformLocationSafe("viewPos");
-        _utils.aTexCoords = GetAttribLocationSafe("aTexCoords");
+        using Interface = ShaderInterface::Water;
 
-        // Matrices
-        _utils.ModelM = GetUniformLocationSafe("ModelM");
-        _utils.ViewM = GetUniformLocationSafe("ViewM");
-        _utils.ProjectionM = GetUniformLocationSafe("ProjectionM");
+        // Positions
+        _utils.aPosition = Interface::aPosition;
+        _utils.aTexCoords = Interface::aTexCoords;
 
         // Textures
-        _water.WaterTexture = GetUniformLocationSafe("WaterTexture");
-        _water.Time = GetUniformLocationSafe("Time");
-        _water.ScrollSpeed = GetUniformLocationSafe("ScrollSpeed");
-        _utils.alpha = GetUniformLocationSafe("Alpha");
-
-        // Fog
-        _utils.useFog = GetUniformLocationSafe("useFog");
-        _utils.fogColor = GetUniformLocationSafe("fogColor");
-        _utils.fogStart = GetUniformLocationSafe("fogStart");
-        _utils.fogEnd = GetUniformLocationSafe("fogEnd");
+        _water.WaterTexture = GetActiveLocation(Interface::WaterTexture);
+        _water.ScrollSpeed = GetActiveLocation(Interface::ScrollSpeed);
+        _utils.alpha = GetActiveLocation(Interface::Alpha);
     }
     /**
-     * @brief Query and cache uniform/attribute locations for a simple (white) shader.
+     * @brief Cache attribute locations for a simple (white) shader.
      */
     void LoadWhite()
     {
         // Positions
-        _utils.aPosition = GetAttribLocationSafe("aPosition");
-        // Matrices
-        _utils.ModelM = GetUniformLocationSafe("ModelM");
-        _utils.ViewM = GetUniformLocationSafe("ViewM");
-        _utils.ProjectionM = GetUniformLocationSafe("ProjectionM");
+        _utils.aPosition = ShaderInterface::White::aPosition;
     }
 
     /**
@@ -230,7 +177,7 @@ public:
      */
     void LinkTextures() const
     {
-        glUseProgram(_id);
+        Shader::Bind(*this);
         Shader::SetInt(_utils.cubeMap, 0);
         Shader::SetInt(_utils.diffMap, 1);
         Shader::SetInt(_utils.specMap, 2);
@@ -241,7 +188,7 @@ public:
      */
     void LinkTexturesWater() const
     {
-        glUseProgram(_id);
+        Shader::Bind(*this);
         Shader::SetInt(_water.WaterTexture, 0);
     }
 };
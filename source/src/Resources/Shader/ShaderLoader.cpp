@@ -1,7 +1,8 @@
 #include "ShaderLoader.h"
 
 ShaderSource ShaderLoader::LoadShaderSeparate(const std::filesystem::path &vertexPath,
-                                              const std::filesystem::path &fragmentPath)
+                                              const std::filesystem::path &fragmentPath,
+                                              const std::string &defines)
 {
     std::ifstream vertexFile(ABSOLUTE_RESOURCE_PATH(vertexPath).string());
     if (!vertexFile)
@@ -21,10 +22,14 @@ ShaderSource ShaderLoader::LoadShaderSeparate(const std::filesystem::path &verte
     std::stringstream fragmentStream;
     fragmentStream << fragmentFile.rdbuf();
 
-    return {ProcessShaderSource(vertexStream, Vertex), ProcessShaderSource(fragmentStream, Fragment)};
+    std::set<std::string> files = {vertexPath.filename().string(), fragmentPath.filename().string()};
+    std::string vertexSource = ProcessShaderSource(vertexStream, Vertex, defines, files);
+    std::string fragmentSource = ProcessShaderSource(fragmentStream, Fragment, defines, files);
+    return {std::move(vertexSource), std::move(fragmentSource), std::move(files)};
 }
 
-std::string ShaderLoader::ProcessShaderSource(std::stringstream &sourceStream, ShaderSourceType type)
+std::string ShaderLoader::ProcessShaderSource(std::stringstream &sourceStream, ShaderSourceType type, const std::string &defines,
+                                              std::set<std::string> &files)
 {
     std::stringstream shaderOut;
 
@@ -32,7 +37,7 @@ std::string ShaderLoader::ProcessShaderSource(std::stringstream &sourceStream, S
     // Example: Add version automatically if it isn't present to avoid typing it manually in every shader.
 
     // Resolve includes
-    shaderOut << GenerateIncludes(sourceStream);
+    shaderOut << GenerateIncludes(sourceStream, defines, files);
 
     // Shader parsing
     if (type == Vertex)
@@ -48,9 +53,10 @@ std::string ShaderLoader::ProcessShaderSource(std::stringstream &sourceStream, S
     return shaderOut.str();
 }
 
-std::string ShaderLoader::GenerateIncludes(std::stringstream &shaderSource)
+std::string ShaderLoader::GenerateIncludes(std::stringstream &shaderSource, const std::string &defines, std::set<std::string> &files)
 {
     std::stringstream sourceOut;
+    bool definesWritten = false;
     std::set<std::string> alreadyIncluded;
     std::stack<std::unique_ptr<std::ifstream>> includeFiles;
 
@@ -69,12 +75,19 @@ std::string ShaderLoader::GenerateIncludes(std::stringstream &shaderSource)
         if (line.starts_with("//"))
             continue;
 
-        if (line.starts_with("#version"))
+        if (line.starts_with("#version") || line.starts_with("#extension"))
         {
             sourceOut << line << std::endl;
             continue;
         }
 
+        // Permutation defines, visible to the includes and the rest of the file
+        if (!definesWritten)
+        {
+            sourceOut << defines;
+            definesWritten = true;
+        }
+
         if (line.starts_with("#include")) // New include file found
         {
             auto valueStart = line.find_first_not_of(' ', sizeof("#include") - 1) + 1;
@@ -84,8 +97,15 @@ std::string ShaderLoader::GenerateIncludes(std::stringstream &shaderSource)
             if (alreadyIncluded.contains(includedPath))
                 continue;
 
-            includeFiles.push(std::make_unique<std::ifstream>(std::filesystem::path(INCLUDE_DIRECTORY) / includedPath));
+            auto includeFile = std::make_unique<std::ifstream>(ABSOLUTE_RESOURCE_PATH(std::filesystem::path(INCLUDE_DIRECTORY) / includedPath));
+            if (!includeFile->is_open())
+            {
+                LOG_ERROR("Failed to open shader include '{}'.", includedPath);
+                continue;
+            }
+            includeFiles.push(std::move(includeFile));
             alreadyIncluded.insert(includedPath);
+            files.insert(includedPath);
         }
         else // End of #include directives, append rest of file
         {
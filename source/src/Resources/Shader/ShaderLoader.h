@@ -14,7 +14,7 @@
 
 #pragma once
 #include "ShaderSource.h"
-#define INCLUDE_DIRECTORY "res/Shaders"
+#define INCLUDE_DIRECTORY "Shaders"
 
 
 class ShaderLoader
@@ -23,9 +23,11 @@ public:
     /// Load and process separate shader files into a ShaderSource.
     /// @param vertexPath Path to vertex shader file
     /// @param fragmentPath Path to fragment shader file
-    /// @return ShaderSource with processed source code
+    /// @param defines #define lines of a permutation, inserted after the #version and #extension directives
+    /// @return ShaderSource with processed source code and the names of the files it was read from
     static ShaderSource LoadShaderSeparate(const std::filesystem::path &vertexPath,
-                                           const std::filesystem::path &fragmentPath);
+                                           const std::filesystem::path &fragmentPath,
+                                           const std::string &defines = {});
 
 private:
     enum ShaderSourceType
@@ -41,13 +43,18 @@ private:
     /// 3. functions
     /// 4. shader specific code (attributes, output, main, ...)
     /// @param type Type of the shader source
+    /// @param defines Permutation defines, see LoadShaderSeparate()
+    /// @param[out] files Receives the names of all included files
     /// @return ShaderSource for creating a Shader
-    static std::string ProcessShaderSource(std::stringstream &sourceStream, ShaderSourceType type);
+    static std::string ProcessShaderSource(std::stringstream &sourceStream, ShaderSourceType type, const std::string &defines,
+                                           std::set<std::string> &files);
 
     /// Parse <code>#include</code> directives recrusively to generate a string with their source code,
     /// intended to replace the directives in order to make source file compilable.
     /// @param[in,out] shaderSource Shader source with include directives, will modify reading head to be after last
     /// include directive
+    /// @param defines Written once after the leading #version and #extension directives, before any include
+    /// @param[out] files Receives the name of every file included, relative to INCLUDE_DIRECTORY
     /// @return Source code of included files in required order
-    static std::string GenerateIncludes(std::stringstream &shaderSource);
+    static std::string GenerateIncludes(std::stringstream &shaderSource, const std::string &defines, std::set<std::string> &files);
 };
@@ -0,0 +1,363 @@
+#include "ShaderReloader.h"
+#include "ShaderLoader.h"
+#include "ShaderUtils.h"
+#include "ProgramCache.h"
+
+#include <GLFW/glfw3.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+void ShaderReloader::Create(GLFWwindow *window)
+{
+    // Compile path
+    if (GLEW_KHR_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        _parallel = true;
+    }
+    else if (GLEW_ARB_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        _parallel = true;
+    }
+    else
+    {
+        // hidden window only to own a context sharing programs with the render one
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        _context = glfwCreateWindow(1, 1, "Shader compiler", nullptr, window);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+        if (_context)
+            _worker = std::thread(&ShaderReloader::WorkerLoop, this);
+        else
+            LOG_WARNING("Failed to create a shader compiler context, reloads will block the render thread.");
+    }
+    LOG("Shader reloads use {}.", _parallel ? "parallel shader compile" : _context ? "a worker context" : "the render thread");
+
+    // File watch
+#ifdef __linux__
+    const std::string directory = ABSOLUTE_RESOURCE_PATH(INCLUDE_DIRECTORY).string();
+    _watch = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_watch == -1 || inotify_add_watch(_watch, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) == -1)
+    {
+        LOG_WARNING("Failed to watch '{}', shaders reload only on request.", directory);
+        if (_watch != -1)
+            close(_watch);
+        _watch = -1;
+    }
+#else
+    LOG("Shader file watching is only available on Linux, shaders reload only on request.");
+#endif
+}
+
+void ShaderReloader::Destroy()
+{
+    if (_worker.joinable())
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _condition.notify_all();
+        _worker.join();
+    }
+    if (_context)
+    {
+        glfwDestroyWindow(_context);
+        _context = nullptr;
+    }
+
+    for (auto &build : _builds)
+    {
+        DeleteObjects(*build);
+        if (build->id)
+            glDeleteProgram(build->id);
+    }
+    _builds.clear();
+    _jobs.clear();
+    _programs.clear();
+
+#ifdef __linux__
+    if (_watch != -1)
+        close(_watch);
+    _watch = -1;
+#endif
+}
+
+void ShaderReloader::Watch(Shader &shader, std::string name, std::filesystem::path vertexPath, std::filesystem::path fragmentPath,
+                           Setup setup, std::string defines)
+{
+    auto program = std::make_unique<Program>();
+    program->shader       = &shader;
+    program->name         = std::move(name);
+    program->vertexPath   = std::move(vertexPath);
+    program->fragmentPath = std::move(fragmentPath);
+    program->defines      = std::move(defines);
+    program->setup        = std::move(setup);
+    program->files        = ShaderLoader::LoadShaderSeparate(program->vertexPath, program->fragmentPath, program->defines).GetFiles();
+    _programs.push_back(std::move(program));
+}
+
+void ShaderReloader::Forget(const Shader &shader)
+{
+    for (auto &build : _builds)
+        if (build->program && build->program->shader == &shader)
+            build->program = nullptr;
+
+    std::erase_if(_programs, [&shader](const std::unique_ptr<Program> &program) { return program->shader == &shader; });
+}
+
+void ShaderReloader::RebuildAll(bool fromSource)
+{
+    for (auto &program : _programs)
+        Rebuild(*program, fromSource);
+}
+
+void ShaderReloader::Update()
+{
+    // Frame time of the last frame, while a reload runs
+    if (_reload.active)
+    {
+        _reload.worstFrameMs = std::max(_reload.worstFrameMs, _frameStopwatch.ElapsedMs());
+        _reload.frames++;
+    }
+    _frameStopwatch.Restart();
+
+    ReadChanges();
+
+    // Swap in finished programs, in start order
+    for (size_t i = 0; i < _builds.size();)
+    {
+        if (!IsDone(*_builds[i]))
+        {
+            ++i;
+            continue;
+        }
+
+        const std::shared_ptr<Build> build = _builds[i];
+        _builds.erase(_builds.begin() + static_cast<std::ptrdiff_t>(i));
+        Finish(*build);
+    }
+
+    if (_reload.active && _builds.empty())
+    {
+        LOG("Shader reload: {} programs ({} failed) in {:.1f} ms over {} frames, worst frame {:.1f} ms ({} the {:.1f} ms budget), "
+            "render thread busy {:.1f} ms.",
+            _reload.programs, _reload.failed, _reload.stopwatch.ElapsedMs(), _reload.frames, _reload.worstFrameMs,
+            _reload.worstFrameMs <= FrameBudgetMs ? "within" : "over", FrameBudgetMs, _reload.renderMs);
+        _reload = {};
+    }
+}
+
+void ShaderReloader::Rebuild(Program &program, bool fromSource)
+{
+    // one build per program at a time, the newest sources are read when it finishes
+    if (program.building)
+    {
+        program.dirty = true;
+        return;
+    }
+    Start(program, fromSource);
+}
+
+void ShaderReloader::Start(Program &program, bool fromSource)
+{
+    if (!_reload.active)
+    {
+        _reload.active = true;
+        _reload.stopwatch.Restart();
+    }
+    Stopwatch stopwatch;
+
+    const ShaderSource source = ShaderLoader::LoadShaderSeparate(program.vertexPath, program.fragmentPath, program.defines);
+    program.files    = source.GetFiles();
+    program.building = true;
+
+    auto build = std::make_shared<Build>();
+    build->program        = &program;
+    build->vertexSource   = source.GetVertexSource();
+    build->fragmentSource = source.GetFragmentSource();
+
+#ifdef IMPL_PROGRAM_CACHE
+    build->cacheKey = ProgramCache::Key(source);
+    if (!fromSource)
+        build->id = ProgramCache::Load(build->cacheKey);
+    build->cached = build->id != 0;
+#endif
+
+    if (build->cached)
+        build->done = true;
+    else if (_parallel || !_context)
+        Compile(*build); // parallel: returns right away and IsDone() polls, no worker: blocks at the first status query
+    else
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _jobs.push_back(build);
+        }
+        _condition.notify_one();
+    }
+
+    _builds.push_back(std::move(build));
+    _reload.programs++;
+    _reload.renderMs += stopwatch.ElapsedMs();
+}
+
+void ShaderReloader::Finish(Build &build)
+{
+    Stopwatch stopwatch;
+    Program *program = build.program;
+
+    bool linked = build.cached;
+    if (!build.cached)
+    {
+        linked = ShaderUtils::CheckShaderCompilation(build.vertex) && ShaderUtils::CheckShaderCompilation(build.fragment) &&
+                 ShaderUtils::CheckShaderLinking(build.id);
+        DeleteObjects(build);
+    }
+
+    if (!linked || !program)
+    {
+        if (build.id)
+            glDeleteProgram(build.id);
+        if (program)
+        {
+            LOG_ERROR("Shader '{}' failed to build, keeping the previous program.", program->name);
+            _reload.failed++;
+        }
+    }
+    else
+    {
+#ifdef IMPL_PROGRAM_CACHE
+        if (!build.cached)
+            ProgramCache::Store(build.cacheKey, build.id);
+#endif
+        // the old program is released by the temporary
+        *program->shader = Shader(build.id);
+        program->setup(*program->shader);
+        LOG("Shader '{}' rebuilt in {:.1f} ms{}.", program->name, build.stopwatch.ElapsedMs(), build.cached ? " from program cache" : "");
+    }
+
+    if (program)
+    {
+        program->building = false;
+        if (program->dirty)
+        {
+            program->dirty = false;
+            Start(*program, false);
+        }
+    }
+    _reload.renderMs += stopwatch.ElapsedMs();
+}
+
+bool ShaderReloader::IsDone(const Build &build) const
+{
+    if (build.done)
+        return true;
+    if (!_parallel)
+        return !_context;
+
+    GLint complete = GL_FALSE;
+    glGetProgramiv(build.id, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+void ShaderReloader::Compile(Build &build)
+{
+    const char *vertexSource = build.vertexSource.c_str();
+    build.vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(build.vertex, 1, &vertexSource, nullptr);
+    glCompileShader(build.vertex);
+
+    const char *fragmentSource = build.fragmentSource.c_str();
+    build.fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(build.fragment, 1, &fragmentSource, nullptr);
+    glCompileShader(build.fragment);
+
+    build.id = glCreateProgram();
+    glAttachShader(build.id, build.vertex);
+    glAttachShader(build.id, build.fragment);
+    glProgramParameteri(build.id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(build.id);
+}
+
+void ShaderReloader::DeleteObjects(Build &build)
+{
+    if (build.id && build.vertex)
+        glDetachShader(build.id, build.vertex);
+    if (build.id && build.fragment)
+        glDetachShader(build.id, build.fragment);
+    if (build.vertex)
+        glDeleteShader(build.vertex);
+    if (build.fragment)
+        glDeleteShader(build.fragment);
+    build.vertex = build.fragment = 0;
+}
+
+void ShaderReloader::ReadChanges()
+{
+#ifdef __linux__
+    if (_watch == -1)
+        return;
+
+    // an editor saving once may report several events, collect them all first
+    std::set<std::string> changed;
+    alignas(inotify_event) char buffer[4096];
+    for (;;)
+    {
+        const ssize_t length = read(_watch, buffer, sizeof(buffer));
+        if (length <= 0)
+            break;
+
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+            if (event->len > 0)
+                changed.insert(event->name);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+
+    for (const std::string &file : changed)
+    {
+        size_t affected = 0;
+        for (auto &program : _programs)
+        {
+            if (!program->files.contains(file))
+                continue;
+            Rebuild(*program, false);
+            affected++;
+        }
+        if (affected)
+            LOG("Shader file '{}' changed, rebuilding {} programs.", file, affected);
+    }
+#endif
+}
+
+void ShaderReloader::WorkerLoop()
+{
+    glfwMakeContextCurrent(_context);
+
+    for (;;)
+    {
+        std::shared_ptr<Build> build;
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait(lock, [this] { return _stopping || !_jobs.empty(); });
+            if (_stopping)
+                break;
+            build = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        Compile(*build);
+        // the render context may only use the objects once the commands have completed
+        glFinish();
+        build->done = true;
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
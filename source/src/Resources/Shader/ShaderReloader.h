@@ -0,0 +1,144 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       ShaderReloader.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Background rebuilds of shader programs and hot reload on file changes.
+ *
+ *  This file declares the ShaderReloader class. Registered shaders are
+ *  rebuilt without stalling the render thread: with KHR_parallel_shader_compile
+ *  the driver compiles while frames go on and the program is polled for
+ *  completion, without it a worker thread compiles on a hidden context that
+ *  shares objects with the main one. A shader keeps its current program until
+ *  the new one has linked, then the two are swapped between frames; a failed
+ *  build only logs its errors. On Linux an inotify watch on res/Shaders starts
+ *  the rebuild of every program that reads a changed file, includes too.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "Shader.h"
+#include "src/Utils/Stopwatch.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Features
+#define IMPL_SHADER_HOT_RELOAD
+
+struct GLFWwindow;
+
+class ShaderReloader
+{
+public:
+    /// Called on the render thread once a new program is in place, e.g. to cache locations and link samplers.
+    using Setup = std::function<void(Shader &)>;
+
+    /// Frame time a reload must stay within, 60 Hz
+    static constexpr double FrameBudgetMs = 1000.0 / 60.0;
+
+    /**
+     * @brief Pick the compile path and start watching the shader directory.
+     * @param window Window of the render context, shared with the worker context if one is needed.
+     */
+    void Create(GLFWwindow *window);
+    void Destroy();
+
+    /**
+     * @brief Register a shader whose program is rebuilt from the given files, nothing is built now.
+     * @param name    Shown in the logs.
+     * @param defines Permutation defines, see ShaderLoader::LoadShaderSeparate().
+     */
+    void Watch(Shader &shader, std::string name, std::filesystem::path vertexPath, std::filesystem::path fragmentPath, Setup setup,
+               std::string defines = {});
+    /// Stop rebuilding a shader, a build in flight is discarded.
+    void Forget(const Shader &shader);
+
+    /**
+     * @brief Rebuild every registered program in the background.
+     * @param fromSource Skip the program cache, so the GLSL really is compiled again.
+     */
+    void RebuildAll(bool fromSource = false);
+
+    /// Once per frame on the render thread: start builds for changed files and swap in finished programs.
+    void Update();
+
+    [[nodiscard]] size_t Pending() const { return _builds.size(); }
+    [[nodiscard]] bool Parallel() const { return _parallel; }
+
+private:
+    struct Program
+    {
+        Shader               *shader;
+        std::string           name;
+        std::filesystem::path vertexPath;
+        std::filesystem::path fragmentPath;
+        std::string           defines;
+        Setup                 setup;
+        std::set<std::string> files;            ///< names under res/Shaders, filled by the first build
+        bool                  building = false;
+        bool                  dirty    = false; ///< changed again while building
+    };
+
+    struct Build
+    {
+        Program          *program = nullptr; ///< nullptr once forgotten
+        std::string       vertexSource;
+        std::string       fragmentSource;
+        uint64_t          cacheKey = 0;
+        bool              cached   = false;
+        GLuint            vertex   = 0;
+        GLuint            fragment = 0;
+        GLuint            id       = 0;
+        std::atomic<bool> done     = false;
+        Stopwatch         stopwatch;
+    };
+
+    /// Statistics of one reload, from the first started build until none is pending.
+    struct Reload
+    {
+        bool      active       = false;
+        Stopwatch stopwatch;
+        double    worstFrameMs = 0.0;
+        double    renderMs     = 0.0; ///< spent by the render thread in Start() and Finish()
+        uint32_t  frames       = 0;
+        uint32_t  programs     = 0;
+        uint32_t  failed       = 0;
+    };
+
+    void Rebuild(Program &program, bool fromSource);
+    /// Preprocess the sources and issue the build, either to the driver, the cache or the worker.
+    void Start(Program &program, bool fromSource);
+    /// Check the finished build and swap it into its shader if it linked.
+    void Finish(Build &build);
+    [[nodiscard]] bool IsDone(const Build &build) const;
+
+    /// Create, compile and link without querying any status, so the driver may keep working in the background.
+    static void Compile(Build &build);
+    static void DeleteObjects(Build &build);
+
+    void ReadChanges();
+    void WorkerLoop();
+
+    std::vector<std::unique_ptr<Program>> _programs;
+    std::vector<std::shared_ptr<Build>>   _builds;
+    bool _parallel = false;
+
+    // Worker with a shared context, when the driver has no parallel compile
+    GLFWwindow *_context = nullptr;
+    std::thread _worker;
+    std::deque<std::shared_ptr<Build>> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping = false;
+
+    int _watch = -1; ///< inotify descriptor
+
+    Reload    _reload;
+    Stopwatch _frameStopwatch;
+};
@@ -1,7 +1,7 @@
 #include "ShaderSource.h"
 
-ShaderSource::ShaderSource(std::string vertexSource, std::string fragmentSource) :
-    _vertexSource(std::move(vertexSource)), _fragmentSource(std::move(fragmentSource))
+ShaderSource::ShaderSource(std::string vertexSource, std::string fragmentSource, std::set<std::string> files) :
+    _vertexSource(std::move(vertexSource)), _fragmentSource(std::move(fragmentSource)), _files(std::move(files))
 {}
 
 const std::string &ShaderSource::GetVertexSource() const
@@ -13,3 +13,8 @@ const std::string &ShaderSource::GetFragmentSource() const
 {
     return _fragmentSource;
 }
+
+const std::set<std::string> &ShaderSource::GetFiles() const
+{
+    return _files;
+}
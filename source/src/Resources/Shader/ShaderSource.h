@@ -19,12 +19,15 @@
 class ShaderSource
 {
 public:
-    ShaderSource(std::string vertexSource, std::string fragmentSource);
+    /// @param files Names of the files under res/Shaders the sources were read from, includes too
+    ShaderSource(std::string vertexSource, std::string fragmentSource, std::set<std::string> files = {});
 
     const std::string &GetVertexSource() const;
     const std::string &GetFragmentSource() const;
+    const std::set<std::string> &GetFiles() const;
 
 private:
     std::string _vertexSource;
     std::string _fragmentSource;
+    std::set<std::string> _files;
 };
@@ -45,6 +45,8 @@ public:
         auto id = glCreateProgram();
         glAttachShader(id, vertexShader);
         glAttachShader(id, fragmentShader);
+        // lets ProgramCache fetch the binary after linking
+        glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
         glLinkProgram(id);
 
         if (!CheckShaderLinking(id))
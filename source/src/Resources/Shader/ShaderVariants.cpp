@@ -0,0 +1,90 @@
+#include "ShaderVariants.h"
+#include "ShaderLoader.h"
+#include "src/Utils/Stopwatch.h"
+
+namespace
+{
+    struct FeatureDefine
+    {
+        ShaderVariants::Feature feature;
+        const char *define;
+        const char *name;
+    };
+
+    constexpr FeatureDefine FeatureDefines[] = {
+        {ShaderVariants::Skybox,     "VARIANT_SKYBOX",   "skybox"},
+        {ShaderVariants::FireSprite, "VARIANT_FIRE",     "fire"},
+        {ShaderVariants::Textured,   "VARIANT_TEXTURED", "textured"},
+        {ShaderVariants::Fog,        "VARIANT_FOG",      "fog"},
+    };
+}
+
+ShaderVariants::ShaderVariants(std::filesystem::path vertexPath, std::filesystem::path fragmentPath)
+    : _vertexPath(std::move(vertexPath)), _fragmentPath(std::move(fragmentPath))
+{}
+
+Shader &ShaderVariants::Get(Key key)
+{
+    auto &variant = _variants[key];
+    if (!variant)
+    {
+        variant = std::make_unique<Shader>();
+        Compile(key, *variant);
+
+        if (_reloader)
+        {
+            _reloader->Watch(*variant, "variant " + Name(key), _vertexPath, _fragmentPath, [](Shader &shader)
+            {
+                shader.Load();
+                shader.LinkTextures();
+            }, Defines(key));
+        }
+    }
+    return *variant;
+}
+
+void ShaderVariants::Reload()
+{
+    for (auto &[key, variant] : _variants)
+        Compile(key, *variant);
+}
+
+void ShaderVariants::Clear()
+{
+    if (_reloader)
+        for (const auto &[key, variant] : _variants)
+            _reloader->Forget(*variant);
+    _variants.clear();
+}
+
+std::string ShaderVariants::Defines(Key key)
+{
+    std::string defines = "#define VARIANT\n";
+    for (const auto &[feature, define, name] : FeatureDefines)
+        defines += std::format("#define {} {}\n", define, key & feature ? 1 : 0);
+    return defines;
+}
+
+std::string ShaderVariants::Name(Key key)
+{
+    std::string result;
+    for (const auto &[feature, define, name] : FeatureDefines)
+    {
+        if (!(key & feature))
+            continue;
+        if (!result.empty())
+            result += '+';
+        result += name;
+    }
+    return result.empty() ? "lit" : result;
+}
+
+void ShaderVariants::Compile(Key key, Shader &shader) const
+{
+    Stopwatch stopwatch;
+    const ShaderSource source = ShaderLoader::LoadShaderSeparate(_vertexPath, _fragmentPath, Defines(key));
+    shader = Shader(source);
+    shader.Load();
+    shader.LinkTextures();
+    LOG("Shader variant {} compiled in {:.1f} ms, {} active uniforms.", Name(key), stopwatch.ElapsedMs(), shader.GetUniforms().ActiveCount());
+}
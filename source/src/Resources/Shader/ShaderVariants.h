@@ -0,0 +1,71 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       ShaderVariants.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      On demand compiled permutations of one shader.
+ *
+ *  This file declares the ShaderVariants class. A variant is the shader
+ *  compiled with a set of features switched on or off by #define lines
+ *  (see res/Shaders/Permutation.glsl), so every branch on those features is
+ *  a constant and the paths a draw does not take are removed by the GLSL
+ *  compiler. Variants are compiled the first time a key is requested and
+ *  kept until Clear(); Reload() and the ShaderReloader rebuild them in place
+ *  so references held by the renderer stay valid.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "ShaderReloader.h"
+
+// Features
+#define IMPL_SHADER_PERMUTATIONS
+
+class ShaderVariants
+{
+public:
+    /**
+     * @enum Feature
+     * @brief Bits of a permutation key, one VARIANT_* define each.
+     */
+    enum Feature : uint32_t
+    {
+        None       = 0,      ///< lit with material colors
+        Skybox     = 1 << 0, ///< cube map sampled by direction, no lighting
+        FireSprite = 1 << 1, ///< animated sprite sheet, no lighting
+        Textured   = 1 << 2, ///< diffuse and specular maps instead of material colors
+        Fog        = 1 << 3,
+    };
+    using Key = uint32_t;
+
+    ShaderVariants(std::filesystem::path vertexPath, std::filesystem::path fragmentPath);
+
+    ShaderVariants(const ShaderVariants &) = delete;
+    ShaderVariants &operator=(const ShaderVariants &) = delete;
+
+    /// Variant with the given features, compiled on first use.
+    Shader &Get(Key key);
+    /// Recompile all compiled variants from source.
+    void Reload();
+    void Clear();
+
+    /// Register every variant compiled from now on with the reloader, nullptr to stop.
+    void SetReloader(ShaderReloader *reloader) { _reloader = reloader; }
+
+    /// #define lines selecting the features of a key.
+    [[nodiscard]] static std::string Defines(Key key);
+    /// Readable feature list of a key, e.g. "textured+fog".
+    [[nodiscard]] static std::string Name(Key key);
+
+    [[nodiscard]] size_t Count() const { return _variants.size(); }
+
+private:
+    /// Build the program of a variant into shader, replacing its previous program.
+    void Compile(Key key, Shader &shader) const;
+
+    std::filesystem::path _vertexPath;
+    std::filesystem::path _fragmentPath;
+    std::map<Key, std::unique_ptr<Shader>> _variants;
+    ShaderReloader *_reloader = nullptr;
+};
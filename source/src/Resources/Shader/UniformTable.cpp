@@ -0,0 +1,83 @@
+#include "UniformTable.h"
+
+std::deque<std::string> &UniformNames::Names()
+{
+    // a deque never moves its elements, so the views used as keys stay valid
+    static std::deque<std::string> names;
+    return names;
+}
+
+std::unordered_map<std::string_view, UniformId> &UniformNames::Ids()
+{
+    static std::unordered_map<std::string_view, UniformId> ids;
+    return ids;
+}
+
+UniformId UniformNames::Intern(std::string_view name)
+{
+    static std::mutex mutex;
+    const std::lock_guard lock(mutex);
+
+    auto &ids = Ids();
+    if (const auto it = ids.find(name); it != ids.end())
+        return it->second;
+
+    auto &names = Names();
+    const UniformId id = static_cast<UniformId>(names.size());
+    names.emplace_back(name);
+    ids.emplace(names.back(), id);
+    return id;
+}
+
+void UniformTable::Build(unsigned int program)
+{
+    _locations.clear();
+    _active.clear();
+    _activeCount = 0;
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::string name(std::max(maxLength, 1), '\0');
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei length = 0;
+        GLint   size   = 0;
+        GLenum  type   = 0;
+        glGetActiveUniform(program, static_cast<GLuint>(i), maxLength, &length, &size, &type, name.data());
+        const std::string_view active(name.data(), length);
+
+        const int location = glGetUniformLocation(program, name.c_str());
+        if (location == -1)
+            continue;
+
+        _activeCount++;
+        Set(active, location);
+
+        // elements of arrays of basic types, reported once as "name[0]"
+        if (size > 1 && active.ends_with("[0]"))
+        {
+            const std::string_view base = active.substr(0, active.size() - 3);
+            Set(base, location);
+            for (GLint element = 1; element < size; ++element)
+            {
+                const std::string elementName = std::format("{}[{}]", base, element);
+                Set(elementName, glGetUniformLocation(program, elementName.c_str()));
+            }
+        }
+    }
+}
+
+void UniformTable::Set(std::string_view name, int location)
+{
+    if (location >= static_cast<int>(_active.size()))
+        _active.resize(location + 1, false);
+    if (location >= 0)
+        _active[location] = true;
+
+    const UniformId id = UniformNames::Intern(name);
+    if (id >= _locations.size())
+        _locations.resize(id + 1, -1);
+    _locations[id] = location;
+}
@@ -0,0 +1,65 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       UniformTable.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Interned uniform names and per-program location tables.
+ *
+ *  This file declares UniformNames, which maps every uniform name used by the
+ *  application to a small integer id once, and UniformTable, which a Shader
+ *  fills right after linking from glGetActiveUniform introspection. Uploads
+ *  then resolve a location by indexing the table with the id, so the per
+ *  frame paths neither build strings nor ask the driver for locations.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include <GL/glew.h>
+
+#include <deque>
+#include <mutex>
+
+using UniformId = uint32_t;
+
+class UniformNames
+{
+public:
+    static constexpr UniformId Invalid = UINT32_MAX;
+
+    /// Id of the name, registered on first use; not meant for per frame code. Thread safe, materials intern on the import workers.
+    static UniformId Intern(std::string_view name);
+    [[nodiscard]] static const std::string &Name(UniformId id) { return Names()[id]; }
+    [[nodiscard]] static UniformId Count() { return static_cast<UniformId>(Names().size()); }
+
+private:
+    static std::deque<std::string> &Names();
+    static std::unordered_map<std::string_view, UniformId> &Ids();
+};
+
+class UniformTable
+{
+public:
+    /**
+     * @brief Intern all active uniforms of a linked program and store their locations.
+     *
+     * Arrays of basic types register every element ("a[0]", "a[1]", ...) and the bare name for
+     * element 0, arrays of structs are already reported per member by the driver. Uniforms inside
+     * blocks have no location and are skipped.
+     */
+    void Build(unsigned int program);
+    void Clear() { _locations.clear(); _active.clear(); }
+
+    /// Location of the uniform, -1 if the program does not use it
+    [[nodiscard]] int Location(UniformId id) const { return id < _locations.size() ? _locations[id] : -1; }
+    /// Whether an explicit location belongs to a uniform the linker kept
+    [[nodiscard]] bool IsActive(int location) const { return location >= 0 && location < static_cast<int>(_active.size()) && _active[location]; }
+    [[nodiscard]] size_t ActiveCount() const { return _activeCount; }
+
+private:
+    void Set(std::string_view name, int location);
+
+    std::vector<int>  _locations; ///< indexed by UniformId
+    std::vector<bool> _active;    ///< indexed by location
+    size_t _activeCount = 0;
+};
@@ -0,0 +1,223 @@
+#include "AabbTree.h"
+
+int32_t AabbTree::Insert(const Bounds &bounds, uint32_t item)
+{
+    const int32_t leaf = AllocateNode();
+    Node &node = _nodes[leaf];
+    node.min = bounds.min - _margin;
+    node.max = bounds.max + _margin;
+    node.item = item;
+    node.height = 0;
+
+    InsertLeaf(leaf);
+    _leafCount++;
+    return leaf;
+}
+
+void AabbTree::Remove(int32_t proxy)
+{
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    _leafCount--;
+}
+
+bool AabbTree::Move(int32_t proxy, const Bounds &bounds)
+{
+    Node &node = _nodes[proxy];
+    if (glm::all(glm::lessThanEqual(node.min, bounds.min)) && glm::all(glm::lessThanEqual(bounds.max, node.max)))
+        return false;
+
+    RemoveLeaf(proxy);
+    node.min = bounds.min - _margin;
+    node.max = bounds.max + _margin;
+    InsertLeaf(proxy);
+    return true;
+}
+
+void AabbTree::Clear()
+{
+    _nodes.clear();
+    _root = Null;
+    _freeList = Null;
+    _leafCount = 0;
+}
+
+int32_t AabbTree::AllocateNode()
+{
+    if (_freeList == Null)
+    {
+        _nodes.emplace_back();
+        return static_cast<int32_t>(_nodes.size() - 1);
+    }
+
+    const int32_t node = _freeList;
+    _freeList = _nodes[node].parent;
+    _nodes[node] = Node{};
+    return node;
+}
+
+void AabbTree::FreeNode(int32_t node)
+{
+    _nodes[node].parent = _freeList;
+    _nodes[node].height = -1;
+    _freeList = node;
+}
+
+void AabbTree::InsertLeaf(int32_t leaf)
+{
+    if (_root == Null)
+    {
+        _root = leaf;
+        _nodes[leaf].parent = Null;
+        return;
+    }
+
+    // Descend to the sibling whose union with the leaf adds the least surface area (Catto's branch and bound)
+    const glm::vec3 leafMin = _nodes[leaf].min, leafMax = _nodes[leaf].max;
+    int32_t index = _root;
+    while (!_nodes[index].IsLeaf())
+    {
+        const Node &node = _nodes[index];
+        const float area = Area(node.min, node.max);
+        const float combinedArea = Area(glm::min(node.min, leafMin), glm::max(node.max, leafMax));
+
+        // Cost of pairing the leaf with this node, and the area every level below inherits
+        const float cost = 2.0f * combinedArea;
+        const float inheritance = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int32_t child)
+        {
+            const Node &c = _nodes[child];
+            const float enlarged = Area(glm::min(c.min, leafMin), glm::max(c.max, leafMax));
+            return c.IsLeaf() ? enlarged + inheritance : enlarged - Area(c.min, c.max) + inheritance;
+        };
+        const float cost1 = descendCost(node.child1);
+        const float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    // New parent of the sibling and the leaf
+    const int32_t sibling = index;
+    const int32_t oldParent = _nodes[sibling].parent;
+    const int32_t newParent = AllocateNode();
+    Node &parent = _nodes[newParent];
+    parent.parent = oldParent;
+    parent.min = glm::min(leafMin, _nodes[sibling].min);
+    parent.max = glm::max(leafMax, _nodes[sibling].max);
+    parent.height = _nodes[sibling].height + 1;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+
+    if (oldParent == Null)
+        _root = newParent;
+    else if (_nodes[oldParent].child1 == sibling)
+        _nodes[oldParent].child1 = newParent;
+    else
+        _nodes[oldParent].child2 = newParent;
+
+    Refit(oldParent);
+}
+
+void AabbTree::RemoveLeaf(int32_t leaf)
+{
+    if (leaf == _root)
+    {
+        _root = Null;
+        return;
+    }
+
+    // The sibling takes the place of the parent
+    const int32_t parent = _nodes[leaf].parent;
+    const int32_t grandParent = _nodes[parent].parent;
+    const int32_t sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    if (grandParent == Null)
+    {
+        _root = sibling;
+        _nodes[sibling].parent = Null;
+        FreeNode(parent);
+        return;
+    }
+
+    if (_nodes[grandParent].child1 == parent)
+        _nodes[grandParent].child1 = sibling;
+    else
+        _nodes[grandParent].child2 = sibling;
+    _nodes[sibling].parent = grandParent;
+    FreeNode(parent);
+
+    Refit(grandParent);
+}
+
+void AabbTree::Refit(int32_t index)
+{
+    while (index != Null)
+    {
+        index = Balance(index);
+
+        Node &node = _nodes[index];
+        const Node &child1 = _nodes[node.child1];
+        const Node &child2 = _nodes[node.child2];
+        node.min = glm::min(child1.min, child2.min);
+        node.max = glm::max(child1.max, child2.max);
+        node.height = 1 + std::max(child1.height, child2.height);
+
+        index = node.parent;
+    }
+}
+
+int32_t AabbTree::Balance(int32_t a)
+{
+    Node &A = _nodes[a];
+    if (A.IsLeaf() || A.height < 2)
+        return a;
+
+    const int32_t b = A.child1;
+    const int32_t c = A.child2;
+    const int32_t balance = _nodes[c].height - _nodes[b].height;
+    if (balance >= -1 && balance <= 1)
+        return a;
+
+    // Lift the taller child, its taller child stays below it and the shorter one moves under a
+    const int32_t up = balance > 1 ? c : b;
+    const int32_t other = balance > 1 ? b : c;
+    Node &U = _nodes[up];
+    const int32_t f = U.child1;
+    const int32_t g = U.child2;
+
+    U.child1 = a;
+    U.parent = A.parent;
+    A.parent = up;
+    if (U.parent == Null)
+        _root = up;
+    else if (_nodes[U.parent].child1 == a)
+        _nodes[U.parent].child1 = up;
+    else
+        _nodes[U.parent].child2 = up;
+
+    const bool keepF = _nodes[f].height > _nodes[g].height;
+    const int32_t kept = keepF ? f : g;
+    const int32_t moved = keepF ? g : f;
+    U.child2 = kept;
+    if (balance > 1)
+        A.child2 = moved;
+    else
+        A.child1 = moved;
+    _nodes[moved].parent = a;
+
+    const Node &O = _nodes[other];
+    const Node &M = _nodes[moved];
+    const Node &K = _nodes[kept];
+    A.min = glm::min(O.min, M.min);
+    A.max = glm::max(O.max, M.max);
+    A.height = 1 + std::max(O.height, M.height);
+    U.min = glm::min(A.min, K.min);
+    U.max = glm::max(A.max, K.max);
+    U.height = 1 + std::max(A.height, K.height);
+    return up;
+}
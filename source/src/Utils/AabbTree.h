@@ -0,0 +1,221 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       AabbTree.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Dynamic bounding volume hierarchy over moving world bounds.
+ *
+ *  This file declares the AabbTree class, a binary tree of axis aligned
+ *  boxes whose leaves hold the items of the scene. Leaves store their box
+ *  enlarged by a margin, so an item moving inside it costs nothing; one
+ *  leaving it is removed and inserted again at the sibling with the lowest
+ *  surface area cost, and rotations keep the tree balanced. Queries walk the
+ *  tree from the root and skip every subtree whose box misses the query
+ *  volume: a box, a sphere, a frustum or a ray.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include "Bounds.h"
+#include "Frustum.h"
+
+// Features
+#define IMPL_AABB_TREE
+
+class AabbTree
+{
+public:
+    static constexpr int32_t Null = -1;
+
+    /// @param margin Added to every side of a leaf box, movement within it needs no update
+    explicit AabbTree(float margin = 0.1f) : _margin(margin) {}
+
+    /// Insert an item with its world bounds, returns the proxy to move or remove it with.
+    int32_t Insert(const Bounds &bounds, uint32_t item);
+    void Remove(int32_t proxy);
+    /**
+     * @brief Update the bounds of a proxy.
+     * @return True if the item left its enlarged box and was inserted again.
+     */
+    bool Move(int32_t proxy, const Bounds &bounds);
+    void Clear();
+
+    [[nodiscard]] uint32_t Item(int32_t proxy) const { return _nodes[proxy].item; }
+    [[nodiscard]] uint32_t Size() const { return _leafCount; }
+    /// Longest path from the root to a leaf, 0 for a single leaf
+    [[nodiscard]] int32_t Height() const { return _root == Null ? 0 : _nodes[_root].height; }
+
+    /// Calls callback(item) for every item whose box overlaps [min, max].
+    template <typename Callback>
+    void QueryBox(const glm::vec3 &min, const glm::vec3 &max, Callback &&callback) const
+    {
+        Traverse([&](const Node &node) { return Overlaps(node, min, max); }, callback);
+    }
+
+    /// Calls callback(item) for every item whose box overlaps the sphere.
+    template <typename Callback>
+    void QuerySphere(const glm::vec3 &center, float radius, Callback &&callback) const
+    {
+        const float radius2 = radius * radius;
+        Traverse([&](const Node &node)
+        {
+            const glm::vec3 d = center - glm::clamp(center, node.min, node.max);
+            return glm::dot(d, d) <= radius2;
+        }, callback);
+    }
+
+    /// Calls callback(item) for every item whose box is not completely outside one of the planes.
+    template <typename Callback>
+    void QueryFrustum(const Frustum &frustum, Callback &&callback) const
+    {
+        Traverse([&](const Node &node)
+        {
+            const glm::vec3 center = (node.min + node.max) * 0.5f;
+            const glm::vec3 extents = (node.max - node.min) * 0.5f;
+            for (const glm::vec4 &plane : frustum.Planes())
+            {
+                const glm::vec3 normal(plane);
+                if (glm::dot(normal, center) + plane.w + glm::dot(glm::abs(normal), extents) < 0.0f)
+                    return false;
+            }
+            return true;
+        }, callback);
+    }
+
+    /**
+     * @brief Visit the items whose box the ray enters before maxDistance.
+     * @param callback float(item, entry distance), returns the new maxDistance, e.g. the distance
+     *                 of a hit found inside the item to skip everything behind it; maxDistance to go on.
+     */
+    template <typename Callback>
+    void QueryRay(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, Callback &&callback) const
+    {
+        if (_root == Null)
+            return;
+
+        const glm::vec3 inverse = 1.0f / direction;
+        Stack stack;
+        stack.Push(_root);
+        while (!stack.Empty())
+        {
+            const Node &node = _nodes[stack.Pop()];
+            const float entry = RayEntry(node, origin, inverse, maxDistance);
+            if (entry > maxDistance)
+                continue;
+
+            if (node.IsLeaf())
+                maxDistance = callback(node.item, entry);
+            else
+            {
+                stack.Push(node.child1);
+                stack.Push(node.child2);
+            }
+        }
+    }
+
+private:
+    struct Node
+    {
+        glm::vec3 min = glm::vec3(0.0f);
+        glm::vec3 max = glm::vec3(0.0f);
+        int32_t parent = Null;   ///< next free node while on the free list
+        int32_t child1 = Null;
+        int32_t child2 = Null;
+        int32_t height = 0;      ///< 0 for leaves, -1 for free nodes
+        uint32_t item  = 0;
+
+        [[nodiscard]] bool IsLeaf() const { return child1 == Null; }
+    };
+
+    /// Traversal stack, on the call stack up to a depth no balanced tree of this size reaches
+    class Stack
+    {
+    public:
+        void Push(int32_t node)
+        {
+            if (_size < Fixed)
+                _fixed[_size] = node;
+            else
+                _overflow.push_back(node);
+            _size++;
+        }
+        int32_t Pop()
+        {
+            _size--;
+            if (_size < Fixed)
+                return _fixed[_size];
+            const int32_t node = _overflow.back();
+            _overflow.pop_back();
+            return node;
+        }
+        [[nodiscard]] bool Empty() const { return _size == 0; }
+
+    private:
+        static constexpr size_t Fixed = 64;
+        int32_t _fixed[Fixed];
+        std::vector<int32_t> _overflow;
+        size_t _size = 0;
+    };
+
+    template <typename Test, typename Callback>
+    void Traverse(const Test &test, Callback &callback) const
+    {
+        if (_root == Null)
+            return;
+
+        Stack stack;
+        stack.Push(_root);
+        while (!stack.Empty())
+        {
+            const Node &node = _nodes[stack.Pop()];
+            if (!test(node))
+                continue;
+
+            if (node.IsLeaf())
+                callback(node.item);
+            else
+            {
+                stack.Push(node.child1);
+                stack.Push(node.child2);
+            }
+        }
+    }
+
+    static bool Overlaps(const Node &node, const glm::vec3 &min, const glm::vec3 &max)
+    {
+        return node.min.x <= max.x && node.max.x >= min.x && node.min.y <= max.y && node.max.y >= min.y &&
+               node.min.z <= max.z && node.max.z >= min.z;
+    }
+    /// Distance at which the ray enters the box, clamped to 0 inside it; above maxDistance on a miss
+    static float RayEntry(const Node &node, const glm::vec3 &origin, const glm::vec3 &inverse, float maxDistance)
+    {
+        const glm::vec3 t1 = (node.min - origin) * inverse;
+        const glm::vec3 t2 = (node.max - origin) * inverse;
+        const glm::vec3 near = glm::min(t1, t2);
+        const glm::vec3 far = glm::max(t1, t2);
+        const float entry = glm::max(glm::max(near.x, near.y), glm::max(near.z, 0.0f));
+        const float exit = glm::min(glm::min(far.x, far.y), glm::min(far.z, maxDistance));
+        return entry <= exit ? entry : maxDistance + 1.0f;
+    }
+    static float Area(const glm::vec3 &min, const glm::vec3 &max)
+    {
+        const glm::vec3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t node);
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+    /// Rotate the subtree so its children differ in height by at most one, returns its new root
+    int32_t Balance(int32_t node);
+    /// Recompute the boxes and heights from a node up to the root, balancing on the way
+    void Refit(int32_t node);
+
+    std::vector<Node> _nodes;
+    int32_t _root = Null;
+    int32_t _freeList = Null;
+    uint32_t _leafCount = 0;
+    float _margin = 0.1f;
+};
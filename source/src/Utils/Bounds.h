@@ -0,0 +1,111 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       Bounds.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Axis aligned box and bounding sphere of a set of points.
+ *
+ *  This file defines the Bounds struct, computed once from the positions of
+ *  a mesh or primitive when it is loaded. Transformed() moves local bounds
+ *  into world space (Arvo), so moving objects need no pass over their
+ *  vertices.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include <cfloat>
+#include <glm/glm.hpp>
+
+struct Bounds
+{
+    glm::vec3 min    = glm::vec3(FLT_MAX);
+    glm::vec3 max    = glm::vec3(-FLT_MAX);
+    glm::vec3 center = glm::vec3(0.0f); ///< of the sphere, the box center
+    float     radius = 0.0f;            ///< of the sphere, the farthest point from center
+
+    /**
+     * @brief Bounds of strided positions.
+     * @param positions First position, three floats.
+     * @param count     Number of positions.
+     * @param stride    Floats from one position to the next.
+     */
+    static Bounds FromPositions(const float *positions, size_t count, size_t stride = 3)
+    {
+        Bounds bounds;
+        for (size_t i = 0; i < count; i++)
+        {
+            const glm::vec3 p(positions[i * stride], positions[i * stride + 1], positions[i * stride + 2]);
+            bounds.min = glm::min(bounds.min, p);
+            bounds.max = glm::max(bounds.max, p);
+        }
+        if (bounds.Empty())
+            return {};
+
+        // Sphere around the box center, tighter than the half diagonal for round shapes
+        bounds.center = bounds.Center();
+        float radius2 = 0.0f;
+        for (size_t i = 0; i < count; i++)
+        {
+            const glm::vec3 p(positions[i * stride], positions[i * stride + 1], positions[i * stride + 2]);
+            const glm::vec3 d = p - bounds.center;
+            radius2 = glm::max(radius2, glm::dot(d, d));
+        }
+        bounds.radius = glm::sqrt(radius2);
+        return bounds;
+    }
+
+    /// Grow to contain a sphere, e.g. a shape the vertex shader morphs the vertices towards.
+    void Extend(const glm::vec3 &sphereCenter, float sphereRadius)
+    {
+        if (Empty())
+        {
+            min = sphereCenter - sphereRadius;
+            max = sphereCenter + sphereRadius;
+            center = sphereCenter;
+            radius = sphereRadius;
+            return;
+        }
+
+        min = glm::min(min, sphereCenter - sphereRadius);
+        max = glm::max(max, sphereCenter + sphereRadius);
+
+        // Smallest sphere around both spheres
+        const float distance = glm::length(sphereCenter - center);
+        if (distance + sphereRadius <= radius)
+            return;
+        if (distance + radius <= sphereRadius)
+        {
+            center = sphereCenter;
+            radius = sphereRadius;
+            return;
+        }
+        const float merged = (distance + radius + sphereRadius) * 0.5f;
+        center += (sphereCenter - center) * ((merged - radius) / distance);
+        radius = merged;
+    }
+
+    /// World bounds under a model matrix, the box of the transformed box and the sphere scaled by the largest axis.
+    [[nodiscard]] Bounds Transformed(const glm::mat4 &model) const
+    {
+        if (Empty())
+            return {};
+
+        const glm::mat3 linear(model);
+        const glm::mat3 absolute(glm::abs(linear[0]), glm::abs(linear[1]), glm::abs(linear[2]));
+        const glm::vec3 boxCenter = glm::vec3(model * glm::vec4(Center(), 1.0f));
+        const glm::vec3 extents = absolute * Extents();
+
+        Bounds world;
+        world.min = boxCenter - extents;
+        world.max = boxCenter + extents;
+        world.center = glm::vec3(model * glm::vec4(center, 1.0f));
+        world.radius = radius * glm::sqrt(glm::max(glm::max(glm::dot(linear[0], linear[0]), glm::dot(linear[1], linear[1])),
+                                                   glm::dot(linear[2], linear[2])));
+        return world;
+    }
+
+    [[nodiscard]] bool Empty() const { return min.x > max.x; }
+    [[nodiscard]] glm::vec3 Center() const { return (min + max) * 0.5f; }
+    [[nodiscard]] glm::vec3 Extents() const { return (max - min) * 0.5f; }
+};
@@ -0,0 +1,56 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       Frustum.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      View frustum planes for visibility tests.
+ *
+ *  This file defines the Frustum class, which extracts the six clip planes
+ *  from a combined projection * view (* model) matrix (Gribb/Hartmann) and
+ *  tests bounding spheres against them. Passing the model matrix as well
+ *  yields planes in object space, so object-space bounds can be tested as is.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include <array>
+#include <glm/glm.hpp>
+
+class Frustum
+{
+public:
+    Frustum() = default;
+
+    /// @param clip Projection * view (* model) matrix, OpenGL clip space (-w <= z <= w)
+    explicit Frustum(const glm::mat4 &clip)
+    {
+        const glm::mat4 m = glm::transpose(clip);
+        _planes[0] = m[3] + m[0]; // left
+        _planes[1] = m[3] - m[0]; // right
+        _planes[2] = m[3] + m[1]; // bottom
+        _planes[3] = m[3] - m[1]; // top
+        _planes[4] = m[3] + m[2]; // near
+        _planes[5] = m[3] - m[2]; // far
+
+        // normalize so plane distances are in the units of the input space
+        for (glm::vec4 &plane : _planes)
+            plane /= glm::length(glm::vec3(plane));
+    }
+
+    /// @return False if the sphere lies completely outside one of the planes
+    [[nodiscard]] bool Intersects(const glm::vec3 &center, float radius) const
+    {
+        for (const glm::vec4 &plane : _planes)
+        {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+                return false;
+        }
+        return true;
+    }
+
+    [[nodiscard]] const std::array<glm::vec4, 6> &Planes() const { return _planes; }
+
+private:
+    std::array<glm::vec4, 6> _planes = {};
+};
@@ -0,0 +1,34 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       Hash.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      FNV-1a hashing of byte ranges for cache keys.
+ *
+ *  This file defines Fnv1a, a 64-bit FNV-1a hash used to key the on-disk
+ *  caches. Passing the previous result as the seed hashes several ranges
+ *  as if they were one.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+
+static constexpr uint64_t FnvOffset = 14695981039346656037ull;
+static constexpr uint64_t FnvPrime  = 1099511628211ull;
+
+inline uint64_t Fnv1a(const uint8_t *data, size_t size, uint64_t hash = FnvOffset)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= FnvPrime;
+    }
+    return hash;
+}
+
+inline uint64_t Fnv1a(std::string_view text, uint64_t hash = FnvOffset)
+{
+    return Fnv1a(reinterpret_cast<const uint8_t *>(text.data()), text.size(), hash);
+}
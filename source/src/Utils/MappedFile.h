@@ -0,0 +1,46 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       MappedFile.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Read-only memory mapping of a file.
+ *
+ *  This file declares the MappedFile class, a small RAII wrapper around
+ *  mmap (POSIX) and MapViewOfFile (Windows). The whole file is mapped
+ *  read-only on construction and unmapped on destruction, so binary
+ *  assets can be consumed without copying them into heap buffers.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    /// Map the whole file read-only. Check IsOpen() for success.
+    /// @param path Path of the file to map
+    explicit MappedFile(const std::filesystem::path &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &other) = delete;
+    MappedFile &operator=(const MappedFile &other) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    [[nodiscard]] bool IsOpen() const { return _data != nullptr; }
+    [[nodiscard]] const uint8_t *Data() const { return _data; }
+    [[nodiscard]] size_t Size() const { return _size; }
+
+private:
+    void Close();
+
+    const uint8_t *_data = nullptr;
+    size_t _size = 0;
+#ifdef _WIN32
+    void *_file = nullptr;
+    void *_mapping = nullptr;
+#endif
+};
@@ -0,0 +1,36 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       Stopwatch.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Minimal wall-clock stopwatch for timing logs.
+ *
+ *  This file defines the Stopwatch class, a thin wrapper over
+ *  std::chrono::steady_clock used to report load and startup times
+ *  in milliseconds.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include <chrono>
+
+class Stopwatch
+{
+public:
+    Stopwatch() : _start(std::chrono::steady_clock::now()) {}
+
+    void Restart()
+    {
+        _start = std::chrono::steady_clock::now();
+    }
+
+    /// @return Milliseconds elapsed since construction or the last Restart()
+    [[nodiscard]] double ElapsedMs() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point _start;
+};
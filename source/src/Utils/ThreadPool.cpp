@@ -0,0 +1,92 @@
+#include "ThreadPool.h"
+#include <atomic>
+#include <latch>
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    _workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i)
+        _workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_all();
+
+    for (std::thread &worker : _workers)
+        worker.join();
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)> &job)
+{
+    if (count == 0)
+        return;
+
+    const auto drainCount = static_cast<std::ptrdiff_t>(std::min<size_t>(count, _workers.size()));
+    std::atomic<size_t> next = 0;
+    std::latch finished(drainCount);
+
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    // Every drain task pulls indices until the range is exhausted
+    for (std::ptrdiff_t d = 0; d < drainCount; ++d)
+    {
+        Submit([&]
+        {
+            for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+            {
+                try
+                {
+                    job(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+            finished.count_down();
+        });
+    }
+
+    finished.wait();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+    {
+        std::lock_guard lock(_mutex);
+        _tasks.push(std::move(task));
+    }
+    _condition.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+
+            if (_stopping && _tasks.empty())
+                return;
+
+            task = std::move(_tasks.front());
+            _tasks.pop();
+        }
+        task();
+    }
+}
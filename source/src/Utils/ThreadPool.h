@@ -0,0 +1,52 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       ThreadPool.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Fixed-size pool of worker threads for CPU-bound loading work.
+ *
+ *  This file declares the ThreadPool class. Workers are started once and wait
+ *  for jobs on a shared queue; ParallelFor splits an index range across them
+ *  and blocks until every index has been processed.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+
+class ThreadPool
+{
+public:
+    /// @param threadCount Number of workers, 0 uses the hardware concurrency
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &other) = delete;
+    ThreadPool &operator=(const ThreadPool &other) = delete;
+
+    [[nodiscard]] unsigned int ThreadCount() const { return static_cast<unsigned int>(_workers.size()); }
+
+    /**
+     * @brief Run job(i) for every i in [0, count) on the workers and wait for completion.
+     *
+     * Indices are handed out dynamically, so uneven jobs still balance. The first
+     * exception thrown by a job is rethrown on the calling thread.
+     */
+    void ParallelFor(size_t count, const std::function<void(size_t)> &job);
+
+private:
+    void Submit(std::function<void()> task);
+    void WorkerLoop();
+
+    std::vector<std::thread> _workers;
+    std::queue<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping = false;
+};
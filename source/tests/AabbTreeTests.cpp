@@ -0,0 +1,243 @@
+#include "Test.h"
+#include "src/Utils/AabbTree.h"
+
+namespace
+{
+constexpr float Margin = 0.1f;
+constexpr float BoxSize = 2.0f, SphereRadius = 2.0f, RayLength = 50.0f;
+
+glm::vec3 RandomPoint(uint32_t seed, float extent)
+{
+    return glm::vec3(Random(3 * seed), Random(3 * seed + 1), Random(3 * seed + 2)) * extent;
+}
+
+/// Boxes of 0.05 to 1 units scattered over a cube of the given extent.
+std::vector<Bounds> MakeBoxes(uint32_t count, float extent)
+{
+    std::vector<Bounds> boxes(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const glm::vec3 center = RandomPoint(i, extent);
+        const float half = 0.025f + 0.475f * Random(i ^ 0x5bd1e995u);
+        boxes[i].min = center - half;
+        boxes[i].max = center + half;
+    }
+    return boxes;
+}
+
+Bounds Grown(const Bounds &bounds, float amount)
+{
+    return {bounds.min - amount, bounds.max + amount};
+}
+
+bool OverlapsBox(const Bounds &bounds, const glm::vec3 &min, const glm::vec3 &max)
+{
+    return glm::all(glm::lessThanEqual(bounds.min, max)) && glm::all(glm::lessThanEqual(min, bounds.max));
+}
+
+bool OverlapsSphere(const Bounds &bounds, const glm::vec3 &center, float radius)
+{
+    const glm::vec3 d = center - glm::clamp(center, bounds.min, bounds.max);
+    return glm::dot(d, d) <= radius * radius;
+}
+
+bool HitsRay(const Bounds &bounds, const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance)
+{
+    const glm::vec3 t1 = (bounds.min - origin) / direction, t2 = (bounds.max - origin) / direction;
+    const glm::vec3 near = glm::min(t1, t2), far = glm::max(t1, t2);
+    return glm::max(glm::max(near.x, near.y), glm::max(near.z, 0.0f)) <= glm::min(glm::min(far.x, far.y), glm::min(far.z, maxDistance));
+}
+
+bool InsideFrustum(const Bounds &bounds, const Frustum &frustum)
+{
+    for (const glm::vec4 &plane : frustum.Planes())
+        if (glm::dot(glm::vec3(plane), bounds.Center()) + plane.w + glm::dot(glm::abs(glm::vec3(plane)), bounds.Extents()) < 0.0f)
+            return false;
+    return true;
+}
+
+/**
+ * @brief Check the items every kind of query finds against brute force over the live boxes.
+ *
+ * The tree has to find every box the query volume touches, and may only add boxes that touch it within
+ * slack, the margin of the leaves plus what the boxes moved inside them. No item is reported twice.
+ */
+void CheckQueries(const AabbTree &tree, const std::vector<Bounds> &boxes, const std::vector<uint8_t> &live, float extent, float slack)
+{
+    const glm::mat4 projection = glm::perspective(glm::radians(35.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    std::vector<uint32_t> found(boxes.size());
+
+    for (uint32_t q = 0; q < 40; q++)
+    {
+        const glm::vec3 point = RandomPoint(1000 + q, extent);
+        const glm::vec3 direction = glm::normalize(RandomPoint(2000 + q, 1.0f) - 0.49f);
+        const Frustum frustum(projection * glm::lookAt(point, point + direction, glm::vec3(0.0f, 1.0f, 0.0f)));
+
+        for (int kind = 0; kind < 4; kind++)
+        {
+            std::fill(found.begin(), found.end(), 0);
+            auto visit = [&found](uint32_t item) { found[item]++; };
+            if (kind == 0)
+                tree.QueryBox(point - BoxSize, point + BoxSize, visit);
+            else if (kind == 1)
+                tree.QuerySphere(point, SphereRadius, visit);
+            else if (kind == 2)
+                tree.QueryRay(point, direction, RayLength, [&visit](uint32_t item, float) { visit(item); return RayLength; });
+            else
+                tree.QueryFrustum(frustum, visit);
+
+            auto touches = [&](const Bounds &b)
+            {
+                if (kind == 0)
+                    return OverlapsBox(b, point - BoxSize, point + BoxSize);
+                if (kind == 1)
+                    return OverlapsSphere(b, point, SphereRadius);
+                if (kind == 2)
+                    return HitsRay(b, point, direction, RayLength);
+                return InsideFrustum(b, frustum);
+            };
+
+            uint32_t missed = 0, extra = 0, duplicates = 0;
+            for (size_t i = 0; i < boxes.size(); i++)
+            {
+                if (!live[i])
+                {
+                    extra += found[i] != 0;
+                    continue;
+                }
+                missed += touches(boxes[i]) && !found[i];
+                extra += found[i] && !touches(Grown(boxes[i], slack));
+                duplicates += found[i] > 1;
+            }
+            CHECK_EQ(missed, 0u);
+            CHECK_EQ(extra, 0u);
+            CHECK_EQ(duplicates, 0u);
+        }
+    }
+}
+} // namespace
+
+TEST(AabbTree, QueriesMatchBruteForce)
+{
+    constexpr uint32_t Count = 3000;
+    constexpr float Extent = 40.0f;
+    const std::vector<Bounds> boxes = MakeBoxes(Count, Extent);
+
+    AabbTree tree(Margin);
+    for (uint32_t i = 0; i < Count; i++)
+        tree.Insert(boxes[i], i);
+    CHECK_EQ(tree.Size(), Count);
+
+    // Balanced: a perfect tree of 3000 leaves has height 12
+    CHECK(tree.Height() >= 12);
+    CHECK(tree.Height() <= 24);
+
+    CheckQueries(tree, boxes, std::vector<uint8_t>(Count, 1), Extent, Margin);
+}
+
+TEST(AabbTree, MovesKeepQueriesExact)
+{
+    constexpr uint32_t Count = 2000;
+    constexpr float Extent = 30.0f;
+    std::vector<Bounds> boxes = MakeBoxes(Count, Extent);
+
+    AabbTree tree(Margin);
+    std::vector<int32_t> proxies(Count);
+    for (uint32_t i = 0; i < Count; i++)
+        proxies[i] = tree.Insert(boxes[i], i);
+
+    // Movement inside the margin leaves the leaf alone, anything further reinserts it
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        const glm::vec3 small = (RandomPoint(5000 + i, 1.0f) - 0.5f) * Margin;
+        boxes[i] = {boxes[i].min + small, boxes[i].max + small};
+        CHECK(!tree.Move(proxies[i], boxes[i]));
+    }
+    CheckQueries(tree, boxes, std::vector<uint8_t>(Count, 1), Extent, 2.0f * Margin);
+
+    uint32_t reinserted = 0;
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        const glm::vec3 large = (RandomPoint(7000 + i, 1.0f) - 0.5f) * 6.0f;
+        boxes[i] = {boxes[i].min + large, boxes[i].max + large};
+        reinserted += tree.Move(proxies[i], boxes[i]);
+        CHECK_EQ(tree.Item(proxies[i]), i);
+    }
+    CHECK(reinserted > Count * 9 / 10);
+    CHECK_EQ(tree.Size(), Count);
+    CHECK(tree.Height() <= 24);
+    CheckQueries(tree, boxes, std::vector<uint8_t>(Count, 1), Extent, 2.0f * Margin);
+}
+
+TEST(AabbTree, RemovedItemsAreNotFound)
+{
+    constexpr uint32_t Count = 2000;
+    constexpr float Extent = 30.0f;
+    const std::vector<Bounds> boxes = MakeBoxes(Count, Extent);
+
+    AabbTree tree(Margin);
+    std::vector<int32_t> proxies(Count);
+    for (uint32_t i = 0; i < Count; i++)
+        proxies[i] = tree.Insert(boxes[i], i);
+
+    std::vector<uint8_t> live(Count, 1);
+    for (uint32_t i = 0; i < Count; i += 3)
+    {
+        tree.Remove(proxies[i]);
+        live[i] = 0;
+    }
+    CHECK_EQ(tree.Size(), Count - (Count + 2) / 3);
+    CheckQueries(tree, boxes, live, Extent, Margin);
+
+    // Inserted again into the freed nodes, they are found again
+    for (uint32_t i = 0; i < Count; i += 3)
+    {
+        proxies[i] = tree.Insert(boxes[i], i);
+        live[i] = 1;
+    }
+    CHECK_EQ(tree.Size(), Count);
+    CheckQueries(tree, boxes, live, Extent, Margin);
+
+    tree.Clear();
+    CHECK_EQ(tree.Size(), 0u);
+    CHECK_EQ(tree.Height(), 0);
+    uint32_t visited = 0;
+    tree.QueryBox(glm::vec3(-1e6f), glm::vec3(1e6f), [&visited](uint32_t) { visited++; });
+    CHECK_EQ(visited, 0u);
+}
+
+TEST(AabbTree, RayStopsAtTheNearestHit)
+{
+    // A row of unit boxes along x, one every 4 units
+    AabbTree tree(0.0f);
+    std::vector<Bounds> boxes;
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        boxes.push_back({glm::vec3(4.0f * i, -0.5f, -0.5f), glm::vec3(4.0f * i + 1.0f, 0.5f, 0.5f)});
+        tree.Insert(boxes.back(), i);
+    }
+
+    // Entry distances are in units of the direction, callbacks shortening the ray skip the boxes behind
+    const glm::vec3 origin(-2.0f, 0.0f, 0.0f), direction(2.0f, 0.0f, 0.0f);
+    std::vector<uint32_t> visited;
+    tree.QueryRay(origin, direction, 100.0f, [&](uint32_t item, float entry)
+    {
+        CHECK(std::abs(entry - (4.0f * item + 2.0f) / 2.0f) < 1e-5f);
+        visited.push_back(item);
+        return item == 2 ? entry : 100.0f;
+    });
+    const auto nearest = std::find(visited.begin(), visited.end(), 2u);
+    CHECK(nearest != visited.end());
+    CHECK(std::all_of(nearest, visited.end(), [](uint32_t item) { return item <= 2; }));
+
+    // Starting inside a box enters it at 0, a ray ending before a box misses it
+    uint32_t hits = 0;
+    tree.QueryRay(glm::vec3(4.5f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 3.0f, [&](uint32_t item, float entry)
+    {
+        CHECK_EQ(item, 1u);
+        CHECK_EQ(entry, 0.0f);
+        hits++;
+        return 3.0f;
+    });
+    CHECK_EQ(hits, 1u);
+}
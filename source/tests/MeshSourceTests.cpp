@@ -0,0 +1,273 @@
+#include "Test.h"
+#include "src/Resources/Mesh/MeshSource.h"
+
+namespace
+{
+/// Attributes of a generated mesh, tightly packed like the vectors of MeshSource.
+struct Attributes
+{
+    uint32_t vertexCount = 0;
+    std::vector<float> positions, normals, uvs, tangents; ///< tangents with four components, as in glTF
+    std::vector<unsigned int> indices;
+};
+
+Attributes MakeAttributes(uint32_t vertexCount)
+{
+    uint32_t state = 0x12345678u + vertexCount;
+    auto random = [&state]()
+    {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / static_cast<float>(1 << 24) * 2.0f - 1.0f;
+    };
+
+    Attributes attributes;
+    attributes.vertexCount = vertexCount;
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            attributes.positions.push_back(random());
+            attributes.normals.push_back(random());
+        }
+        for (int i = 0; i < 2; i++)
+            attributes.uvs.push_back(random());
+        for (int i = 0; i < 4; i++)
+            attributes.tangents.push_back(random());
+    }
+    for (uint32_t v = 0; v + 2 < vertexCount; v++)
+    {
+        attributes.indices.push_back(v);
+        attributes.indices.push_back(v + 2);
+        attributes.indices.push_back(v + 1);
+    }
+    return attributes;
+}
+
+/// Interleaved stream written one float at a time, the layout MeshSource::Interleave() has to produce.
+std::vector<float> ReferenceInterleave(const Attributes &attributes, bool normals, bool uvs, bool tangents)
+{
+    std::vector<float> out;
+    for (uint32_t v = 0; v < attributes.vertexCount; v++)
+    {
+        out.insert(out.end(), &attributes.positions[v * 3], &attributes.positions[v * 3] + 3);
+        if (normals)
+            out.insert(out.end(), &attributes.normals[v * 3], &attributes.normals[v * 3] + 3);
+        if (uvs)
+            out.insert(out.end(), &attributes.uvs[v * 2], &attributes.uvs[v * 2] + 2);
+        if (tangents)
+            out.insert(out.end(), &attributes.tangents[v * 4], &attributes.tangents[v * 4] + 3);
+    }
+    return out;
+}
+
+/// Copy path: the attributes copied into the vectors of a MeshSource, as the single mesh loads do.
+MeshSource CopySource(const Attributes &attributes, bool normals, bool uvs, bool tangents)
+{
+    MeshSource source(attributes.vertexCount, static_cast<uint32_t>(attributes.indices.size() / 3));
+    source.SetPositions(attributes.positions.data());
+    if (normals)
+        source.SetNormals(attributes.normals.data());
+    if (uvs)
+        source.SetTexCoords(attributes.uvs.data(), 0);
+    if (tangents)
+    {
+        std::vector<float> tangents3;
+        for (uint32_t v = 0; v < attributes.vertexCount; v++)
+            tangents3.insert(tangents3.end(), &attributes.tangents[v * 4], &attributes.tangents[v * 4] + 3);
+        source.SetTangents(tangents3.data());
+    }
+    source.SetIndices(attributes.indices.data());
+    source.UpdateCounts();
+    return source;
+}
+
+/**
+ * @brief Storage of a view path source, every attribute in its own exactly sized buffer like tightly packed
+ * glTF accessors, or all of them in one interleaved buffer.
+ */
+struct ViewStorage
+{
+    std::vector<std::vector<uint8_t>> buffers;
+    MeshViews views;
+};
+
+std::shared_ptr<ViewStorage> MakeViews(const Attributes &attributes, bool normals, bool uvs, bool tangents, bool interleaved)
+{
+    auto storage = std::make_shared<ViewStorage>();
+    const uint32_t count = attributes.vertexCount;
+
+    const std::pair<const std::vector<float> *, uint32_t> present[] = {
+        {&attributes.positions, 3},
+        {normals ? &attributes.normals : nullptr, 3},
+        {uvs ? &attributes.uvs : nullptr, 2},
+        {tangents ? &attributes.tangents : nullptr, 4},
+    };
+    AttributeView *targets[] = {&storage->views.positions, &storage->views.normals, &storage->views.uvs, &storage->views.tangents};
+
+    if (interleaved)
+    {
+        uint32_t stride = 0;
+        for (const auto &[attribute, components] : present)
+            stride += attribute ? components * static_cast<uint32_t>(sizeof(float)) : 0;
+
+        std::vector<uint8_t> &buffer = storage->buffers.emplace_back(static_cast<size_t>(count) * stride);
+        uint32_t offset = 0;
+        for (int a = 0; a < 4; a++)
+        {
+            const auto &[attribute, components] = present[a];
+            if (!attribute)
+                continue;
+
+            for (uint32_t v = 0; v < count; v++)
+                std::memcpy(&buffer[static_cast<size_t>(v) * stride + offset], &(*attribute)[v * components], components * sizeof(float));
+            *targets[a] = {buffer.data() + offset, count, stride, components};
+            offset += components * static_cast<uint32_t>(sizeof(float));
+        }
+    }
+    else
+    {
+        for (int a = 0; a < 4; a++)
+        {
+            const auto &[attribute, components] = present[a];
+            if (!attribute)
+                continue;
+
+            std::vector<uint8_t> &buffer = storage->buffers.emplace_back(attribute->size() * sizeof(float));
+            std::memcpy(buffer.data(), attribute->data(), buffer.size());
+            *targets[a] = {buffer.data(), count, components * static_cast<uint32_t>(sizeof(float)), components};
+        }
+    }
+
+    // 16-bit indices, as glTF stores small meshes
+    std::vector<uint8_t> &indices = storage->buffers.emplace_back(attributes.indices.size() * sizeof(uint16_t));
+    for (size_t i = 0; i < attributes.indices.size(); i++)
+    {
+        const auto index = static_cast<uint16_t>(attributes.indices[i]);
+        std::memcpy(&indices[i * sizeof(uint16_t)], &index, sizeof(index));
+    }
+    storage->views.indices = {indices.data(), static_cast<uint32_t>(attributes.indices.size()), sizeof(uint16_t)};
+
+    return storage;
+}
+
+/// Interleave into a buffer with guard floats on both sides, which have to stay untouched.
+std::vector<float> GuardedInterleave(const MeshSource &source, bool &guardsIntact)
+{
+    constexpr size_t Guard = 8;
+    constexpr float Canary = -12345.0f;
+
+    const InterleavedView layout = source.Layout();
+    const size_t size = static_cast<size_t>(layout.vertexCount) * layout.Stride();
+    std::vector<float> buffer(size + 2 * Guard, Canary);
+    source.Interleave(buffer.data() + Guard);
+
+    guardsIntact = std::all_of(buffer.begin(), buffer.begin() + Guard, [](float f) { return f == Canary; }) &&
+                   std::all_of(buffer.end() - Guard, buffer.end(), [](float f) { return f == Canary; });
+    return {buffer.begin() + Guard, buffer.end() - Guard};
+}
+
+bool SameBytes(const std::vector<float> &a, const std::vector<float> &b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+} // namespace
+
+TEST(MeshSource, ViewAndCopyPathsInterleaveIdentically)
+{
+    // 1 and 2 vertices leave everything or all but one vertex to the scalar tail
+    for (const uint32_t vertexCount : {1u, 2u, 3u, 257u})
+    {
+        const Attributes attributes = MakeAttributes(vertexCount);
+        for (int mask = 0; mask < 8; mask++)
+        {
+            const bool normals = mask & 1, uvs = mask & 2, tangents = mask & 4;
+            const std::vector<float> reference = ReferenceInterleave(attributes, normals, uvs, tangents);
+
+            bool guardsIntact = false;
+            const MeshSource copySource = CopySource(attributes, normals, uvs, tangents);
+            const std::vector<float> copied = GuardedInterleave(copySource, guardsIntact);
+            CHECK(guardsIntact);
+            CHECK(SameBytes(copied, reference));
+
+            for (const bool interleaved : {false, true})
+            {
+                const std::shared_ptr<ViewStorage> storage = MakeViews(attributes, normals, uvs, tangents, interleaved);
+                MeshSource viewSource;
+                viewSource.SetViews(storage->views, storage);
+                CHECK(viewSource.HasViews());
+                CHECK_EQ(viewSource.VertexCount(), vertexCount);
+
+                const InterleavedView layout = viewSource.Layout();
+                CHECK_EQ(layout.hasNormals, normals);
+                CHECK_EQ(layout.hasUVs, uvs);
+                CHECK_EQ(layout.hasTangents, tangents);
+
+                const std::vector<float> viewed = GuardedInterleave(viewSource, guardsIntact);
+                CHECK(guardsIntact);
+                CHECK(SameBytes(viewed, copied));
+
+                // Detached data goes the copy path again
+                viewSource.Detach();
+                CHECK(!viewSource.HasViews());
+                CHECK(SameBytes(GuardedInterleave(viewSource, guardsIntact), copied));
+                CHECK(guardsIntact);
+                CHECK(std::equal(attributes.indices.begin(), attributes.indices.end(), viewSource.Indices()));
+            }
+        }
+    }
+}
+
+TEST(MeshSource, InterleavedStreamRoundTrips)
+{
+    const Attributes attributes = MakeAttributes(100);
+    const MeshSource source = CopySource(attributes, true, true, true);
+
+    std::vector<float> stream;
+    InterleavedView layout;
+    source.Interleave(stream, layout);
+    CHECK_EQ(stream.size(), static_cast<size_t>(layout.vertexCount) * layout.Stride());
+    layout.vertices = stream.data();
+    layout.indices  = attributes.indices.data();
+
+    // The stream read in place interleaves to itself, and detached into the vectors as well
+    MeshSource mapped;
+    mapped.SetInterleaved(layout, nullptr);
+    CHECK_EQ(mapped.VertexCount(), 100u);
+    CHECK_EQ(mapped.FaceCount(), static_cast<uint32_t>(attributes.indices.size() / 3));
+
+    std::vector<float> again;
+    InterleavedView againLayout;
+    mapped.Interleave(again, againLayout);
+    CHECK(SameBytes(again, stream));
+
+    mapped.Detach();
+    mapped.Interleave(again, againLayout);
+    CHECK(SameBytes(again, stream));
+}
+
+TEST(MeshSource, IndexViewsWiden)
+{
+    const std::vector<uint8_t> bytes = {0, 7, 255, 1};
+    const std::vector<uint16_t> shorts = {0, 700, 65535, 1};
+    const std::vector<uint32_t> ints = {0, 70000, 65535, 1};
+
+    const IndexView views[] = {
+        {bytes.data(), 4, 1},
+        {reinterpret_cast<const uint8_t *>(shorts.data()), 4, 2},
+        {reinterpret_cast<const uint8_t *>(ints.data()), 4, 4},
+    };
+    for (const IndexView &view : views)
+    {
+        unsigned int wide[4] = {};
+        view.CopyTo(wide);
+        for (uint32_t i = 0; i < 4; i++)
+            CHECK_EQ(wide[i], view[i]);
+    }
+    CHECK_EQ(views[0][2], 255u);
+    CHECK_EQ(views[1][1], 700u);
+    CHECK_EQ(views[2][1], 70000u);
+
+    uint16_t narrow[4] = {};
+    views[1].CopyTo(narrow);
+    CHECK(std::equal(shorts.begin(), shorts.end(), narrow));
+}
@@ -0,0 +1,156 @@
+#include "Test.h"
+#include "src/Resources/Mesh/MeshletBuilder.h"
+
+namespace
+{
+/// Indexed UV sphere of unit radius, triangles wound counter-clockwise seen from outside.
+struct SphereMesh
+{
+    std::vector<float> positions;
+    std::vector<unsigned int> indices;
+
+    [[nodiscard]] MeshViews Views() const
+    {
+        MeshViews views;
+        views.positions = {reinterpret_cast<const uint8_t *>(positions.data()), static_cast<uint32_t>(positions.size() / 3), 3 * sizeof(float), 3};
+        views.indices   = {reinterpret_cast<const uint8_t *>(indices.data()), static_cast<uint32_t>(indices.size()), sizeof(unsigned int)};
+        return views;
+    }
+    [[nodiscard]] glm::vec3 Position(uint32_t index) const { return glm::make_vec3(&positions[index * 3]); }
+};
+
+SphereMesh MakeSphere(uint32_t rings, uint32_t segments)
+{
+    SphereMesh mesh;
+    for (uint32_t r = 0; r <= rings; r++)
+    {
+        const float theta = glm::pi<float>() * r / rings;
+        for (uint32_t s = 0; s <= segments; s++)
+        {
+            const float phi = glm::two_pi<float>() * s / segments;
+            mesh.positions.insert(mesh.positions.end(), {std::sin(theta) * std::cos(phi), std::cos(theta), -std::sin(theta) * std::sin(phi)});
+        }
+    }
+    for (uint32_t r = 0; r < rings; r++)
+    {
+        for (uint32_t s = 0; s < segments; s++)
+        {
+            const uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+            if (r > 0)
+                mesh.indices.insert(mesh.indices.end(), {a, b, a + 1});
+            if (r + 1 < rings)
+                mesh.indices.insert(mesh.indices.end(), {a + 1, b, b + 1});
+        }
+    }
+    return mesh;
+}
+
+/// Triangles in a scrambled order, so consecutive triangles rarely share vertices.
+void ShuffleTriangles(std::vector<unsigned int> &indices)
+{
+    const size_t triangles = indices.size() / 3;
+    for (size_t t = triangles - 1; t > 0; t--)
+    {
+        const size_t other = (t * 2654435761u) % (t + 1);
+        std::swap_ranges(indices.begin() + t * 3, indices.begin() + t * 3 + 3, indices.begin() + other * 3);
+    }
+}
+
+/// Check that the meshlets cover every triangle exactly once in order, within the limits, with bounds around their triangles.
+void CheckMeshlets(const SphereMesh &mesh, const std::vector<Meshlet> &meshlets, uint32_t maxVertices, uint32_t maxTriangles)
+{
+    const auto triangleCount = static_cast<uint32_t>(mesh.indices.size() / 3);
+    CHECK(!meshlets.empty());
+
+    std::vector<uint32_t> covered(triangleCount, 0);
+    uint32_t nextOffset = 0;
+    for (const Meshlet &meshlet : meshlets)
+    {
+        CHECK_EQ(meshlet.indexOffset, nextOffset);
+        CHECK(meshlet.triangleCount > 0);
+        CHECK(meshlet.triangleCount <= maxTriangles);
+        nextOffset = meshlet.indexOffset + meshlet.triangleCount * 3;
+
+        std::set<unsigned int> vertices;
+        for (uint32_t i = meshlet.indexOffset; i < nextOffset && i < mesh.indices.size(); i++)
+        {
+            vertices.insert(mesh.indices[i]);
+            if (i % 3 == 0)
+                covered[i / 3]++;
+
+            const glm::vec3 p = mesh.Position(mesh.indices[i]);
+            CHECK(glm::all(glm::lessThanEqual(meshlet.boundsMin, p)) && glm::all(glm::lessThanEqual(p, meshlet.boundsMax)));
+            CHECK(glm::distance(meshlet.center, p) <= meshlet.radius * 1.0001f);
+        }
+        CHECK_EQ(meshlet.vertexCount, static_cast<uint32_t>(vertices.size()));
+        CHECK(meshlet.vertexCount <= maxVertices);
+    }
+    CHECK_EQ(nextOffset, static_cast<uint32_t>(mesh.indices.size()));
+    CHECK(std::all_of(covered.begin(), covered.end(), [](uint32_t count) { return count == 1; }));
+}
+} // namespace
+
+TEST(MeshletBuilder, CoversEveryTriangleOnce)
+{
+    SphereMesh mesh = MakeSphere(24, 48);
+    CheckMeshlets(mesh, MeshletBuilder::Build(mesh.Views()), MeshletBuilder::MaxVertices, MeshletBuilder::MaxTriangles);
+
+    // Tight limits close meshlets on either the vertex or the triangle count
+    for (const auto &[maxVertices, maxTriangles] : {std::pair{3u, 1u}, {3u, 100u}, {8u, 5u}, {16u, 100u}, {100u, 3u}})
+        CheckMeshlets(mesh, MeshletBuilder::Build(mesh.Views(), maxVertices, maxTriangles), maxVertices, maxTriangles);
+
+    ShuffleTriangles(mesh.indices);
+    CheckMeshlets(mesh, MeshletBuilder::Build(mesh.Views()), MeshletBuilder::MaxVertices, MeshletBuilder::MaxTriangles);
+}
+
+TEST(MeshletBuilder, RejectsInvalidInput)
+{
+    SphereMesh mesh = MakeSphere(4, 8);
+
+    MeshViews unindexed = mesh.Views();
+    unindexed.indices = {};
+    CHECK(MeshletBuilder::Build(unindexed).empty());
+    CHECK(MeshletBuilder::Build(mesh.Views(), 2, 10).empty());
+
+    mesh.indices[4] = static_cast<unsigned int>(mesh.positions.size() / 3);
+    CHECK(MeshletBuilder::Build(mesh.Views()).empty());
+}
+
+TEST(MeshletBuilder, CullsOnlyInvisibleTriangles)
+{
+    const SphereMesh mesh = MakeSphere(24, 48);
+    const std::vector<Meshlet> meshlets = MeshletBuilder::Build(mesh.Views(), 16, 16);
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+
+    MeshletCullStats total;
+    for (uint32_t view = 0; view < 32; view++)
+    {
+        // Cameras around the sphere, some looking at it and some past it
+        const float angle = glm::two_pi<float>() * view / 32.0f;
+        const glm::vec3 eye = glm::vec3(std::cos(angle), 0.3f * std::sin(3.0f * angle), std::sin(angle)) * (2.0f + view % 3);
+        const glm::vec3 target = view % 4 == 3 ? eye * 2.0f : glm::vec3(0.0f);
+        const Frustum frustum(projection * glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f)));
+
+        for (const Meshlet &meshlet : meshlets)
+        {
+            if (MeshletBuilder::IsVisible(meshlet, frustum, eye, &total))
+                continue;
+
+            // A rejected meshlet has no front facing triangle with a corner inside the frustum
+            for (uint32_t i = meshlet.indexOffset; i < meshlet.indexOffset + meshlet.triangleCount * 3; i += 3)
+            {
+                const glm::vec3 a = mesh.Position(mesh.indices[i]);
+                const glm::vec3 b = mesh.Position(mesh.indices[i + 1]);
+                const glm::vec3 c = mesh.Position(mesh.indices[i + 2]);
+                const bool frontFacing = glm::dot(glm::cross(b - a, c - a), eye - a) > 0.0f;
+                const bool cornerInside = frustum.Intersects(a, 0.0f) || frustum.Intersects(b, 0.0f) || frustum.Intersects(c, 0.0f);
+                CHECK(!(frontFacing && cornerInside));
+            }
+        }
+    }
+
+    // Both tests reject something over these views
+    CHECK(total.frustumCulled > 0);
+    CHECK(total.coneCulled > 0);
+    CHECK_EQ(total.meshlets, 32 * meshlets.size());
+}
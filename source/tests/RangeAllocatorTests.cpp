@@ -0,0 +1,194 @@
+#include "Test.h"
+#include "src/Resources/Mesh/RangeAllocator.h"
+
+TEST(RangeAllocator, TakesTheBestFittingRange)
+{
+    RangeAllocator allocator(100);
+    const uint32_t a = allocator.Allocate(10);
+    const uint32_t b = allocator.Allocate(30);
+    const uint32_t c = allocator.Allocate(5);
+    const uint32_t d = allocator.Allocate(20);
+    CHECK_EQ(a, 0u);
+    CHECK_EQ(b, 10u);
+    CHECK_EQ(c, 40u);
+    CHECK_EQ(d, 45u);
+
+    // Holes of 10, 5 and the tail of 35: a 5 fits the 5 exactly, an 8 the 10 best
+    allocator.Free(a, 10);
+    allocator.Free(c, 5);
+    CHECK_EQ(allocator.Allocate(5), 40u);
+    CHECK_EQ(allocator.Allocate(8), 0u);
+    CHECK_EQ(allocator.Allocate(30), 65u);
+    CHECK_EQ(allocator.Allocate(6), RangeAllocator::Invalid);
+    CHECK_EQ(allocator.Allocate(5), 70u + 25u);
+
+    const RangeAllocatorStats stats = allocator.Stats();
+    CHECK_EQ(stats.used, 98u);
+    CHECK_EQ(stats.allocations, 6u);
+    CHECK_EQ(stats.freeRanges, 1u);
+    CHECK_EQ(stats.largestFree, 2u);
+}
+
+TEST(RangeAllocator, AlignsOffsets)
+{
+    RangeAllocator allocator(64);
+    CHECK_EQ(allocator.Allocate(3), 0u);
+    CHECK_EQ(allocator.Allocate(4, 4), 4u);
+    CHECK_EQ(allocator.Allocate(6, 16), 16u);
+
+    // The padding in front of an aligned range stays free
+    CHECK_EQ(allocator.Allocate(1), 3u);
+    CHECK_EQ(allocator.Used(), 14u);
+    CHECK_EQ(allocator.Allocate(8, 32), 32u);
+    CHECK_EQ(allocator.Allocate(4, 0), RangeAllocator::Invalid);
+    CHECK_EQ(allocator.Allocate(0), RangeAllocator::Invalid);
+}
+
+TEST(RangeAllocator, CoalescesFreedNeighbours)
+{
+    RangeAllocator allocator(40);
+    uint32_t offsets[4];
+    for (uint32_t &offset : offsets)
+        offset = allocator.Allocate(10);
+    CHECK_EQ(allocator.Stats().freeRanges, 0u);
+
+    // Freed ranges merge with the free one on either side, so freeing all leaves a single range
+    allocator.Free(offsets[0], 10);
+    allocator.Free(offsets[2], 10);
+    CHECK_EQ(allocator.Stats().freeRanges, 2u);
+    CHECK(allocator.Stats().Fragmentation() > 0.0);
+    allocator.Free(offsets[1], 10);
+    CHECK_EQ(allocator.Stats().freeRanges, 1u);
+    CHECK_EQ(allocator.Stats().largestFree, 30u);
+    allocator.Free(offsets[3], 10);
+
+    const RangeAllocatorStats stats = allocator.Stats();
+    CHECK_EQ(stats.freeRanges, 1u);
+    CHECK_EQ(stats.largestFree, 40u);
+    CHECK_EQ(stats.used, 0u);
+    CHECK_EQ(stats.allocations, 0u);
+    CHECK_EQ(stats.Fragmentation(), 0.0);
+    CHECK_EQ(allocator.Allocate(40), 0u);
+}
+
+TEST(RangeAllocator, IgnoresDoubleFrees)
+{
+    RangeAllocator allocator(30);
+    const uint32_t a = allocator.Allocate(10);
+    const uint32_t b = allocator.Allocate(10);
+    allocator.Free(a, 10);
+
+    // Freeing a free range, or one overlapping it, changes nothing
+    allocator.Free(a, 10);
+    allocator.Free(a + 5, 10);
+    allocator.Free(b + 10, 5);
+    allocator.Free(RangeAllocator::Invalid, 10);
+    allocator.Free(b, 0);
+
+    const RangeAllocatorStats stats = allocator.Stats();
+    CHECK_EQ(stats.used, 10u);
+    CHECK_EQ(stats.allocations, 1u);
+    CHECK_EQ(stats.freeRanges, 2u);
+    CHECK_EQ(allocator.Allocate(10), a);
+    CHECK_EQ(allocator.Allocate(10), 20u);
+}
+
+TEST(RangeAllocator, GrowsIntoTheLastFreeRange)
+{
+    RangeAllocator allocator(20);
+    const uint32_t a = allocator.Allocate(15);
+    CHECK_EQ(allocator.Allocate(10), RangeAllocator::Invalid);
+
+    allocator.Grow(30);
+    CHECK_EQ(allocator.Capacity(), 30u);
+    CHECK_EQ(allocator.Stats().freeRanges, 1u);
+    CHECK_EQ(allocator.Allocate(15), 15u);
+
+    // Growing a full allocator appends a new free range
+    allocator.Grow(40);
+    allocator.Grow(35);
+    CHECK_EQ(allocator.Capacity(), 40u);
+    CHECK_EQ(allocator.Allocate(10), 30u);
+    allocator.Free(a, 15);
+    CHECK_EQ(allocator.Stats().largestFree, 15u);
+}
+
+TEST(RangeAllocator, CompactPacksRangesInOrder)
+{
+    RangeAllocator allocator(64);
+    std::vector<uint32_t> offsets;
+    for (const uint32_t size : {5u, 7u, 3u, 9u, 6u})
+        offsets.push_back(allocator.Allocate(size, 4));
+    allocator.Free(offsets[1], 7);
+    allocator.Free(offsets[3], 9);
+    CHECK(allocator.Stats().freeRanges > 1);
+
+    // The live ranges move to the front in the given order, aligned, and the rest is one free range
+    const std::vector<uint32_t> packed = allocator.Compact({5, 3, 0, 6}, 4);
+    CHECK(packed == (std::vector<uint32_t>{0, 8, RangeAllocator::Invalid, 12}));
+
+    const RangeAllocatorStats stats = allocator.Stats();
+    CHECK_EQ(stats.used, 14u);
+    CHECK_EQ(stats.allocations, 3u);
+    CHECK_EQ(stats.largestFree, 64u - 18u);
+    CHECK_EQ(stats.Free(), 50u);
+    CHECK_EQ(allocator.Capacity(), 64u);
+
+    const std::vector<uint32_t> overfull = allocator.Compact({40, 30}, 1);
+    CHECK(overfull == (std::vector<uint32_t>{0, RangeAllocator::Invalid}));
+}
+
+TEST(RangeAllocator, RandomAllocationsNeverOverlap)
+{
+    constexpr uint32_t Capacity = 4096;
+    RangeAllocator allocator(Capacity);
+    std::vector<uint8_t> owned(Capacity, 0);
+    std::vector<std::pair<uint32_t, uint32_t>> live;
+
+    uint32_t state = 1;
+    auto random = [&state](uint32_t range)
+    {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) % range;
+    };
+
+    for (int step = 0; step < 20000; step++)
+    {
+        if (live.empty() || random(3) != 0)
+        {
+            const uint32_t size = 1 + random(64);
+            const uint32_t alignment = 1u << random(4);
+            const uint32_t offset = allocator.Allocate(size, alignment);
+            if (offset == RangeAllocator::Invalid)
+                continue;
+
+            CHECK_EQ(offset % alignment, 0u);
+            CHECK(offset + size <= Capacity);
+            for (uint32_t i = offset; i < offset + size && i < Capacity; i++)
+            {
+                CHECK(!owned[i]);
+                owned[i] = 1;
+            }
+            live.emplace_back(offset, size);
+        }
+        else
+        {
+            const size_t index = random(static_cast<uint32_t>(live.size()));
+            const auto [offset, size] = live[index];
+            std::fill(owned.begin() + offset, owned.begin() + offset + size, 0);
+            allocator.Free(offset, size);
+            live[index] = live.back();
+            live.pop_back();
+        }
+    }
+
+    const RangeAllocatorStats stats = allocator.Stats();
+    CHECK_EQ(stats.used, static_cast<uint32_t>(std::count(owned.begin(), owned.end(), 1)));
+    CHECK_EQ(stats.allocations, static_cast<uint32_t>(live.size()));
+
+    // Freeing the rest leaves the whole capacity as one range
+    for (const auto &[offset, size] : live)
+        allocator.Free(offset, size);
+    CHECK_EQ(allocator.Stats().freeRanges, 1u);
+    CHECK_EQ(allocator.Stats().largestFree, Capacity);
+}
@@ -0,0 +1,73 @@
+//----------------------------------------------------------------------------------------
+/**
+ * \file       Test.h
+ * \author     Ilia Timofeev
+ * \date       2026/10/16
+ * \brief      Minimal registry and checks of the unit tests.
+ *
+ *  This file declares the TEST macro, which registers a test function of a
+ *  suite, and the CHECK macros, which log a failed condition and let the
+ *  test go on. The tests cover the CPU side modules and run without a
+ *  window or GL context; main.cpp runs the suite named on the command line,
+ *  one CTest entry per suite. Random generates reproducible test data.
+ *
+ */
+//----------------------------------------------------------------------------------------
+
+#pragma once
+
+/**
+ * @struct TestCase
+ * @brief Test function registered by TEST.
+ */
+struct TestCase
+{
+    const char *suite;
+    const char *name;
+    void      (*run)();
+};
+
+/// Every test registered so far, in registration order.
+std::vector<TestCase> &TestCases();
+/// Log a failed check of the running test.
+void TestFailed(const char *file, int line, const std::string &message);
+
+struct TestRegistration
+{
+    TestRegistration(const char *suite, const char *name, void (*run)())
+    {
+        TestCases().push_back({suite, name, run});
+    }
+};
+
+#define TEST(suite, name)                                                                                              \
+    static void suite##_##name();                                                                                      \
+    static const TestRegistration suite##_##name##_registration(#suite, #name, suite##_##name);                        \
+    static void suite##_##name()
+
+#define CHECK(condition)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(condition))                                                                                              \
+            TestFailed(__FILE__, __LINE__, #condition);                                                                \
+    } while (false)
+
+#define CHECK_EQ(a, b)                                                                                                 \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        const auto valueA = (a);                                                                                       \
+        const auto valueB = (b);                                                                                       \
+        if (!(valueA == valueB))                                                                                       \
+            TestFailed(__FILE__, __LINE__, std::format("{} == {}, {} != {}", #a, #b, valueA, valueB));                \
+    } while (false)
+
+/// Uniform in [0, 1), a well mixed hash of the seed so consecutive seeds are independent.
+inline float Random(uint32_t seed)
+{
+    seed ^= seed >> 16;
+    seed *= 0x7feb352du;
+    seed ^= seed >> 15;
+    seed *= 0x846ca68bu;
+    seed ^= seed >> 16;
+    return (seed >> 8) / float(1 << 24);
+}
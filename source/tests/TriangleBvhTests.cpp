@@ -0,0 +1,228 @@
+#include "Test.h"
+#include "src/Resources/Mesh/TriangleBvh.h"
+
+namespace
+{
+using Faces = TriangleBvh::Faces;
+
+/// Uniform in [-1, 1) on every axis.
+glm::vec3 RandomVector(uint32_t seed)
+{
+    return glm::vec3(Random(3 * seed), Random(3 * seed + 1), Random(3 * seed + 2)) * 2.0f - 1.0f;
+}
+
+/// Closed UV sphere of unit radius wound counter-clockwise from outside, plus a soup of small triangles inside and around it.
+struct TestMesh
+{
+    std::vector<float> positions;
+    std::vector<unsigned int> indices;
+
+    [[nodiscard]] glm::vec3 Corner(size_t i) const { return glm::make_vec3(&positions[indices[i] * 3]); }
+};
+
+TestMesh MakeMesh()
+{
+    constexpr uint32_t Rings = 16, Segments = 32, Soup = 300;
+
+    TestMesh mesh;
+    for (uint32_t r = 0; r <= Rings; r++)
+    {
+        const float theta = glm::pi<float>() * r / Rings;
+        for (uint32_t s = 0; s <= Segments; s++)
+        {
+            const float phi = glm::two_pi<float>() * s / Segments;
+            mesh.positions.insert(mesh.positions.end(), {std::sin(theta) * std::cos(phi), std::cos(theta), -std::sin(theta) * std::sin(phi)});
+        }
+    }
+    for (uint32_t r = 0; r < Rings; r++)
+    {
+        for (uint32_t s = 0; s < Segments; s++)
+        {
+            const uint32_t a = r * (Segments + 1) + s, b = a + Segments + 1;
+            if (r > 0)
+                mesh.indices.insert(mesh.indices.end(), {a, b, a + 1});
+            if (r + 1 < Rings)
+                mesh.indices.insert(mesh.indices.end(), {a + 1, b, b + 1});
+        }
+    }
+    for (uint32_t t = 0; t < Soup; t++)
+    {
+        const glm::vec3 center = RandomVector(t) * 2.0f;
+        const auto first = static_cast<unsigned int>(mesh.positions.size() / 3);
+        for (uint32_t corner = 0; corner < 3; corner++)
+        {
+            const glm::vec3 p = center + RandomVector(1000 + 3 * t + corner) * 0.2f;
+            mesh.positions.insert(mesh.positions.end(), {p.x, p.y, p.z});
+        }
+        mesh.indices.insert(mesh.indices.end(), {first, first + 1, first + 2});
+    }
+    return mesh;
+}
+
+/// Nearest hit over every triangle, transformed by model.
+bool BruteForce(const TestMesh &mesh, const glm::mat4 &model, const glm::vec3 &origin, const glm::vec3 &direction, float &distance,
+                Faces faces)
+{
+    bool hit = false;
+    for (size_t i = 0; i < mesh.indices.size(); i += 3)
+    {
+        const glm::vec3 a = glm::vec3(model * glm::vec4(mesh.Corner(i), 1.0f));
+        const glm::vec3 b = glm::vec3(model * glm::vec4(mesh.Corner(i + 1), 1.0f));
+        const glm::vec3 c = glm::vec3(model * glm::vec4(mesh.Corner(i + 2), 1.0f));
+        hit |= TriangleBvh::IntersectTriangle(origin, direction, a, b, c, distance, faces);
+    }
+    return hit;
+}
+
+/// Rays from inside and outside the mesh, some of them ending before they reach it.
+struct Ray
+{
+    glm::vec3 origin, direction;
+    float maxDistance;
+};
+
+std::vector<Ray> MakeRays(uint32_t count)
+{
+    std::vector<Ray> rays;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const glm::vec3 origin = RandomVector(5000 + i) * (i % 2 ? 4.0f : 0.5f);
+        const glm::vec3 target = RandomVector(9000 + i) * 1.5f;
+        rays.push_back({origin, target - origin, i % 5 == 0 ? 0.5f : 10.0f});
+    }
+    return rays;
+}
+} // namespace
+
+TEST(TriangleBvh, IntersectTriangleHonorsFaces)
+{
+    // Counter-clockwise seen from +z
+    const glm::vec3 a(0.0f, 0.0f, 0.0f), b(1.0f, 0.0f, 0.0f), c(0.0f, 1.0f, 0.0f);
+    const glm::vec3 fromFront(0.25f, 0.25f, 2.0f), fromBack(0.25f, 0.25f, -2.0f);
+    const glm::vec3 down(0.0f, 0.0f, -1.0f), up(0.0f, 0.0f, 1.0f);
+
+    for (const Faces faces : {Faces::Front, Faces::Back, Faces::Both})
+    {
+        float distance = 100.0f;
+        CHECK_EQ(TriangleBvh::IntersectTriangle(fromFront, down, a, b, c, distance, faces), faces != Faces::Back);
+        CHECK_EQ(distance, faces != Faces::Back ? 2.0f : 100.0f);
+
+        distance = 100.0f;
+        CHECK_EQ(TriangleBvh::IntersectTriangle(fromBack, up, a, b, c, distance, faces), faces != Faces::Front);
+        CHECK_EQ(distance, faces != Faces::Front ? 2.0f : 100.0f);
+    }
+
+    // Distances are multiples of the direction, hits at or beyond the limit and behind the origin are ignored
+    float distance = 100.0f;
+    CHECK(TriangleBvh::IntersectTriangle(fromFront, down * 4.0f, a, b, c, distance, Faces::Front));
+    CHECK_EQ(distance, 0.5f);
+    distance = 2.0f;
+    CHECK(!TriangleBvh::IntersectTriangle(fromFront, down, a, b, c, distance, Faces::Front));
+    distance = 100.0f;
+    CHECK(!TriangleBvh::IntersectTriangle(fromFront, up, a, b, c, distance, Faces::Both));
+    CHECK(!TriangleBvh::IntersectTriangle(fromFront, glm::vec3(1.0f, 0.0f, 0.0f), a, b, c, distance, Faces::Both));
+    CHECK(!TriangleBvh::IntersectTriangle(glm::vec3(0.75f, 0.75f, 2.0f), down, a, b, c, distance, Faces::Both));
+}
+
+TEST(TriangleBvh, RaycastMatchesBruteForce)
+{
+    const TestMesh mesh = MakeMesh();
+    TriangleBvh bvh;
+    bvh.Build(mesh.positions.data(), static_cast<uint32_t>(mesh.positions.size() / 3), 3, mesh.indices.data(),
+              static_cast<uint32_t>(mesh.indices.size()));
+    CHECK_EQ(bvh.TriangleCount(), static_cast<uint32_t>(mesh.indices.size() / 3));
+    CHECK(bvh.NodeCount() < 2 * bvh.TriangleCount());
+
+    uint32_t hits[3] = {};
+    for (const Ray &ray : MakeRays(500))
+    {
+        for (const Faces faces : {Faces::Front, Faces::Back, Faces::Both})
+        {
+            float expected = ray.maxDistance, found = ray.maxDistance;
+            const bool expectedHit = BruteForce(mesh, glm::mat4(1.0f), ray.origin, ray.direction, expected, faces);
+            CHECK_EQ(bvh.Raycast(ray.origin, ray.direction, found, faces), expectedHit);
+            CHECK_EQ(found, expected);
+            hits[static_cast<int>(faces)] += expectedHit;
+        }
+    }
+
+    // The rays from inside see back faces, the ones from outside front faces, and some miss
+    CHECK(hits[0] > 50 && hits[1] > 50);
+    CHECK(hits[2] >= std::max(hits[0], hits[1]) && hits[2] < 500);
+}
+
+TEST(TriangleBvh, BuildsFromViewsAndStrides)
+{
+    const TestMesh mesh = MakeMesh();
+    const auto vertexCount = static_cast<uint32_t>(mesh.positions.size() / 3);
+
+    // The same triangles as indexed views, and unrolled into padded non-indexed positions
+    MeshViews views;
+    views.positions = {reinterpret_cast<const uint8_t *>(mesh.positions.data()), vertexCount, 3 * sizeof(float), 3};
+    views.indices = {reinterpret_cast<const uint8_t *>(mesh.indices.data()), static_cast<uint32_t>(mesh.indices.size()), sizeof(unsigned int)};
+    std::vector<float> unrolled;
+    for (size_t i = 0; i < mesh.indices.size(); i++)
+    {
+        const glm::vec3 p = mesh.Corner(i);
+        unrolled.insert(unrolled.end(), {p.x, p.y, p.z, 0.0f, 0.0f});
+    }
+
+    TriangleBvh fromViews, fromStride;
+    fromViews.Build(views);
+    fromStride.Build(unrolled.data(), static_cast<uint32_t>(mesh.indices.size()), 5);
+    CHECK_EQ(fromViews.TriangleCount(), static_cast<uint32_t>(mesh.indices.size() / 3));
+    CHECK_EQ(fromStride.TriangleCount(), fromViews.TriangleCount());
+
+    for (const Ray &ray : MakeRays(200))
+    {
+        float expected = ray.maxDistance, a = ray.maxDistance, b = ray.maxDistance;
+        const bool expectedHit = BruteForce(mesh, glm::mat4(1.0f), ray.origin, ray.direction, expected, Faces::Both);
+        CHECK_EQ(fromViews.Raycast(ray.origin, ray.direction, a, Faces::Both), expectedHit);
+        CHECK_EQ(fromStride.Raycast(ray.origin, ray.direction, b, Faces::Both), expectedHit);
+        CHECK_EQ(a, expected);
+        CHECK_EQ(b, expected);
+    }
+
+    fromViews.Clear();
+    float distance = 10.0f;
+    CHECK(fromViews.Empty());
+    CHECK(!fromViews.Raycast(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f, 0.0f, -1.0f), distance, Faces::Both));
+}
+
+TEST(TriangleBvh, ObjectSpaceRaysHitTheWorldSpaceFrontFaces)
+{
+    const TestMesh mesh = MakeMesh();
+    TriangleBvh bvh;
+    bvh.Build(mesh.positions.data(), static_cast<uint32_t>(mesh.positions.size() / 3), 3, mesh.indices.data(),
+              static_cast<uint32_t>(mesh.indices.size()));
+
+    // Rotated, translated and non-uniformly scaled, once without and once with a mirrored axis
+    const glm::mat4 rotation = glm::rotate(0.7f, glm::normalize(glm::vec3(1.0f, 2.0f, -0.5f)));
+    const glm::mat4 models[] = {
+        glm::translate(glm::vec3(3.0f, -1.0f, 2.0f)) * rotation * glm::scale(glm::vec3(2.0f, 0.5f, 1.5f)),
+        glm::translate(glm::vec3(-2.0f, 0.5f, 1.0f)) * rotation * glm::scale(glm::vec3(1.5f, -2.0f, 0.75f)),
+    };
+
+    for (int m = 0; m < 2; m++)
+    {
+        const glm::mat4 &model = models[m];
+        uint32_t hits = 0;
+        for (const Ray &ray : MakeRays(300))
+        {
+            // The ray around the transformed mesh
+            const glm::vec3 origin = glm::vec3(model * glm::vec4(ray.origin, 1.0f));
+            const glm::vec3 direction = glm::mat3(model) * ray.direction;
+
+            float expected = ray.maxDistance, found = ray.maxDistance;
+            const bool expectedHit = BruteForce(mesh, model, origin, direction, expected, Faces::Front);
+
+            glm::vec3 localOrigin = origin, localDirection = direction;
+            const Faces faces = TriangleBvh::ToObjectSpace(model, localOrigin, localDirection);
+            CHECK(faces == (m == 1 ? Faces::Back : Faces::Front));
+            CHECK_EQ(bvh.Raycast(localOrigin, localDirection, found, faces), expectedHit);
+            CHECK(std::abs(found - expected) <= 1e-4f * std::max(1.0f, expected));
+            hits += expectedHit;
+        }
+        CHECK(hits > 30);
+    }
+}
@@ -0,0 +1,47 @@
+#include "Test.h"
+
+static int failures = 0;
+
+std::vector<TestCase> &TestCases()
+{
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+void TestFailed(const char *file, int line, const std::string &message)
+{
+    failures++;
+    LOG_ERROR("{}:{}: {}", std::filesystem::path(file).filename().string(), line, message);
+}
+
+/// Run the tests of the suite given as first argument, all of them without one.
+int main(int argc, char *argv[])
+{
+    const std::string suite = argc > 1 ? argv[1] : "";
+
+    int ran = 0, failed = 0;
+    for (const TestCase &test : TestCases())
+    {
+        if (!suite.empty() && suite != test.suite)
+            continue;
+
+        const int before = failures;
+        test.run();
+        ran++;
+        if (failures != before)
+        {
+            failed++;
+            LOG_ERROR("{}.{} failed.", test.suite, test.name);
+        }
+        else
+            LOG("{}.{} passed.", test.suite, test.name);
+    }
+
+    if (ran == 0)
+    {
+        LOG_ERROR("No tests in suite '{}'.", suite);
+        return 1;
+    }
+    LOG("{} of {} tests passed.", ran - failed, ran);
+    return failed ? 1 : 0;
+}